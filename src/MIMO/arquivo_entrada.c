@@ -0,0 +1,94 @@
+/// @file arquivo_entrada.c
+/// @brief Implementação da leitura do arquivo de entrada por mmap.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "arquivo_entrada.h"
+
+/// Lê o arquivo inteiro para um buffer, quando o mapeamento não é possível.
+
+static int le_para_buffer(arquivo_entrada *arquivo, int fd) {
+    size_t capacidade = 1 << 16, tamanho = 0;
+    uint8_t *buffer = malloc(capacidade);
+    ssize_t lidos;
+
+    while ((lidos = read(fd, buffer + tamanho, capacidade - tamanho)) > 0) {
+        tamanho += lidos;
+        if (tamanho == capacidade) {
+            capacidade *= 2;
+            buffer = realloc(buffer, capacidade);
+        }
+    }
+    if (lidos < 0) {
+        free(buffer);
+        return -1;
+    }
+    arquivo->dados = buffer;
+    arquivo->tamanho = tamanho;
+    arquivo->mapeado = 0;
+    return 0;
+}
+
+int arquivo_entrada_abre(arquivo_entrada *arquivo, const char *nome) {
+    struct stat info;
+    int fd = open(nome, O_RDONLY);
+
+    arquivo->dados = NULL;
+    arquivo->tamanho = 0;
+    arquivo->descartado = 0;
+    arquivo->mapeado = 0;
+    if (fd < 0) {
+        return -1;
+    }
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        int r = le_para_buffer(arquivo, fd);
+        close(fd);
+        return r;
+    }
+    if (info.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+
+    void *p = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) {
+        int r = le_para_buffer(arquivo, fd);
+        close(fd);
+        return r;
+    }
+    close(fd);
+
+    madvise(p, info.st_size, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+    madvise(p, info.st_size, MADV_HUGEPAGE);
+#endif
+    arquivo->dados = p;
+    arquivo->tamanho = info.st_size;
+    arquivo->mapeado = 1;
+    return 0;
+}
+
+void arquivo_entrada_descarta(arquivo_entrada *arquivo, size_t ate) {
+    size_t pagina = sysconf(_SC_PAGESIZE);
+    size_t fim = ate / pagina * pagina;
+
+    if (!arquivo->mapeado || fim <= arquivo->descartado) {
+        return;
+    }
+    madvise((uint8_t*) arquivo->dados + arquivo->descartado, fim - arquivo->descartado, MADV_DONTNEED);
+    arquivo->descartado = fim;
+}
+
+void arquivo_entrada_fecha(arquivo_entrada *arquivo) {
+    if (arquivo->mapeado) {
+        munmap((void*) arquivo->dados, arquivo->tamanho);
+    } else {
+        free((void*) arquivo->dados);
+    }
+    arquivo->dados = NULL;
+    arquivo->tamanho = 0;
+}
@@ -0,0 +1,48 @@
+/// @file arquivo_entrada.h
+/// @brief Leitura do arquivo de entrada por mapeamento em memória (mmap), sem cópias.
+
+/// O arquivo é mapeado somente para leitura e os estágios seguintes leem os bytes
+/// diretamente do mapeamento. O kernel é avisado de que o acesso é sequencial
+/// (MADV_SEQUENTIAL, leitura antecipada mais agressiva) e, quando disponível, de que
+/// páginas grandes podem ser usadas (MADV_HUGEPAGE). Se o mapeamento não for possível
+/// (por exemplo, um pipe) o arquivo é lido inteiro para um buffer, e a interface é a mesma.
+
+#ifndef ARQUIVO_ENTRADA_H
+#define ARQUIVO_ENTRADA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// @brief Arquivo de entrada aberto por arquivo_entrada_abre.
+
+typedef struct {
+    const uint8_t *dados; /**< Conteúdo do arquivo (NULL se vazio). */
+    size_t tamanho;       /**< Tamanho do arquivo, em bytes. */
+    size_t descartado;    /**< Bytes iniciais já devolvidos ao kernel por arquivo_entrada_descarta. */
+    int mapeado;          /**< 1 se dados é um mapeamento, 0 se é um buffer alocado. */
+} arquivo_entrada;
+
+/// @brief Abre e mapeia o arquivo.
+
+/// @param arquivo A estrutura a preencher.
+/// @param nome O nome do arquivo.
+/// @return 0 em caso de sucesso, -1 se o arquivo não puder ser aberto ou lido.
+
+int arquivo_entrada_abre(arquivo_entrada *arquivo, const char *nome);
+
+/// @brief Avisa que os bytes anteriores a `ate` não serão mais lidos.
+
+/// As páginas completas já consumidas deixam de contar na memória residente do processo,
+/// de modo que uma leitura sequencial de um arquivo grande mantém o pico de memória
+/// limitado. Não faz nada quando os dados estão em um buffer.
+
+/// @param arquivo O arquivo.
+/// @param ate Posição, em bytes, até onde a entrada já foi consumida.
+
+void arquivo_entrada_descarta(arquivo_entrada *arquivo, size_t ate);
+
+/// @brief Desfaz o mapeamento (ou libera o buffer).
+
+void arquivo_entrada_fecha(arquivo_entrada *arquivo);
+
+#endif // ARQUIVO_ENTRADA_H
@@ -0,0 +1,117 @@
+/// @file arquivo_saida.c
+/// @brief Implementação da escrita bufferizada do arquivo de saída.
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "arquivo_saida.h"
+
+/// Escreve n bytes, repetindo a chamada em escritas parciais ou interrompidas.
+
+static void escreve_tudo(arquivo_saida *arquivo, const uint8_t *dados, size_t n) {
+    while (n > 0) {
+        ssize_t escritos = write(arquivo->fd, dados, n);
+        if (escritos < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            arquivo->erro = 1;
+            return;
+        }
+        dados += escritos;
+        n -= escritos;
+    }
+}
+
+/// Descarrega o buffer. Com O_DIRECT só a parte alinhada é escrita e a sobra volta ao início.
+
+static void descarrega(arquivo_saida *arquivo) {
+    size_t n = arquivo->usado;
+
+    if (arquivo->direto) {
+        n = n / ARQUIVO_SAIDA_ALINHAMENTO * ARQUIVO_SAIDA_ALINHAMENTO;
+    }
+    escreve_tudo(arquivo, arquivo->buffer, n);
+    memmove(arquivo->buffer, arquivo->buffer + n, arquivo->usado - n);
+    arquivo->usado -= n;
+}
+
+int arquivo_saida_abre(arquivo_saida *arquivo, const char *nome, size_t capacidade, int direto) {
+    int flags = O_WRONLY | O_CREAT | O_TRUNC;
+
+    arquivo->buffer = NULL;
+    arquivo->capacidade = (capacidade + ARQUIVO_SAIDA_ALINHAMENTO - 1) / ARQUIVO_SAIDA_ALINHAMENTO * ARQUIVO_SAIDA_ALINHAMENTO;
+    arquivo->usado = 0;
+    arquivo->erro = 0;
+    arquivo->direto = 0;
+    arquivo->fd = -1;
+#ifdef O_DIRECT
+    if (direto && arquivo->capacidade > 0) {
+        arquivo->fd = open(nome, flags | O_DIRECT, 0644);
+        arquivo->direto = arquivo->fd >= 0;
+    }
+#endif
+    if (arquivo->fd < 0) {
+        arquivo->fd = open(nome, flags, 0644);
+    }
+    if (arquivo->fd < 0) {
+        return -1;
+    }
+    if (arquivo->capacidade > 0) {
+        arquivo->buffer = aligned_alloc(ARQUIVO_SAIDA_ALINHAMENTO, arquivo->capacidade);
+    }
+    return 0;
+}
+
+uint8_t *arquivo_saida_reserva(arquivo_saida *arquivo, size_t n) {
+    if (arquivo->usado + n > arquivo->capacidade) {
+        descarrega(arquivo);
+    }
+    return arquivo->buffer + arquivo->usado;
+}
+
+void arquivo_saida_confirma(arquivo_saida *arquivo, size_t n) {
+    arquivo->usado += n;
+}
+
+void arquivo_saida_escreve(arquivo_saida *arquivo, const uint8_t *dados, size_t n) {
+    if (!arquivo->direto && n >= arquivo->capacidade) {
+        descarrega(arquivo);
+        escreve_tudo(arquivo, dados, n);
+        return;
+    }
+    while (n > 0) {
+        size_t parte = arquivo->capacidade - arquivo->usado;
+        if (parte == 0) {
+            descarrega(arquivo);
+            continue;
+        }
+        if (parte > n) {
+            parte = n;
+        }
+        memcpy(arquivo->buffer + arquivo->usado, dados, parte);
+        arquivo->usado += parte;
+        dados += parte;
+        n -= parte;
+    }
+}
+
+int arquivo_saida_fecha(arquivo_saida *arquivo) {
+    descarrega(arquivo);
+#ifdef O_DIRECT
+    if (arquivo->direto && arquivo->usado > 0) {
+        fcntl(arquivo->fd, F_SETFL, fcntl(arquivo->fd, F_GETFL) & ~O_DIRECT);
+        arquivo->direto = 0;
+        descarrega(arquivo);
+    }
+#endif
+    if (close(arquivo->fd) != 0) {
+        arquivo->erro = 1;
+    }
+    free(arquivo->buffer);
+    arquivo->buffer = NULL;
+    return arquivo->erro ? -1 : 0;
+}
@@ -0,0 +1,74 @@
+/// @file arquivo_saida.h
+/// @brief Escrita do arquivo de saída com buffer grande e alinhado, descarregado em blocos.
+
+/// Os bytes são montados diretamente no buffer (arquivo_saida_reserva devolve a área onde
+/// o demapeador empacota os índices) e o buffer só vai para o kernel quando enche, em uma
+/// única chamada write. Opcionalmente o arquivo é aberto com O_DIRECT, que evita a cópia
+/// para o cache de páginas; nesse caso as escritas têm tamanho múltiplo do alinhamento e
+/// a sobra final é escrita sem O_DIRECT no fechamento. Se o sistema de arquivos não
+/// aceitar O_DIRECT o arquivo é aberto normalmente.
+
+#ifndef ARQUIVO_SAIDA_H
+#define ARQUIVO_SAIDA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// @brief Tamanho padrão do buffer de saída, em bytes.
+
+#define ARQUIVO_SAIDA_BUFFER_PADRAO (4 << 20)
+
+/// @brief Alinhamento do buffer e das escritas com O_DIRECT.
+
+#define ARQUIVO_SAIDA_ALINHAMENTO 4096
+
+/// @brief Arquivo de saída aberto por arquivo_saida_abre.
+
+typedef struct {
+    int fd;             /**< Descritor do arquivo. */
+    uint8_t *buffer;    /**< Buffer alinhado (NULL se a capacidade for 0). */
+    size_t capacidade;  /**< Tamanho do buffer, múltiplo de ARQUIVO_SAIDA_ALINHAMENTO. */
+    size_t usado;       /**< Bytes no buffer ainda não escritos. */
+    int direto;         /**< 1 se o arquivo está aberto com O_DIRECT. */
+    int erro;           /**< Diferente de zero se alguma escrita falhou. */
+} arquivo_saida;
+
+/// @brief Cria (ou trunca) o arquivo.
+
+/// @param arquivo A estrutura a preencher.
+/// @param nome O nome do arquivo.
+/// @param capacidade O tamanho do buffer (arredondado para cima ao alinhamento); com 0 cada
+///        escrita vai direto para o arquivo.
+/// @param direto Se diferente de zero, tenta abrir com O_DIRECT.
+/// @return 0 em caso de sucesso, -1 se o arquivo não puder ser criado.
+
+int arquivo_saida_abre(arquivo_saida *arquivo, const char *nome, size_t capacidade, int direto);
+
+/// @brief Reserva n bytes no fim do buffer para serem preenchidos pelo chamador.
+
+/// Descarrega o buffer antes, se necessário. A área só é considerada escrita depois de
+/// arquivo_saida_confirma.
+
+/// @param arquivo O arquivo.
+/// @param n O número de bytes (no máximo capacidade - ARQUIVO_SAIDA_ALINHAMENTO).
+/// @return Ponteiro para a área reservada.
+
+uint8_t *arquivo_saida_reserva(arquivo_saida *arquivo, size_t n);
+
+/// @brief Confirma n bytes preenchidos na última área reservada.
+
+void arquivo_saida_confirma(arquivo_saida *arquivo, size_t n);
+
+/// @brief Acrescenta n bytes ao arquivo.
+
+/// Blocos maiores que o buffer são escritos sem passar por ele (exceto com O_DIRECT).
+
+void arquivo_saida_escreve(arquivo_saida *arquivo, const uint8_t *dados, size_t n);
+
+/// @brief Escreve o que resta no buffer, fecha o arquivo e libera o buffer.
+
+/// @return 0 se todas as escritas deram certo, -1 caso contrário.
+
+int arquivo_saida_fecha(arquivo_saida *arquivo);
+
+#endif // ARQUIVO_SAIDA_H
@@ -0,0 +1,167 @@
+/// @file cache_svd.c
+/// @brief Cache de decomposições SVD: tabela de dispersão encadeada e lista LRU sobre índices.
+
+#include <stdlib.h>
+#include <string.h>
+#include "cache_svd.h"
+
+/// Doubles de uma entrada: V, U^H, s, 1/s e a área extra.
+
+static size_t tamanho_entrada(int Nr, int Nt, size_t extra) {
+    size_t k = Nr < Nt ? Nr : Nt;
+    return 2 * (size_t) Nt * k + 2 * k * Nr + 2 * k + extra;
+}
+
+/// Balde de um identificador (dispersão multiplicativa de Fibonacci).
+
+static int balde(const cache_svd *c, uint64_t id) {
+    return (int) ((id * 0x9e3779b97f4a7c15u) >> 32) & c->mascara;
+}
+
+/// Retira a entrada i da lista LRU.
+
+static void desliga(cache_svd *c, int i) {
+    if (c->anterior[i] >= 0) {
+        c->posterior[c->anterior[i]] = c->posterior[i];
+    } else {
+        c->mais_recente = c->posterior[i];
+    }
+    if (c->posterior[i] >= 0) {
+        c->anterior[c->posterior[i]] = c->anterior[i];
+    } else {
+        c->menos_recente = c->anterior[i];
+    }
+}
+
+/// Coloca a entrada i na cabeça da lista LRU.
+
+static void liga(cache_svd *c, int i) {
+    c->anterior[i] = -1;
+    c->posterior[i] = c->mais_recente;
+    if (c->mais_recente >= 0) {
+        c->anterior[c->mais_recente] = i;
+    } else {
+        c->menos_recente = i;
+    }
+    c->mais_recente = i;
+}
+
+/// Retira a entrada i da tabela de dispersão.
+
+static void remove_balde(cache_svd *c, int i) {
+    int *elo = &c->baldes[balde(c, c->entradas[i].id)];
+    while (*elo != i) {
+        elo = &c->proxima[*elo];
+    }
+    *elo = c->proxima[i];
+}
+
+cache_svd cache_svd_cria(int Nr, int Nt, size_t extra, size_t limite_bytes) {
+    cache_svd c;
+    size_t por_entrada = sizeof(double) * tamanho_entrada(Nr, Nt, extra) + sizeof(cache_svd_entrada) + 3 * sizeof(int);
+    size_t capacidade = limite_bytes / por_entrada;
+    int baldes = 1;
+
+    if (capacidade < 1) {
+        capacidade = 1;
+    }
+    if (capacidade > 1 << 24) {
+        capacidade = 1 << 24;
+    }
+    while (baldes < 2 * (int) capacidade) {
+        baldes *= 2;
+    }
+
+    c.Nr = Nr;
+    c.Nt = Nt;
+    c.capacidade = (int) capacidade;
+    c.usadas = 0;
+    c.extra = extra;
+    c.entradas = malloc(sizeof(cache_svd_entrada) * capacidade);
+    c.anterior = malloc(sizeof(int) * capacidade);
+    c.posterior = malloc(sizeof(int) * capacidade);
+    c.proxima = malloc(sizeof(int) * capacidade);
+    c.baldes = malloc(sizeof(int) * baldes);
+    c.mascara = baldes - 1;
+    c.mais_recente = c.menos_recente = -1;
+    c.svd = svd_contexto_aloca(Nr, Nt);
+    c.acertos = c.faltas = c.descartes = 0;
+    for (int b = 0; b < baldes; b++) {
+        c.baldes[b] = -1;
+    }
+    return c;
+}
+
+void cache_svd_libera(cache_svd *c) {
+    for (int i = 0; i < c->usadas; i++) {
+        free(c->entradas[i].v);
+    }
+    free(c->entradas);
+    free(c->anterior);
+    free(c->posterior);
+    free(c->proxima);
+    free(c->baldes);
+    svd_contexto_libera(&c->svd);
+    c->entradas = NULL;
+    c->anterior = c->posterior = c->proxima = c->baldes = NULL;
+    c->usadas = c->capacidade = 0;
+}
+
+cache_svd_entrada *cache_svd_procura(cache_svd *c, uint64_t id) {
+    for (int i = c->baldes[balde(c, id)]; i >= 0; i = c->proxima[i]) {
+        if (c->entradas[i].id == id) {
+            if (c->mais_recente != i) {
+                desliga(c, i);
+                liga(c, i);
+            }
+            c->acertos++;
+            return &c->entradas[i];
+        }
+    }
+    return NULL;
+}
+
+cache_svd_entrada *cache_svd_calcula(cache_svd *c, uint64_t id, const double *H, int ldh) {
+    cache_svd_entrada *e = cache_svd_procura(c, id);
+    int Nr = c->Nr, Nt = c->Nt, k = c->svd.k, i;
+
+    if (e != NULL) {
+        return e;
+    }
+
+    if (c->usadas < c->capacidade) {
+        i = c->usadas++;
+        e = &c->entradas[i];
+        e->v = malloc(sizeof(double) * tamanho_entrada(Nr, Nt, c->extra));
+        e->uh = e->v + 2 * Nt * k;
+        e->s = e->uh + 2 * k * Nr;
+        e->inv_s = e->s + k;
+        e->extra = e->inv_s + k;
+    } else {
+        i = c->menos_recente;
+        e = &c->entradas[i];
+        desliga(c, i);
+        remove_balde(c, i);
+        c->descartes++;
+    }
+
+    svd_contexto_calcula(&c->svd, H, ldh);
+    memcpy(e->v, c->svd.v, sizeof(double) * 2 * Nt * k);
+    for (int r = 0; r < Nr; r++) {
+        for (int j = 0; j < k; j++) {
+            e->uh[2 * (j * Nr + r)] = c->svd.u[2 * (r * k + j)];
+            e->uh[2 * (j * Nr + r) + 1] = -c->svd.u[2 * (r * k + j) + 1];
+        }
+    }
+    for (int j = 0; j < k; j++) {
+        e->s[j] = c->svd.s[j];
+        e->inv_s[j] = c->svd.s[j] > 0 ? 1 / c->svd.s[j] : 0;
+    }
+
+    e->id = id;
+    c->proxima[i] = c->baldes[balde(c, id)];
+    c->baldes[balde(c, id)] = i;
+    liga(c, i);
+    c->faltas++;
+    return e;
+}
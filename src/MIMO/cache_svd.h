@@ -0,0 +1,89 @@
+/// @file cache_svd.h
+/// @brief Cache de decomposições SVD por realização de canal, com descarte LRU e limite de memória.
+
+/// Em simulações com desvanecimento em blocos, vários quadros usam o mesmo canal H; a
+/// SVD e as matrizes derivadas dela (V, U^H e 1/S) são calculadas uma vez por bloco de
+/// coerência e depois apenas consultadas pelo identificador da realização. As matrizes
+/// ficam no formato contíguo de svd_complexa.h. Cada entrada pode guardar também uma área
+/// extra do chamador (por exemplo, o próprio H).
+
+/// Quando o número de entradas chega ao limite de memória, a usada há mais tempo é
+/// descartada e a sua área é reaproveitada; depois de cheio o cache não faz mais
+/// alocações. O cache não é sincronizado: em simulações com várias threads, cada thread
+/// deve ter o seu, como o svd_contexto que ele contém.
+
+#ifndef CACHE_SVD_H
+#define CACHE_SVD_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../matrizes/svd_complexa.h"
+
+/// @brief Uma decomposição guardada no cache, com k = min(Nr, Nt).
+
+typedef struct {
+    uint64_t id;   /**< Identificador da realização de canal. */
+    double *v;     /**< V (Nt x k), pronta para o pré-codificador. */
+    double *uh;    /**< U^H (k x Nr), pronta para o combinador. */
+    double *s;     /**< Valores singulares (k posições, em ordem decrescente). */
+    double *inv_s; /**< 1 / s (0 para valores singulares nulos), para o equalizador. */
+    double *extra; /**< Área do chamador, com o tamanho dado em cache_svd_cria. */
+} cache_svd_entrada;
+
+/// @brief Cache criado por cache_svd_cria.
+
+typedef struct {
+    int Nr;                       /**< Número de linhas de H. */
+    int Nt;                       /**< Número de colunas de H. */
+    int capacidade;               /**< Número máximo de entradas. */
+    int usadas;                   /**< Número de entradas já alocadas. */
+    size_t extra;                 /**< Doubles da área extra de cada entrada. */
+    cache_svd_entrada *entradas;  /**< As entradas (capacidade posições). */
+    int *anterior;                /**< Entrada usada logo depois (mais recente), ou -1. */
+    int *posterior;               /**< Entrada usada logo antes (menos recente), ou -1. */
+    int *proxima;                 /**< Próxima entrada do mesmo balde da tabela de dispersão, ou -1. */
+    int *baldes;                  /**< Primeira entrada de cada balde, ou -1. */
+    int mascara;                  /**< Número de baldes menos 1 (potência de 2). */
+    int mais_recente;             /**< Cabeça da lista LRU, ou -1. */
+    int menos_recente;            /**< Cauda da lista LRU, ou -1. */
+    svd_contexto svd;             /**< Contexto das decomposições. */
+    int64_t acertos;              /**< Consultas atendidas pelo cache. */
+    int64_t faltas;               /**< Decomposições calculadas. */
+    int64_t descartes;            /**< Entradas descartadas por falta de espaço. */
+} cache_svd;
+
+/// @brief Cria um cache para canais Nr x Nt.
+
+/// @param Nr Número de receptores (linhas de H).
+/// @param Nt Número de transmissores (colunas de H).
+/// @param extra Doubles da área do chamador em cada entrada (pode ser 0).
+/// @param limite_bytes Memória máxima das entradas; cabe sempre pelo menos uma.
+/// @return O cache.
+
+cache_svd cache_svd_cria(int Nr, int Nt, size_t extra, size_t limite_bytes);
+
+/// @brief Libera a memória do cache.
+
+void cache_svd_libera(cache_svd *c);
+
+/// @brief Procura a decomposição da realização id, tornando-a a mais recente.
+
+/// @return A entrada, ou NULL se não estiver no cache.
+
+cache_svd_entrada *cache_svd_procura(cache_svd *c, uint64_t id);
+
+/// @brief Decompõe H e guarda o resultado como a realização id.
+
+/// Se o cache estiver cheio, a entrada usada há mais tempo é descartada. A área extra da
+/// entrada devolvida fica para o chamador preencher. Se id já estiver no cache, a
+/// entrada existente é devolvida sem nova decomposição.
+
+/// @param c O cache.
+/// @param id O identificador da realização.
+/// @param H O canal (Nr x Nt).
+/// @param ldh Dimensão principal de H.
+/// @return A entrada.
+
+cache_svd_entrada *cache_svd_calcula(cache_svd *c, uint64_t id, const double *H, int ldh);
+
+#endif // CACHE_SVD_H
@@ -0,0 +1,362 @@
+/// @file indices_qam.c
+/// @brief Empacotamento dos índices QAM (log2(M) bits por símbolo) e versões SIMD para QPSK.
+
+/// O caminho genérico trata qualquer número de bits de 1 a 8, expandindo 8 índices (que
+/// ocupam `bits` bytes) por vez e usando uma janela de 16 bits para as sobras.
+/// Com 2 bits por símbolo há versões SSE2 e AVX2: na expansão os quatro campos de cada
+/// byte são isolados por deslocamentos e intercalados com unpack de bytes e de palavras;
+/// na compactação (AVX2) pmaddubsw/pmaddwd juntam quatro índices em um byte e pshufb
+/// recolhe os bytes.
+
+#include <stddef.h>
+#include <string.h>
+#include "indices_qam.h"
+#include "../matrizes/simd_complexo.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define INDICES_X86 1
+#include <immintrin.h>
+#else
+#define INDICES_X86 0
+#endif
+
+int indices_bits(int M) {
+    int bits = 0;
+    if (M < 2 || (M & (M - 1)) != 0) {
+        return -1;
+    }
+    while ((1 << bits) < M) {
+        bits++;
+    }
+    return bits;
+}
+
+long indices_bytes(long n, int bits) {
+    return (n * bits + 7) / 8;
+}
+
+int indices_obtem(const uint8_t *empacotado, int bits, long i) {
+    long p = i * bits;
+    int desloc = p & 7;
+    unsigned mascara = (1u << bits) - 1;
+
+    if (desloc + bits <= 8) {
+        return (empacotado[p >> 3] >> (8 - desloc - bits)) & mascara;
+    }
+    unsigned janela = (unsigned) empacotado[p >> 3] << 8 | empacotado[(p >> 3) + 1];
+    return (janela >> (16 - desloc - bits)) & mascara;
+}
+
+/* ---------------------------------------------------------------------------------- */
+/* Expansão                                                                            */
+/* ---------------------------------------------------------------------------------- */
+
+/// Expande bytes inteiros de índices de 2 bits (4 símbolos por byte).
+
+static void desempacota2_escalar(const uint8_t *e, long num_bytes, uint8_t *r) {
+    for (long i = 0; i < num_bytes; i++) {
+        r[4 * i] = e[i] >> 6;
+        r[4 * i + 1] = (e[i] >> 4) & 3;
+        r[4 * i + 2] = (e[i] >> 2) & 3;
+        r[4 * i + 3] = e[i] & 3;
+    }
+}
+
+#if INDICES_X86
+
+__attribute__((target("sse2")))
+static void desempacota2_sse2(const uint8_t *e, long num_bytes, uint8_t *r) {
+    const __m128i tres = _mm_set1_epi8(3);
+    long i = 0;
+
+    for (; i + 16 <= num_bytes; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*) (e + i));
+        __m128i t0 = _mm_and_si128(_mm_srli_epi16(x, 6), tres);
+        __m128i t1 = _mm_and_si128(_mm_srli_epi16(x, 4), tres);
+        __m128i t2 = _mm_and_si128(_mm_srli_epi16(x, 2), tres);
+        __m128i t3 = _mm_and_si128(x, tres);
+        __m128i a_lo = _mm_unpacklo_epi8(t0, t1), a_hi = _mm_unpackhi_epi8(t0, t1);
+        __m128i b_lo = _mm_unpacklo_epi8(t2, t3), b_hi = _mm_unpackhi_epi8(t2, t3);
+
+        _mm_storeu_si128((__m128i*) (r + 4 * i), _mm_unpacklo_epi16(a_lo, b_lo));
+        _mm_storeu_si128((__m128i*) (r + 4 * i + 16), _mm_unpackhi_epi16(a_lo, b_lo));
+        _mm_storeu_si128((__m128i*) (r + 4 * i + 32), _mm_unpacklo_epi16(a_hi, b_hi));
+        _mm_storeu_si128((__m128i*) (r + 4 * i + 48), _mm_unpackhi_epi16(a_hi, b_hi));
+    }
+    desempacota2_escalar(e + i, num_bytes - i, r + 4 * i);
+}
+
+/// Igual à versão SSE2, mas os unpack do AVX2 agem em cada metade de 128 bits: os quatro
+/// resultados saem como [0-3|16-19], [4-7|20-23], ... e são reordenados com vperm2i128.
+
+__attribute__((target("avx2")))
+static void desempacota2_avx2(const uint8_t *e, long num_bytes, uint8_t *r) {
+    const __m256i tres = _mm256_set1_epi8(3);
+    long i = 0;
+
+    for (; i + 32 <= num_bytes; i += 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i*) (e + i));
+        __m256i t0 = _mm256_and_si256(_mm256_srli_epi16(x, 6), tres);
+        __m256i t1 = _mm256_and_si256(_mm256_srli_epi16(x, 4), tres);
+        __m256i t2 = _mm256_and_si256(_mm256_srli_epi16(x, 2), tres);
+        __m256i t3 = _mm256_and_si256(x, tres);
+        __m256i a_lo = _mm256_unpacklo_epi8(t0, t1), a_hi = _mm256_unpackhi_epi8(t0, t1);
+        __m256i b_lo = _mm256_unpacklo_epi8(t2, t3), b_hi = _mm256_unpackhi_epi8(t2, t3);
+        __m256i r0 = _mm256_unpacklo_epi16(a_lo, b_lo), r1 = _mm256_unpackhi_epi16(a_lo, b_lo);
+        __m256i r2 = _mm256_unpacklo_epi16(a_hi, b_hi), r3 = _mm256_unpackhi_epi16(a_hi, b_hi);
+
+        _mm256_storeu_si256((__m256i*) (r + 4 * i), _mm256_permute2x128_si256(r0, r1, 0x20));
+        _mm256_storeu_si256((__m256i*) (r + 4 * i + 32), _mm256_permute2x128_si256(r2, r3, 0x20));
+        _mm256_storeu_si256((__m256i*) (r + 4 * i + 64), _mm256_permute2x128_si256(r0, r1, 0x31));
+        _mm256_storeu_si256((__m256i*) (r + 4 * i + 96), _mm256_permute2x128_si256(r2, r3, 0x31));
+    }
+    desempacota2_sse2(e + i, num_bytes - i, r + 4 * i);
+}
+
+#endif
+
+/// Expande bytes inteiros de índices de 2 bits com o maior nível SIMD disponível.
+
+static void desempacota2(const uint8_t *e, long num_bytes, uint8_t *r) {
+#if INDICES_X86
+    switch (simd_nivel()) {
+    case SIMD_AVX512:
+    case SIMD_AVX2: desempacota2_avx2(e, num_bytes, r); return;
+    case SIMD_SSE2: desempacota2_sse2(e, num_bytes, r); return;
+    default: break;
+    }
+#endif
+    desempacota2_escalar(e, num_bytes, r);
+}
+
+/// Expande grupos de 8 índices de qualquer largura: cada grupo ocupa exatamente `bits`
+/// bytes, lidos em uma palavra de 64 bits da qual os campos saem por deslocamentos fixos.
+/// O corpo é instanciado com bits constante (ver GRUPOS_POR_BITS), o que desenrola os laços.
+
+static inline __attribute__((always_inline))
+void desempacota_grupos_corpo(const uint8_t *e, int bits, long grupos, uint8_t *r) {
+    unsigned mascara = (1u << bits) - 1;
+
+    for (long g = 0; g < grupos; g++) {
+        uint64_t palavra = 0;
+        for (int b = 0; b < bits; b++) {
+            palavra = palavra << 8 | e[g * bits + b];
+        }
+        for (int t = 0; t < 8; t++) {
+            r[8 * g + t] = (palavra >> (bits * (7 - t))) & mascara;
+        }
+    }
+}
+
+/// Chama corpo(a, bits, grupos, b) com bits constante, de 1 a 8.
+
+#define GRUPOS_POR_BITS(corpo, a, bits, grupos, b)         \
+    switch (bits) {                                        \
+    case 1: corpo(a, 1, grupos, b); break;                 \
+    case 2: corpo(a, 2, grupos, b); break;                 \
+    case 3: corpo(a, 3, grupos, b); break;                 \
+    case 4: corpo(a, 4, grupos, b); break;                 \
+    case 5: corpo(a, 5, grupos, b); break;                 \
+    case 6: corpo(a, 6, grupos, b); break;                 \
+    case 7: corpo(a, 7, grupos, b); break;                 \
+    default: corpo(a, 8, grupos, b); break;                \
+    }
+
+static void desempacota_grupos(const uint8_t *e, int bits, long grupos, uint8_t *r) {
+    GRUPOS_POR_BITS(desempacota_grupos_corpo, e, bits, grupos, r)
+}
+
+void indices_desempacota(const uint8_t *empacotado, int bits, long n, uint8_t *indices) {
+    long i = 0;
+
+    if (bits == 2) {
+        desempacota2(empacotado, n / 4, indices);
+        i = n / 4 * 4;
+    } else {
+        desempacota_grupos(empacotado, bits, n / 8, indices);
+        i = n / 8 * 8;
+    }
+    for (; i < n; i++) {
+        indices[i] = indices_obtem(empacotado, bits, i);
+    }
+}
+
+/* ---------------------------------------------------------------------------------- */
+/* Compactação                                                                         */
+/* ---------------------------------------------------------------------------------- */
+
+static void empacota2_escalar(const uint8_t *x, long num_bytes, uint8_t *e) {
+    for (long i = 0; i < num_bytes; i++) {
+        e[i] = x[4 * i] << 6 | x[4 * i + 1] << 4 | x[4 * i + 2] << 2 | x[4 * i + 3];
+    }
+}
+
+#if INDICES_X86
+
+/// Cada palavra de 32 bits d = i0 | i1 << 8 | i2 << 16 | i3 << 24 vira o byte
+/// i0 << 6 | i1 << 4 | i2 << 2 | i3 com quatro deslocamentos (os índices têm 2 bits).
+
+__attribute__((target("sse2")))
+static inline __m128i junta4_sse2(__m128i d) {
+    __m128i r = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(d, 6), _mm_srli_epi32(d, 4)),
+                             _mm_or_si128(_mm_srli_epi32(d, 14), _mm_srli_epi32(d, 24)));
+    return _mm_and_si128(r, _mm_set1_epi32(0xff));
+}
+
+__attribute__((target("sse2")))
+static void empacota2_sse2(const uint8_t *x, long num_bytes, uint8_t *e) {
+    long i = 0;
+
+    for (; i + 16 <= num_bytes; i += 16) {
+        __m128i r0 = junta4_sse2(_mm_loadu_si128((const __m128i*) (x + 4 * i)));
+        __m128i r1 = junta4_sse2(_mm_loadu_si128((const __m128i*) (x + 4 * i + 16)));
+        __m128i r2 = junta4_sse2(_mm_loadu_si128((const __m128i*) (x + 4 * i + 32)));
+        __m128i r3 = junta4_sse2(_mm_loadu_si128((const __m128i*) (x + 4 * i + 48)));
+
+        _mm_storeu_si128((__m128i*) (e + i), _mm_packus_epi16(_mm_packs_epi32(r0, r1), _mm_packs_epi32(r2, r3)));
+    }
+    empacota2_escalar(x + 4 * i, num_bytes - i, e + i);
+}
+
+__attribute__((target("avx2")))
+static void empacota2_avx2(const uint8_t *x, long num_bytes, uint8_t *e) {
+    const __m256i pesos_bytes = _mm256_set1_epi16(0x0104);    // (4, 1): 4 * i0 + i1
+    const __m256i pesos_palavras = _mm256_set1_epi32(0x10010); // (16, 1)
+    const __m256i recolhe = _mm256_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                             0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m256i junta_metades = _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0);
+    long i = 0;
+
+    for (; i + 8 <= num_bytes; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i*) (x + 4 * i));
+        __m256i d = _mm256_madd_epi16(_mm256_maddubs_epi16(v, pesos_bytes), pesos_palavras);
+        __m256i b = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(d, recolhe), junta_metades);
+
+        _mm_storel_epi64((__m128i*) (e + i), _mm256_castsi256_si128(b));
+    }
+    empacota2_sse2(x + 4 * i, num_bytes - i, e + i);
+}
+
+#endif
+
+static void empacota2(const uint8_t *x, long num_bytes, uint8_t *e) {
+#if INDICES_X86
+    switch (simd_nivel()) {
+    case SIMD_AVX512:
+    case SIMD_AVX2: empacota2_avx2(x, num_bytes, e); return;
+    case SIMD_SSE2: empacota2_sse2(x, num_bytes, e); return;
+    default: break;
+    }
+#endif
+    empacota2_escalar(x, num_bytes, e);
+}
+
+/// Compacta grupos de 8 índices de qualquer largura em `bits` bytes cada (inversa de desempacota_grupos_corpo).
+
+static inline __attribute__((always_inline))
+void empacota_grupos_corpo(const uint8_t *x, int bits, long grupos, uint8_t *e) {
+    for (long g = 0; g < grupos; g++) {
+        uint64_t palavra = 0;
+        for (int t = 0; t < 8; t++) {
+            palavra = palavra << bits | x[8 * g + t];
+        }
+        for (int b = 0; b < bits; b++) {
+            e[g * bits + b] = palavra >> (8 * (bits - 1 - b));
+        }
+    }
+}
+
+static void empacota_grupos(const uint8_t *x, int bits, long grupos, uint8_t *e) {
+    GRUPOS_POR_BITS(empacota_grupos_corpo, x, bits, grupos, e)
+}
+
+void indices_empacota(const uint8_t *indices, int bits, long n, uint8_t *empacotado) {
+    long i = 0, j = 0;
+    unsigned acumulado = 0;
+    int num_bits = 0;
+
+    if (bits == 2) {
+        empacota2(indices, n / 4, empacotado);
+        i = n / 4 * 4;
+        j = n / 4;
+    } else {
+        empacota_grupos(indices, bits, n / 8, empacotado);
+        i = n / 8 * 8;
+        j = n / 8 * bits;
+    }
+    for (; i < n; i++) {
+        acumulado = acumulado << bits | indices[i];
+        num_bits += bits;
+        if (num_bits >= 8) {
+            num_bits -= 8;
+            empacotado[j++] = acumulado >> num_bits;
+            acumulado &= (1u << num_bits) - 1;
+        }
+    }
+    if (num_bits > 0) {
+        empacotado[j] = acumulado << (8 - num_bits);
+    }
+}
+
+/* ---------------------------------------------------------------------------------- */
+/* Contagem de diferenças                                                              */
+/* ---------------------------------------------------------------------------------- */
+
+/// Reduz cada campo de bits da diferença ao seu bit menos significativo e conta os campos não nulos.
+
+static inline __attribute__((always_inline))
+int64_t diferencas_corpo(const uint8_t *a, const uint8_t *b, int bits, long num_bytes) {
+    uint64_t mascara = bits == 1 ? ~0ull : bits == 2 ? 0x5555555555555555ull : bits == 4 ? 0x1111111111111111ull : 0x0101010101010101ull;
+    int64_t total = 0;
+    long i = 0;
+
+    for (; i + 8 <= num_bytes; i += 8) {
+        uint64_t x, y;
+        memcpy(&x, a + i, 8);
+        memcpy(&y, b + i, 8);
+        x ^= y;
+        for (int s = 1; s < bits; s *= 2) {
+            x |= x >> s;
+        }
+        total += __builtin_popcountll(x & mascara);
+    }
+    for (; i < num_bytes; i++) {
+        unsigned x = a[i] ^ b[i];
+        for (int s = 1; s < bits; s *= 2) {
+            x |= x >> s;
+        }
+        total += __builtin_popcount(x & (unsigned) (mascara & 0xff));
+    }
+    return total;
+}
+
+static int64_t diferencas_generico(const uint8_t *a, const uint8_t *b, int bits, long num_bytes) {
+    return diferencas_corpo(a, b, bits, num_bytes);
+}
+
+#if INDICES_X86
+__attribute__((target("popcnt")))
+static int64_t diferencas_popcnt(const uint8_t *a, const uint8_t *b, int bits, long num_bytes) {
+    return diferencas_corpo(a, b, bits, num_bytes);
+}
+#endif
+
+int64_t indices_diferencas(const uint8_t *a, const uint8_t *b, int bits, long n) {
+    int64_t total = 0;
+    long i = 0;
+
+    if (8 % bits == 0) {
+        long num_bytes = n * bits / 8;
+#if INDICES_X86
+        if (simd_nivel() >= SIMD_AVX2) {
+            total = diferencas_popcnt(a, b, bits, num_bytes);
+        } else
+#endif
+        total = diferencas_generico(a, b, bits, num_bytes);
+        i = num_bytes * 8 / bits;
+    }
+    for (; i < n; i++) {
+        total += indices_obtem(a, bits, i) != indices_obtem(b, bits, i);
+    }
+    return total;
+}
@@ -0,0 +1,69 @@
+/// @file indices_qam.h
+/// @brief Índices de símbolos QAM empacotados: log2(M) bits por símbolo.
+
+/// Os índices ficam no mesmo formato do arquivo de entrada: uma sequência de bits em que
+/// cada símbolo ocupa `bits` bits consecutivos, do bit mais significativo de cada byte
+/// para o menos significativo. Para QPSK (2 bits) são 4 símbolos por byte, e o índice
+/// do símbolo i é (byte[i / 4] >> ((3 - i % 4) * 2)) & 3. Assim o arquivo lido já é o
+/// vetor de índices e o vetor demapeado já é o arquivo a ser escrito.
+
+/// Para o mapeador e o demapeador os índices são expandidos para um byte por símbolo
+/// em trechos pequenos; com 2 bits por símbolo a expansão e a compactação usam SSE2/AVX2
+/// (deslocamentos, intercalação de bytes e pshufb), conforme simd_nivel.
+
+#ifndef INDICES_QAM_H
+#define INDICES_QAM_H
+
+#include <stdint.h>
+
+/// @brief Número de bits por símbolo de uma constelação de M pontos (log2(M)), ou -1 se M não for potência de 2.
+
+int indices_bits(int M);
+
+/// @brief Número de bytes ocupados por n símbolos empacotados.
+
+long indices_bytes(long n, int bits);
+
+/// @brief Índice do símbolo i de um vetor empacotado.
+
+/// @param empacotado O vetor empacotado.
+/// @param bits Bits por símbolo (1 a 8).
+/// @param i A posição do símbolo.
+/// @return O índice.
+
+int indices_obtem(const uint8_t *empacotado, int bits, long i);
+
+/// @brief Expande n índices empacotados para um byte por símbolo.
+
+/// @param empacotado O vetor empacotado (a partir do primeiro símbolo).
+/// @param bits Bits por símbolo (1 a 8).
+/// @param n O número de símbolos.
+/// @param indices O vetor de saída, com n posições.
+
+void indices_desempacota(const uint8_t *empacotado, int bits, long n, uint8_t *indices);
+
+/// @brief Compacta n índices (um byte por símbolo) em indices_bytes(n, bits) bytes.
+
+/// Os bits que sobram no último byte são zerados.
+
+/// @param indices Os índices, cada um menor que 2^bits.
+/// @param bits Bits por símbolo (1 a 8).
+/// @param n O número de símbolos.
+/// @param empacotado O vetor de saída.
+
+void indices_empacota(const uint8_t *indices, int bits, long n, uint8_t *empacotado);
+
+/// @brief Conta os símbolos diferentes entre dois vetores empacotados.
+
+/// A comparação é feita palavra a palavra: os bits de cada diferença são reduzidos a um
+/// bit por símbolo e contados com popcount.
+
+/// @param a O primeiro vetor.
+/// @param b O segundo vetor.
+/// @param bits Bits por símbolo (1 a 8).
+/// @param n O número de símbolos.
+/// @return O número de posições com índices diferentes.
+
+int64_t indices_diferencas(const uint8_t *a, const uint8_t *b, int bits, long n);
+
+#endif // INDICES_QAM_H
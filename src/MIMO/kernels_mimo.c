@@ -0,0 +1,52 @@
+/// @file kernels_mimo.c
+/// @brief Kernels MIMO especializados por tamanho, gerados por macros.
+
+/// KERNEL_EQUALIZA instancia uma função por tamanho, com N constante, e o compilador
+/// desenrola completamente o laço sobre os streams, deixando apenas o laço sobre os
+/// símbolos. Os produtos por matrizes (canal, pré-codificador e combinador) ficam com
+/// zgemm_streams, que já mantém os acumuladores em registradores para qualquer N.
+
+#include <stddef.h>
+#include "kernels_mimo.h"
+
+#define DESENROLA _Pragma("GCC unroll 8")
+
+/// Instancia o equalizador para N streams (y_i = x_i inv_S_i).
+
+#define KERNEL_EQUALIZA(N)                                                                          \
+static void equaliza_##N(const double *inv_S, const double *const *x, double *const *y, long len) { \
+    const double *xp[N];                                                                            \
+    double *yp[N];                                                                                  \
+    double s[N];                                                                                    \
+    DESENROLA                                                                                       \
+    for (int i = 0; i < N; i++) {                                                                   \
+        xp[i] = x[i];                                                                               \
+        yp[i] = y[i];                                                                               \
+        s[i] = inv_S[i];                                                                            \
+    }                                                                                               \
+    for (long j = 0; j < len; j++) {                                                                \
+        DESENROLA                                                                                   \
+        for (int i = 0; i < N; i++) {                                                               \
+            yp[i][2 * j] = xp[i][2 * j] * s[i];                                                     \
+            yp[i][2 * j + 1] = xp[i][2 * j + 1] * s[i];                                             \
+        }                                                                                           \
+    }                                                                                               \
+}
+
+KERNEL_EQUALIZA(2)
+KERNEL_EQUALIZA(4)
+KERNEL_EQUALIZA(8)
+
+/// Kernel do equalizador para N streams, ou NULL se não houver especialização.
+
+/// @param num_streams o número de streams
+/// @return o kernel, ou NULL
+
+mimo_kernel_equaliza mimo_escolhe_feq(int num_streams) {
+    switch (num_streams) {
+    case 2: return equaliza_2;
+    case 4: return equaliza_4;
+    case 8: return equaliza_8;
+    default: return NULL;
+    }
+}
@@ -0,0 +1,29 @@
+/// @file kernels_mimo.h
+/// @brief Kernels desenrolados em tempo de compilação para os números de streams mais comuns (2, 4 e 8).
+
+/// Os streams seguem o formato de pds_telecom.c: um vetor de double complex por antena
+/// (ou stream), visto aqui como double* com parte real e imaginária intercaladas. Para
+/// outras dimensões as funções mimo_escolhe_* retornam NULL e o chamador segue pelo
+/// caminho genérico.
+
+#ifndef KERNELS_MIMO_H
+#define KERNELS_MIMO_H
+
+/// @brief Maior número de streams com kernel especializado.
+
+#define MIMO_KERNEL_MAX 8
+
+/// @brief Kernel de equalização y_i = x_i / S_i, feita como multiplicação pelos inversos.
+
+/// @param inv_S os N inversos dos valores singulares
+/// @param x os N streams de entrada
+/// @param y os N streams de saída (alocados pelo chamador; podem coincidir com x)
+/// @param len o número de símbolos de cada stream
+
+typedef void (*mimo_kernel_equaliza)(const double *inv_S, const double *const *x, double *const *y, long len);
+
+/// @brief Kernel do equalizador para N streams, ou NULL se não houver especialização.
+
+mimo_kernel_equaliza mimo_escolhe_feq(int num_streams);
+
+#endif // KERNELS_MIMO_H
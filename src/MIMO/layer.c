@@ -3,7 +3,7 @@
 #include <complex.h>
 
 int *tx_data_read(char *filename, int *size) {
-    FILE *file = fopen(filename, "a");
+    FILE *file = fopen(filename, "rb");
     if (file == NULL) {
         printf("Erro ao abrir o arquivo %s\n", filename);
         exit(1);
@@ -0,0 +1,249 @@
+/// @file modelo_canal.c
+/// @brief Geração em lote de canais MIMO complexos Rayleigh, Rice e com correlação de Kronecker.
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "modelo_canal.h"
+#include "ruido_gaussiano.h"
+#include "../matrizes/svd_complexa.h"
+
+/// Calcula r = a b para matrizes complexas (l x c vezes c x m).
+
+static void multiplica(int l, int c, int m, const double *a, int lda, const double *b, int ldb, double *r, int ldr) {
+    for (int i = 0; i < l; i++) {
+        double *ri = r + 2 * (long) i * ldr;
+        memset(ri, 0, sizeof(double) * 2 * m);
+        for (int k = 0; k < c; k++) {
+            double ar = a[2 * ((long) i * lda + k)], ai = a[2 * ((long) i * lda + k) + 1];
+            const double *bk = b + 2 * (long) k * ldb;
+            for (int j = 0; j < m; j++) {
+                ri[2 * j] += ar * bk[2 * j] - ai * bk[2 * j + 1];
+                ri[2 * j + 1] += ar * bk[2 * j + 1] + ai * bk[2 * j];
+            }
+        }
+    }
+}
+
+/// Raiz quadrada hermitiana de R (n x n): U diag(sqrt(s)) U^H, com R = U diag(s) V^H.
+
+/// @return A raiz (alocada), ou NULL se R não for hermitiana.
+
+static double *raiz_hermitiana(int n, const double *R) {
+    double maximo = 0;
+    for (int i = 0; i < 2 * n * n; i++) {
+        maximo = fmax(maximo, fabs(R[i]));
+    }
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j <= i; j++) {
+            if (fabs(R[2 * (i * n + j)] - R[2 * (j * n + i)]) > 1e-12 * maximo ||
+                fabs(R[2 * (i * n + j) + 1] + R[2 * (j * n + i) + 1]) > 1e-12 * maximo) {
+                return NULL;
+            }
+        }
+    }
+
+    double *u = malloc(sizeof(double) * 2 * n * n);
+    double *v = malloc(sizeof(double) * 2 * n * n);
+    double *s = malloc(sizeof(double) * n);
+    double *trabalho = malloc(sizeof(double) * zsvd_trabalho(n, n));
+    double *raiz = malloc(sizeof(double) * 2 * n * n);
+
+    zsvd(n, n, R, n, u, n, s, v, n, trabalho);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            double re = 0, im = 0;
+            for (int k = 0; k < n; k++) {
+                double r = sqrt(s[k]);
+                double ur = u[2 * (i * n + k)], ui = u[2 * (i * n + k) + 1];
+                double wr = u[2 * (j * n + k)], wi = -u[2 * (j * n + k) + 1];
+                re += r * (ur * wr - ui * wi);
+                im += r * (ur * wi + ui * wr);
+            }
+            raiz[2 * (i * n + j)] = re;
+            raiz[2 * (i * n + j) + 1] = im;
+        }
+    }
+    free(u);
+    free(v);
+    free(s);
+    free(trabalho);
+    return raiz;
+}
+
+modelo_canal modelo_canal_cria(int Nr, int Nt, uint64_t semente) {
+    modelo_canal m = { Nr, Nt, semente, 0, NULL, NULL, NULL, 0, 0 };
+    return m;
+}
+
+void modelo_canal_libera(modelo_canal *m) {
+    free(m->los);
+    free(m->rr);
+    free(m->rt);
+    m->los = m->rr = m->rt = NULL;
+}
+
+int modelo_canal_rice(modelo_canal *m, double K, const double *los) {
+    if (K < 0) {
+        return -1;
+    }
+    free(m->los);
+    m->los = NULL;
+    m->K = K;
+    if (K == 0) {
+        return 0;
+    }
+    m->los = malloc(sizeof(double) * 2 * m->Nr * m->Nt);
+    if (los != NULL) {
+        memcpy(m->los, los, sizeof(double) * 2 * m->Nr * m->Nt);
+    } else {
+        modelo_canal_los_ula(m->Nr, m->Nt, 0, 0, m->los);
+    }
+    return 0;
+}
+
+int modelo_canal_correlacao(modelo_canal *m, const double *Rr, const double *Rt) {
+    double *rr = NULL, *rt = NULL;
+
+    if (Rr != NULL && (rr = raiz_hermitiana(m->Nr, Rr)) == NULL) {
+        return -1;
+    }
+    if (Rt != NULL && (rt = raiz_hermitiana(m->Nt, Rt)) == NULL) {
+        free(rr);
+        return -1;
+    }
+    free(m->rr);
+    free(m->rt);
+    m->rr = rr;
+    m->rt = rt;
+    return 0;
+}
+
+void modelo_canal_correlacao_exponencial(int n, double rho, double *R) {
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            R[2 * (i * n + j)] = pow(rho, abs(i - j));
+            R[2 * (i * n + j) + 1] = 0;
+        }
+    }
+}
+
+void modelo_canal_los_ula(int Nr, int Nt, double theta_r, double theta_t, double *los) {
+    for (int i = 0; i < Nr; i++) {
+        for (int k = 0; k < Nt; k++) {
+            double fase = M_PI * (i * sin(theta_r) - k * sin(theta_t));
+            los[2 * (i * Nt + k)] = cos(fase);
+            los[2 * (i * Nt + k) + 1] = sin(fase);
+        }
+    }
+}
+
+/// Aplica a correlação e a visada direta a um lote de matrizes G (que podem ser alteradas).
+
+static void aplica_modelo(const modelo_canal *m, int lote, double *G, double *H) {
+    int Nr = m->Nr, Nt = m->Nt;
+    long tamanho = 2L * Nr * Nt;
+
+    if (m->rt != NULL && m->rr != NULL) {
+        double *T = malloc(sizeof(double) * tamanho * lote);
+        multiplica(lote * Nr, Nt, Nt, G, Nt, m->rt, Nt, T, Nt);
+        for (int b = 0; b < lote; b++) {
+            multiplica(Nr, Nr, Nt, m->rr, Nr, T + b * tamanho, Nt, H + b * tamanho, Nt);
+        }
+        free(T);
+    } else if (m->rt != NULL) {
+        multiplica(lote * Nr, Nt, Nt, G, Nt, m->rt, Nt, H, Nt);
+    } else if (m->rr != NULL) {
+        for (int b = 0; b < lote; b++) {
+            multiplica(Nr, Nr, Nt, m->rr, Nr, G + b * tamanho, Nt, H + b * tamanho, Nt);
+        }
+    }
+
+    if (m->K > 0) {
+        double a = sqrt(m->K / (m->K + 1)), d = sqrt(1 / (m->K + 1));
+        for (int b = 0; b < lote; b++) {
+            double *Hb = H + b * tamanho;
+            for (long i = 0; i < tamanho; i++) {
+                Hb[i] = a * m->los[i] + d * Hb[i];
+            }
+        }
+    }
+}
+
+void modelo_canal_gera(const modelo_canal *m, uint32_t realizacao, int lote, double *H) {
+    long tamanho = 2L * m->Nr * m->Nt;
+    int correlacionado = m->rr != NULL || m->rt != NULL;
+    if (lote <= 0) {
+        return;
+    }
+    // Sem correlação G é escrita direto na saída; com correlação, em uma área temporária.
+    double *G = correlacionado ? malloc(sizeof(double) * tamanho * lote) : H;
+
+    for (int b = 0; b < lote; b++) {
+        ruido_fluxo fluxo = { m->semente, realizacao + (uint32_t) b, MODELO_CANAL_FLUXO };
+        ruido_fluxo_gaussiano(&fluxo, 0, G + b * tamanho, tamanho, 0, sqrt(0.5));
+    }
+    aplica_modelo(m, lote, G, H);
+    if (correlacionado) {
+        free(G);
+    }
+}
+
+int modelo_canal_doppler(modelo_canal *m, double fd, int senoides) {
+    if (fd < 0 || senoides < 1) {
+        return -1;
+    }
+    m->fd = fd;
+    m->senoides = senoides;
+    return 0;
+}
+
+void modelo_canal_gera_instantes(const modelo_canal *m, uint32_t realizacao, double t0, double passo, int num, double *H) {
+    int N = m->senoides;
+    long entradas = (long) m->Nr * m->Nt, tamanho = 2 * entradas;
+    int correlacionado = m->rr != NULL || m->rt != NULL;
+    if (num <= 0 || N < 1) {
+        return;
+    }
+    double *G = correlacionado ? malloc(sizeof(double) * tamanho * num) : H;
+    // Por entrada: as frequências angulares e as fases dos dois eixos.
+    double *wc = malloc(sizeof(double) * 4 * N * entradas);
+    double *ws = wc + N * entradas, *fc = ws + N * entradas, *fs = fc + N * entradas;
+    uint64_t *r = malloc(sizeof(uint64_t) * (2 * N + 1) * entradas);
+    ruido_fluxo fluxo = { m->semente, realizacao, MODELO_CANAL_FLUXO_DOPPLER };
+
+    ruido_fluxo_uniforme(&fluxo, 0, r, (2 * N + 1) * entradas);
+    for (long e = 0; e < entradas; e++) {
+        const uint64_t *re = r + e * (2 * N + 1);
+        double theta = ((re[0] >> 11) * 0x1p-53 * 2 - 1) * M_PI;
+        for (int n = 0; n < N; n++) {
+            double alfa = (2 * M_PI * (n + 1) - M_PI + theta) / (4 * N);
+            wc[e * N + n] = 2 * M_PI * m->fd * cos(alfa);
+            ws[e * N + n] = 2 * M_PI * m->fd * sin(alfa);
+            fc[e * N + n] = ((re[1 + 2 * n] >> 11) * 0x1p-53 * 2 - 1) * M_PI;
+            fs[e * N + n] = ((re[2 + 2 * n] >> 11) * 0x1p-53 * 2 - 1) * M_PI;
+        }
+    }
+    free(r);
+
+    double escala = sqrt(1.0 / N);
+    for (int j = 0; j < num; j++) {
+        double t = t0 + j * passo;
+        double *Gj = G + j * tamanho;
+        for (long e = 0; e < entradas; e++) {
+            double soma_r = 0, soma_i = 0;
+            for (int n = 0; n < N; n++) {
+                soma_r += cos(wc[e * N + n] * t + fc[e * N + n]);
+                soma_i += cos(ws[e * N + n] * t + fs[e * N + n]);
+            }
+            Gj[2 * e] = escala * soma_r;
+            Gj[2 * e + 1] = escala * soma_i;
+        }
+    }
+    free(wc);
+
+    aplica_modelo(m, num, G, H);
+    if (correlacionado) {
+        free(G);
+    }
+}
@@ -0,0 +1,133 @@
+/// @file modelo_canal.h
+/// @brief Modelos estatísticos de canal MIMO complexo: Rayleigh, Rice e correlação de Kronecker.
+
+/// Cada realização é H = sqrt(K / (K + 1)) H_los + sqrt(1 / (K + 1)) R_r^{1/2} G R_t^{1/2},
+/// com G de entradas complexas gaussianas independentes de variância unitária (metade em
+/// cada eixo). Com K = 0 e sem correlação o canal é Rayleigh i.i.d.; R_r e R_t são as
+/// matrizes de correlação espacial do receptor e do transmissor (diagonal unitária para
+/// que E|h_ij|^2 = 1).
+
+/// As matrizes ficam no formato contíguo de svd_complexa.h (por linhas, parte real e
+/// imaginária intercaladas), uma realização após a outra. G vem do gerador por contador
+/// de ruido_gaussiano.h, no fluxo MODELO_CANAL_FLUXO da realização, então a realização
+/// r é sempre a mesma, qualquer que seja o lote em que é gerada.
+
+/// Com desvanecimento Doppler (modelo_canal_doppler), G deixa de ser fixa na realização
+/// e passa a ser uma função do tempo: cada entrada é uma soma de senoides (modelo de
+/// Zheng e Xiao), com autocorrelação J0(2 pi fd tau) de Jakes, amostrada em qualquer
+/// instante por modelo_canal_gera_instantes.
+
+#ifndef MODELO_CANAL_H
+#define MODELO_CANAL_H
+
+#include <stdint.h>
+
+/// @brief Fluxo do gerador por contador usado pelas entradas de G.
+
+#define MODELO_CANAL_FLUXO 0xfffffffdu
+
+/// @brief Fluxo do gerador por contador usado pelos ângulos e fases da soma de senoides.
+
+#define MODELO_CANAL_FLUXO_DOPPLER 0xfffffffcu
+
+/// @brief Modelo de canal criado por modelo_canal_cria.
+
+typedef struct {
+    int Nr;           /**< Número de receptores. */
+    int Nt;           /**< Número de transmissores. */
+    uint64_t semente; /**< Semente do gerador por contador. */
+    double K;         /**< Fator de Rice linear (0 para Rayleigh). */
+    double *los;      /**< Componente de visada direta H_los (Nr x Nt), ou NULL se K = 0. */
+    double *rr;       /**< R_r^{1/2} (Nr x Nr), ou NULL sem correlação no receptor. */
+    double *rt;       /**< R_t^{1/2} (Nt x Nt), ou NULL sem correlação no transmissor. */
+    double fd;        /**< Desvio Doppler máximo normalizado (ciclos por símbolo). */
+    int senoides;     /**< Senoides por eixo de cada entrada (0 sem Doppler). */
+} modelo_canal;
+
+/// @brief Cria um modelo Rayleigh i.i.d. Nr x Nt.
+
+modelo_canal modelo_canal_cria(int Nr, int Nt, uint64_t semente);
+
+/// @brief Libera a memória do modelo.
+
+void modelo_canal_libera(modelo_canal *m);
+
+/// @brief Acrescenta uma componente de visada direta com fator de Rice K.
+
+/// @param m O modelo.
+/// @param K O fator de Rice linear (K >= 0).
+/// @param los A componente de visada direta (Nr x Nt), ou NULL para a de dois arranjos
+///        lineares alinhados (todas as entradas iguais a 1).
+/// @return 0 em caso de sucesso, -1 se K for negativo.
+
+int modelo_canal_rice(modelo_canal *m, double K, const double *los);
+
+/// @brief Acrescenta correlação espacial de Kronecker.
+
+/// As raízes quadradas hermitianas são calculadas uma vez aqui (pela SVD, que para
+/// matrizes hermitianas semidefinidas positivas coincide com a decomposição espectral).
+
+/// @param m O modelo.
+/// @param Rr A correlação no receptor (Nr x Nr), ou NULL.
+/// @param Rt A correlação no transmissor (Nt x Nt), ou NULL.
+/// @return 0 em caso de sucesso, -1 se alguma matriz não for hermitiana.
+
+int modelo_canal_correlacao(modelo_canal *m, const double *Rr, const double *Rt);
+
+/// @brief Matriz de correlação exponencial n x n: R_ij = rho^|i - j|.
+
+void modelo_canal_correlacao_exponencial(int n, double rho, double *R);
+
+/// @brief Componente de visada direta de dois arranjos lineares com espaçamento de meio comprimento de onda.
+
+/// H_los = a_r(theta_r) a_t(theta_t)^H, com a_n(theta) = exp(j pi n sin(theta)).
+
+/// @param Nr Número de receptores.
+/// @param Nt Número de transmissores.
+/// @param theta_r Ângulo de chegada, em radianos.
+/// @param theta_t Ângulo de partida, em radianos.
+/// @param los A matriz de saída (Nr x Nt).
+
+void modelo_canal_los_ula(int Nr, int Nt, double theta_r, double theta_t, double *los);
+
+/// @brief Gera as realizações realizacao a realizacao + lote - 1.
+
+/// Os produtos por R_t^{1/2} de todo o lote são feitos em um único produto matricial,
+/// com as matrizes G empilhadas (lote * Nr linhas).
+
+/// @param m O modelo.
+/// @param realizacao O índice da primeira realização.
+/// @param lote O número de realizações.
+/// @param H O vetor de saída, com lote matrizes Nr x Nt seguidas.
+
+void modelo_canal_gera(const modelo_canal *m, uint32_t realizacao, int lote, double *H);
+
+/// @brief Torna o canal variante no tempo, com desvanecimento de Jakes.
+
+/// @param m O modelo.
+/// @param fd O desvio Doppler máximo normalizado pela taxa de símbolos (fd Ts).
+/// @param senoides O número de senoides por eixo de cada entrada (8 a 16 já dão a
+///        autocorrelação de Jakes com boa precisão).
+/// @return 0 em caso de sucesso, -1 se fd for negativo ou senoides < 1.
+
+int modelo_canal_doppler(modelo_canal *m, double fd, int senoides);
+
+/// @brief Gera a realização realizacao nos instantes t0, t0 + passo, ..., t0 + (num - 1) passo.
+
+/// Os instantes são dados em símbolos. As entradas de G são
+/// sqrt(1 / N) sum_n [cos(2 pi fd t cos a_n + phi_n) + j cos(2 pi fd t sin a_n + psi_n)],
+/// com a_n = (2 pi n - pi + theta) / (4 N) e theta, phi_n e psi_n uniformes, sorteados
+/// por entrada no fluxo MODELO_CANAL_FLUXO_DOPPLER da realização; a correlação e a
+/// componente de visada direta (fixa) são aplicadas como em modelo_canal_gera. A amostra
+/// de um instante não depende dos outros instantes pedidos.
+
+/// @param m O modelo (com modelo_canal_doppler já chamado).
+/// @param realizacao O índice da realização.
+/// @param t0 O primeiro instante.
+/// @param passo O intervalo entre instantes.
+/// @param num O número de instantes.
+/// @param H O vetor de saída, com num matrizes Nr x Nt seguidas.
+
+void modelo_canal_gera_instantes(const modelo_canal *m, uint32_t realizacao, double t0, double passo, int num, double *H);
+
+#endif // MODELO_CANAL_H
@@ -0,0 +1,393 @@
+/// @file modulacao_qam.c
+/// @brief Tabelas das constelações M-QAM, mapeamento e decisão vetorizados.
+
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+#include "modulacao_qam.h"
+#include "indices_qam.h"
+#include "../matrizes/simd_complexo.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define QAM_X86 1
+#include <immintrin.h>
+#else
+#define QAM_X86 0
+#endif
+
+/// Número de campos expandidos de cada vez (múltiplo de 8, para que cada trecho comece em um byte).
+
+#define QAM_CAMPOS 2048
+
+/// Nível a de um rótulo: valor no eixo real e no imaginário (orientação invertida), já normalizados.
+
+#define NIVEL(a, escala) (a) * (escala), -(a) * (escala)
+
+/* Tabelas indexadas pelo rótulo de Gray de cada eixo. O rótulo g corresponde ao nível
+   de posição L = g ^ (g >> 1) ^ (g >> 2) ^ ... (inversa do código de Gray), de amplitude
+   2 L - (lado - 1). */
+
+#define ESCALA_4 0.70710678118654746 // 1 / sqrt(2)
+
+static const double niveis_4[4] = {
+    NIVEL(-1, ESCALA_4), NIVEL(1, ESCALA_4),
+};
+
+#define ESCALA_16 0.31622776601683794 // 1 / sqrt(10)
+
+static const double niveis_16[8] = {
+    NIVEL(-3, ESCALA_16), NIVEL(-1, ESCALA_16), NIVEL(3, ESCALA_16), NIVEL(1, ESCALA_16),
+};
+
+#define ESCALA_64 0.15430334996209191 // 1 / sqrt(42)
+
+static const double niveis_64[16] = {
+    NIVEL(-7, ESCALA_64), NIVEL(-5, ESCALA_64), NIVEL(-1, ESCALA_64), NIVEL(-3, ESCALA_64),
+    NIVEL(7, ESCALA_64), NIVEL(5, ESCALA_64), NIVEL(1, ESCALA_64), NIVEL(3, ESCALA_64),
+};
+
+#define ESCALA_256 0.076696498884737035 // 1 / sqrt(170)
+
+static const double niveis_256[32] = {
+    NIVEL(-15, ESCALA_256), NIVEL(-13, ESCALA_256), NIVEL(-9, ESCALA_256), NIVEL(-11, ESCALA_256),
+    NIVEL(-1, ESCALA_256), NIVEL(-3, ESCALA_256), NIVEL(-7, ESCALA_256), NIVEL(-5, ESCALA_256),
+    NIVEL(15, ESCALA_256), NIVEL(13, ESCALA_256), NIVEL(9, ESCALA_256), NIVEL(11, ESCALA_256),
+    NIVEL(1, ESCALA_256), NIVEL(3, ESCALA_256), NIVEL(7, ESCALA_256), NIVEL(5, ESCALA_256),
+};
+
+#define ESCALA_1024 0.038291979053374177 // 1 / sqrt(682)
+
+static const double niveis_1024[64] = {
+    NIVEL(-31, ESCALA_1024), NIVEL(-29, ESCALA_1024), NIVEL(-25, ESCALA_1024), NIVEL(-27, ESCALA_1024),
+    NIVEL(-17, ESCALA_1024), NIVEL(-19, ESCALA_1024), NIVEL(-23, ESCALA_1024), NIVEL(-21, ESCALA_1024),
+    NIVEL(-1, ESCALA_1024), NIVEL(-3, ESCALA_1024), NIVEL(-7, ESCALA_1024), NIVEL(-5, ESCALA_1024),
+    NIVEL(-15, ESCALA_1024), NIVEL(-13, ESCALA_1024), NIVEL(-9, ESCALA_1024), NIVEL(-11, ESCALA_1024),
+    NIVEL(31, ESCALA_1024), NIVEL(29, ESCALA_1024), NIVEL(25, ESCALA_1024), NIVEL(27, ESCALA_1024),
+    NIVEL(17, ESCALA_1024), NIVEL(19, ESCALA_1024), NIVEL(23, ESCALA_1024), NIVEL(21, ESCALA_1024),
+    NIVEL(1, ESCALA_1024), NIVEL(3, ESCALA_1024), NIVEL(7, ESCALA_1024), NIVEL(5, ESCALA_1024),
+    NIVEL(15, ESCALA_1024), NIVEL(13, ESCALA_1024), NIVEL(9, ESCALA_1024), NIVEL(11, ESCALA_1024),
+};
+
+static const modulacao_qam constelacoes[] = {
+    { 4, 2, 1, 2, ESCALA_4, niveis_4 },
+    { 16, 4, 2, 4, ESCALA_16, niveis_16 },
+    { 64, 6, 3, 8, ESCALA_64, niveis_64 },
+    { 256, 8, 4, 16, ESCALA_256, niveis_256 },
+    { 1024, 10, 5, 32, ESCALA_1024, niveis_1024 },
+};
+
+const modulacao_qam *modulacao_qam_obtem(int M) {
+    for (size_t i = 0; i < sizeof(constelacoes) / sizeof(constelacoes[0]); i++) {
+        if (constelacoes[i].M == M) {
+            return &constelacoes[i];
+        }
+    }
+    return NULL;
+}
+
+/// Busca na tabela: o campo p (real se p é par, imaginário se ímpar) vira niveis[2 * campo + p % 2].
+
+static void busca_escalar(const double *niveis, const uint8_t *campos, long n, double *r) {
+    for (long p = 0; p < n; p++) {
+        r[p] = niveis[2 * campos[p] + (p & 1)];
+    }
+}
+
+#if QAM_X86
+
+__attribute__((target("avx2")))
+static void busca_avx2(const double *niveis, const uint8_t *campos, long n, double *r) {
+    const __m128i eixo = _mm_setr_epi32(0, 1, 0, 1);
+    long p = 0;
+
+    for (; p + 4 <= n; p += 4) {
+        int c;
+        memcpy(&c, campos + p, 4);
+        __m128i indices = _mm_add_epi32(_mm_slli_epi32(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(c)), 1), eixo);
+        _mm256_storeu_pd(r + p, _mm256_i32gather_pd(niveis, indices, 8));
+    }
+    busca_escalar(niveis, campos + p, n - p, r + p);
+}
+
+__attribute__((target("avx512f")))
+static void busca_avx512(const double *niveis, const uint8_t *campos, long n, double *r) {
+    const __m256i eixo = _mm256_setr_epi32(0, 1, 0, 1, 0, 1, 0, 1);
+    long p = 0;
+
+    for (; p + 8 <= n; p += 8) {
+        __m256i indices = _mm256_add_epi32(_mm256_slli_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*) (campos + p))), 1), eixo);
+        _mm512_storeu_pd(r + p, _mm512_i32gather_pd(indices, niveis, 8));
+    }
+    busca_escalar(niveis, campos + p, n - p, r + p);
+}
+
+#endif
+
+static void busca(const double *niveis, const uint8_t *campos, long n, double *r) {
+#if QAM_X86
+    switch (simd_nivel()) {
+    case SIMD_AVX512: busca_avx512(niveis, campos, n, r); return;
+    case SIMD_AVX2: busca_avx2(niveis, campos, n, r); return;
+    default: break;
+    }
+#endif
+    busca_escalar(niveis, campos, n, r);
+}
+
+void qam_mapeia(const modulacao_qam *mod, const uint8_t *bits, long n, double *simbolos) {
+    uint8_t campos[QAM_CAMPOS];
+    long total = 2 * n;
+
+    for (long p = 0; p < total; p += QAM_CAMPOS) {
+        long m = total - p < QAM_CAMPOS ? total - p : QAM_CAMPOS;
+        indices_desempacota(bits + p * mod->bits_eixo / 8, mod->bits_eixo, m, campos);
+        busca(mod->niveis, campos, m, simbolos + p);
+    }
+}
+
+/* ---------------------------------------------------------------------------------- */
+/* Decisão                                                                             */
+/* ---------------------------------------------------------------------------------- */
+
+/// Decide cada campo: o eixo imaginário tem orientação invertida, daí o fator de sinal
+/// alternado em fator[2]. O limite é aplicado ainda em ponto flutuante, de modo que a
+/// conversão por truncamento já é o floor.
+
+static void decide_escalar(const double *fator, double meio, double maximo, const double *x, long n, uint8_t *campos) {
+    for (long p = 0; p < n; p++) {
+        double t = x[p] * fator[p & 1] + meio;
+        t = t < 0 ? 0 : t;
+        t = t > maximo ? maximo : t;
+        int nivel = (int) t;
+        campos[p] = nivel ^ (nivel >> 1);
+    }
+}
+
+#if QAM_X86
+
+__attribute__((target("sse2")))
+static void decide_sse2(const double *fator, double meio, double maximo, const double *x, long n, uint8_t *campos) {
+    const __m128d f = _mm_setr_pd(fator[0], fator[1]);
+    const __m128d m = _mm_set1_pd(meio), zero = _mm_setzero_pd(), lim = _mm_set1_pd(maximo);
+    long p = 0;
+
+    for (; p + 2 <= n; p += 2) {
+        __m128d t = _mm_min_pd(_mm_max_pd(_mm_add_pd(_mm_mul_pd(_mm_loadu_pd(x + p), f), m), zero), lim);
+        __m128i niveis = _mm_cvttpd_epi32(t);
+        __m128i g = _mm_xor_si128(niveis, _mm_srli_epi32(niveis, 1));
+        campos[p] = _mm_cvtsi128_si32(g);
+        campos[p + 1] = _mm_cvtsi128_si32(_mm_srli_si128(g, 4));
+    }
+    decide_escalar(fator, meio, maximo, x + p, n - p, campos + p);
+}
+
+__attribute__((target("avx2")))
+static void decide_avx2(const double *fator, double meio, double maximo, const double *x, long n, uint8_t *campos) {
+    const __m256d f = _mm256_setr_pd(fator[0], fator[1], fator[0], fator[1]);
+    const __m256d m = _mm256_set1_pd(meio), zero = _mm256_setzero_pd(), lim = _mm256_set1_pd(maximo);
+    long p = 0;
+
+    for (; p + 8 <= n; p += 8) {
+        __m256d t0 = _mm256_min_pd(_mm256_max_pd(_mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(x + p), f), m), zero), lim);
+        __m256d t1 = _mm256_min_pd(_mm256_max_pd(_mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(x + p + 4), f), m), zero), lim);
+        __m128i n0 = _mm256_cvttpd_epi32(t0), n1 = _mm256_cvttpd_epi32(t1);
+        __m128i g0 = _mm_xor_si128(n0, _mm_srli_epi32(n0, 1)), g1 = _mm_xor_si128(n1, _mm_srli_epi32(n1, 1));
+        __m128i b = _mm_packus_epi16(_mm_packs_epi32(g0, g1), _mm_setzero_si128());
+        _mm_storel_epi64((__m128i*) (campos + p), b);
+    }
+    decide_escalar(fator, meio, maximo, x + p, n - p, campos + p);
+}
+
+__attribute__((target("avx512f")))
+static void decide_avx512(const double *fator, double meio, double maximo, const double *x, long n, uint8_t *campos) {
+    const __m512d f = _mm512_setr_pd(fator[0], fator[1], fator[0], fator[1], fator[0], fator[1], fator[0], fator[1]);
+    const __m512d m = _mm512_set1_pd(meio), zero = _mm512_setzero_pd(), lim = _mm512_set1_pd(maximo);
+    long p = 0;
+
+    for (; p + 16 <= n; p += 16) {
+        __m512d t0 = _mm512_min_pd(_mm512_max_pd(_mm512_fmadd_pd(_mm512_loadu_pd(x + p), f, m), zero), lim);
+        __m512d t1 = _mm512_min_pd(_mm512_max_pd(_mm512_fmadd_pd(_mm512_loadu_pd(x + p + 8), f, m), zero), lim);
+        __m512i niveis = _mm512_inserti64x4(_mm512_castsi256_si512(_mm512_cvttpd_epi32(t0)), _mm512_cvttpd_epi32(t1), 1);
+        __m512i g = _mm512_xor_si512(niveis, _mm512_srli_epi32(niveis, 1));
+        _mm_storeu_si128((__m128i*) (campos + p), _mm512_cvtepi32_epi8(g));
+    }
+    decide_escalar(fator, meio, maximo, x + p, n - p, campos + p);
+}
+
+#endif
+
+static void decide(const double *fator, double meio, double maximo, const double *x, long n, uint8_t *campos) {
+#if QAM_X86
+    switch (simd_nivel()) {
+    case SIMD_AVX512: decide_avx512(fator, meio, maximo, x, n, campos); return;
+    case SIMD_AVX2: decide_avx2(fator, meio, maximo, x, n, campos); return;
+    case SIMD_SSE2: decide_sse2(fator, meio, maximo, x, n, campos); return;
+    default: break;
+    }
+#endif
+    decide_escalar(fator, meio, maximo, x, n, campos);
+}
+
+void qam_demapeia(const modulacao_qam *mod, const double *simbolos, long n, uint8_t *bits) {
+    const double fator[2] = { 0.5 / mod->escala, -0.5 / mod->escala };
+    uint8_t campos[QAM_CAMPOS];
+    long total = 2 * n;
+
+    for (long p = 0; p < total; p += QAM_CAMPOS) {
+        long m = total - p < QAM_CAMPOS ? total - p : QAM_CAMPOS;
+        decide(fator, 0.5 * mod->lado, mod->lado - 1, simbolos + p, m, campos);
+        indices_empacota(campos, mod->bits_eixo, m, bits + p * mod->bits_eixo / 8);
+    }
+}
+
+/* ---------------------------------------------------------------------------------- */
+/* LLR (max-log)                                                                       */
+/* ---------------------------------------------------------------------------------- */
+
+/* Em cada eixo o campo é levado à coordenada u em que o nível de posição L fica em u = L.
+   No código de Gray refletido o bit j do rótulo de L é floor((L + 2^j) / 2^(j+1)) mod 2,
+   constante em sequências de 2^(j+1) níveis [s, s + 2^(j+1) - 1], s = r 2^(j+1) - 2^j.
+   Os níveis mais próximos de u com o bit j trocado são então s - 1 e s + 2^(j+1), quando
+   existem. As distâncias são medidas em u e convertidas por fator = (2 escala)^2 / variancia. */
+
+/// Número de símbolos processados de cada vez por qam_llr_int8.
+
+#define QAM_LLR_TRECHO 256
+
+static void llr_escalar(const modulacao_qam *mod, const double *f, double fator, const double *x, long num_campos, float *llr, long passo) {
+    int k = mod->bits_eixo, ultimo = mod->lado - 1;
+    double centro = 0.5 * ultimo;
+
+    for (long p = 0; p < num_campos; p++) {
+        double u = x[p] * f[p & 1] + centro;
+        double t = u + 0.5;
+        t = t < 0 ? 0 : t;
+        t = t > ultimo ? ultimo : t;
+        int nivel = (int) t;
+        double proprio = (u - nivel) * (u - nivel);
+        float *saida = llr + (p >> 1) * passo + (p & 1) * k;
+
+        for (int j = 0; j < k; j++) {
+            int r = (nivel + (1 << j)) >> (j + 1);
+            int esquerda = (r << (j + 1)) - (1 << j) - 1, direita = esquerda + (2 << j) + 1;
+            double de = esquerda >= 0 ? (u - esquerda) * (u - esquerda) : INFINITY;
+            double dd = direita <= ultimo ? (u - direita) * (u - direita) : INFINITY;
+            double llr_j = ((de < dd ? de : dd) - proprio) * fator;
+            saida[k - 1 - j] = (r & 1) ? -llr_j : llr_j;
+        }
+    }
+}
+
+#if QAM_X86
+
+/// Os níveis e as sequências de Gray são calculados em inteiros de 32 bits (4 por
+/// registrador SSE) e só as distâncias em double.
+
+__attribute__((target("avx2,fma")))
+static void llr_avx2(const modulacao_qam *mod, const double *f, double fator, const double *x, long num_campos, float *llr, long passo) {
+    int k = mod->bits_eixo;
+    const __m256d fv = _mm256_setr_pd(f[0], f[1], f[0], f[1]);
+    const __m256d centro = _mm256_set1_pd(0.5 * (mod->lado - 1) + 0.5), ultimo = _mm256_set1_pd(mod->lado - 1);
+    const __m256d meio = _mm256_set1_pd(0.5), zero = _mm256_setzero_pd();
+    const __m256d infinito = _mm256_set1_pd(INFINITY), fv_llr = _mm256_set1_pd(fator);
+    const __m128i um = _mm_set1_epi32(1), ultimo_i = _mm_set1_epi32(mod->lado - 1), menos_um = _mm_set1_epi32(-1);
+    long p = 0;
+
+    for (; p + 4 <= num_campos; p += 4) {
+        // t = u + 1/2; u é recuperado subtraindo 1/2.
+        __m256d t = _mm256_fmadd_pd(_mm256_loadu_pd(x + p), fv, centro);
+        __m256d u = _mm256_sub_pd(t, meio);
+        __m128i nivel = _mm256_cvttpd_epi32(_mm256_min_pd(_mm256_max_pd(t, zero), ultimo));
+        __m256d d = _mm256_sub_pd(u, _mm256_cvtepi32_pd(nivel));
+        __m256d proprio = _mm256_mul_pd(d, d);
+        float resultado[8][4];
+
+        for (int j = 0; j < k; j++) {
+            __m128i h = _mm_set1_epi32(1 << j), desloc = _mm_cvtsi32_si128(j + 1);
+            __m128i r = _mm_srl_epi32(_mm_add_epi32(nivel, h), desloc);
+            __m128i esquerda = _mm_sub_epi32(_mm_sub_epi32(_mm_sll_epi32(r, desloc), h), um);
+            __m128i direita = _mm_add_epi32(esquerda, _mm_add_epi32(_mm_add_epi32(h, h), um));
+            __m256d de = _mm256_sub_pd(u, _mm256_cvtepi32_pd(esquerda)), dd = _mm256_sub_pd(u, _mm256_cvtepi32_pd(direita));
+            __m256d valida_e = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(_mm_cmpgt_epi32(esquerda, menos_um)));
+            __m256d valida_d = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(_mm_cmpgt_epi32(_mm_add_epi32(ultimo_i, um), direita)));
+            de = _mm256_blendv_pd(infinito, _mm256_mul_pd(de, de), valida_e);
+            dd = _mm256_blendv_pd(infinito, _mm256_mul_pd(dd, dd), valida_d);
+            __m128 llr_j = _mm256_cvtpd_ps(_mm256_mul_pd(_mm256_sub_pd(_mm256_min_pd(de, dd), proprio), fv_llr));
+            // Sinal trocado quando r é ímpar: o bit de paridade vai para o bit de sinal do float.
+            llr_j = _mm_xor_ps(llr_j, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(r, um), 31)));
+            _mm_storeu_ps(resultado[j], llr_j);
+        }
+        for (int q = 0; q < 4; q++) {
+            float *saida = llr + ((p + q) >> 1) * passo + ((p + q) & 1) * k;
+            for (int j = 0; j < k; j++) {
+                saida[k - 1 - j] = resultado[j][q];
+            }
+        }
+    }
+    llr_escalar(mod, f, fator, x + p, num_campos - p, llr + (p >> 1) * passo, passo);
+}
+
+#endif
+
+void qam_llr(const modulacao_qam *mod, const double *simbolos, long n, double variancia, float *llr, long passo) {
+    const double f[2] = { 0.5 / mod->escala, -0.5 / mod->escala };
+    double fator = 4 * mod->escala * mod->escala / variancia;
+
+#if QAM_X86
+    if (simd_nivel() >= SIMD_AVX2) {
+        llr_avx2(mod, f, fator, simbolos, 2 * n, llr, passo);
+        return;
+    }
+#endif
+    llr_escalar(mod, f, fator, simbolos, 2 * n, llr, passo);
+}
+
+static void quantiza_escalar(const float *x, long n, float escala, int8_t *r) {
+    for (long i = 0; i < n; i++) {
+        float v = x[i] * escala;
+        v = v > 127 ? 127 : v < -127 ? -127 : v;
+        r[i] = (int8_t) lrintf(v);
+    }
+}
+
+#if QAM_X86
+
+/// Os produtos são limitados a [-127, 127] ainda em float: acima de 2^31 a conversão
+/// para int32 devolveria INT_MIN, que o empacotamento saturaria em -128.
+
+__attribute__((target("avx2")))
+static void quantiza_avx2(const float *x, long n, float escala, int8_t *r) {
+    const __m256 e = _mm256_set1_ps(escala);
+    const __m256 maximo = _mm256_set1_ps(127), minimo = _mm256_set1_ps(-127);
+    long i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m256 va = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(x + i), e), minimo), maximo);
+        __m256 vb = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(x + i + 8), e), minimo), maximo);
+        __m256i palavras = _mm256_permute4x64_epi64(_mm256_packs_epi32(_mm256_cvtps_epi32(va), _mm256_cvtps_epi32(vb)), 0xd8);
+        __m128i bytes = _mm_packs_epi16(_mm256_castsi256_si128(palavras), _mm256_extracti128_si256(palavras, 1));
+        _mm_storeu_si128((__m128i*) (r + i), bytes);
+    }
+    quantiza_escalar(x + i, n - i, escala, r + i);
+}
+
+#endif
+
+void qam_llr_int8(const modulacao_qam *mod, const double *simbolos, long n, double variancia, double escala, int8_t *llr, long passo) {
+    float trecho[QAM_LLR_TRECHO * 10];
+    int8_t quantizado[QAM_LLR_TRECHO * 10];
+
+    for (long t = 0; t < n; t += QAM_LLR_TRECHO) {
+        long m = n - t < QAM_LLR_TRECHO ? n - t : QAM_LLR_TRECHO;
+        qam_llr(mod, simbolos + 2 * t, m, variancia, trecho, mod->bits);
+#if QAM_X86
+        if (simd_nivel() >= SIMD_AVX2) {
+            quantiza_avx2(trecho, m * mod->bits, escala, quantizado);
+        } else
+#endif
+        quantiza_escalar(trecho, m * mod->bits, escala, quantizado);
+        for (long q = 0; q < m; q++) {
+            memcpy(llr + (t + q) * passo, quantizado + q * mod->bits, mod->bits);
+        }
+    }
+}
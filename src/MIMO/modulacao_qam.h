@@ -0,0 +1,90 @@
+/// @file modulacao_qam.h
+/// @brief Modulação M-QAM quadrada com código de Gray (4 a 1024 pontos), por tabelas.
+
+/// Cada símbolo de log2(M) bits é dividido em duas metades: os bits mais significativos
+/// escolhem o nível do eixo real e os menos significativos o do eixo imaginário. Em cada
+/// eixo os níveis PAM ±1, ±3, ... são rotulados em código de Gray, crescendo no eixo real
+/// e decrescendo no imaginário (a mesma orientação do QPSK de QAMmapper), e toda a
+/// constelação é escalada para energia média unitária.
+
+/// Como as duas metades têm o mesmo número de bits, os bits empacotados de n símbolos
+/// são lidos como 2n campos que alternam eixo real e imaginário; o mapeamento é então
+/// uma busca em uma tabela unidimensional de níveis, feita com gather em AVX2/AVX-512.
+/// A decisão faz o caminho inverso, campo a campo.
+
+#ifndef MODULACAO_QAM_H
+#define MODULACAO_QAM_H
+
+#include <stdint.h>
+
+/// @brief Maior constelação suportada.
+
+#define QAM_M_MAX 1024
+
+/// @brief Descrição de uma constelação M-QAM quadrada.
+
+typedef struct {
+    int M;                /**< Número de pontos. */
+    int bits;             /**< Bits por símbolo, log2(M). */
+    int bits_eixo;        /**< Bits por eixo, bits / 2. */
+    int lado;             /**< Níveis por eixo, sqrt(M). */
+    double escala;        /**< Fator de normalização dos níveis inteiros, 1 / sqrt(2 (M - 1) / 3). */
+    const double *niveis; /**< 2 * lado valores: para cada rótulo de Gray, o nível real e o imaginário. */
+} modulacao_qam;
+
+/// @brief Constelação de M pontos (4, 16, 64, 256 ou 1024), ou NULL se M não for suportado.
+
+const modulacao_qam *modulacao_qam_obtem(int M);
+
+/// @brief Mapeia n símbolos lidos diretamente dos bits empacotados.
+
+/// @param mod A constelação.
+/// @param bits Os bits empacotados (mod->bits por símbolo, a partir do primeiro bit do vetor).
+/// @param n O número de símbolos.
+/// @param simbolos Vetor de saída com n complexos (parte real e imaginária intercaladas).
+
+void qam_mapeia(const modulacao_qam *mod, const uint8_t *bits, long n, double *simbolos);
+
+/// @brief Decide (hard decision) n símbolos recebidos, gravando os bits empacotados.
+
+/// Cada eixo é decidido separadamente e em tempo constante: o valor é escalado para a
+/// posição do nível, L = floor(x / (2 escala) + lado / 2), limitado a [0, lado - 1], e
+/// convertido no rótulo de Gray L ^ (L >> 1). O resultado é o do ponto mais próximo da
+/// constelação, sem calcular nenhuma distância; as versões SSE2/AVX2/AVX-512 não têm desvios.
+
+/// @param mod A constelação.
+/// @param simbolos Os n símbolos recebidos (parte real e imaginária intercaladas), já equalizados.
+/// @param n O número de símbolos.
+/// @param bits Vetor de saída com indices_bytes(n, mod->bits) bytes.
+
+void qam_demapeia(const modulacao_qam *mod, const double *simbolos, long n, uint8_t *bits);
+
+/// @brief Calcula as LLRs (aproximação max-log) de cada bit de n símbolos recebidos.
+
+/// Para cada bit, LLR = (d1 - d0) / variancia, onde d0 e d1 são as menores distâncias
+/// quadráticas do símbolo aos pontos da constelação com aquele bit igual a 0 e a 1 (LLR
+/// positiva favorece o bit 0). Como a constelação é quadrada com código de Gray por eixo,
+/// o cálculo é feito por eixo e em O(log2(M)): o ponto mais próximo é o da decisão abrupta,
+/// e o mais próximo com o bit trocado é um dos vizinhos da sequência de níveis em que
+/// aquele bit é constante. Há versão AVX2 (4 campos por vez).
+
+/// @param mod A constelação.
+/// @param simbolos Os n símbolos recebidos (parte real e imaginária intercaladas), já equalizados.
+/// @param n O número de símbolos.
+/// @param variancia A variância do ruído complexo (E|ruído|^2) nesses símbolos.
+/// @param llr Saída: mod->bits LLRs por símbolo, na ordem dos bits empacotados.
+/// @param passo Distância, em floats, entre as LLRs de dois símbolos consecutivos (mod->bits se contíguas).
+
+void qam_llr(const modulacao_qam *mod, const double *simbolos, long n, double variancia, float *llr, long passo);
+
+/// @brief Versão de qam_llr com saída quantizada em int8.
+
+/// Cada LLR é multiplicada por escala, arredondada e saturada em [-127, 127].
+
+/// @param escala O fator de quantização.
+/// @param llr Saída: mod->bits valores por símbolo.
+/// @param passo Distância, em bytes, entre as LLRs de dois símbolos consecutivos.
+
+void qam_llr_int8(const modulacao_qam *mod, const double *simbolos, long n, double variancia, double escala, int8_t *llr, long passo);
+
+#endif // MODULACAO_QAM_H
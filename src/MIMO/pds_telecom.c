@@ -4,36 +4,87 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <complex.h>
-#include <gsl/gsl_linalg.h>
+#include <math.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "../matrizes/simd_complexo.h"
+#include "../matrizes/svd_complexa.h"
+#include "../matrizes/gemm.h"
+#include "kernels_mimo.h"
+#include "indices_qam.h"
+#include "modulacao_qam.h"
+#include "arquivo_entrada.h"
+#include "arquivo_saida.h"
+#include "ruido_gaussiano.h"
+#include "cache_svd.h"
+#include "pds_telecom.h"
+
+/// Tamanho padrão, em bytes do arquivo de entrada, de cada bloco do modo streaming.
+#define STREAMING_BLOCO_PADRAO (16 * 1024)
+
+/// Bits por símbolo da constelação QPSK usada pela cadeia.
+#define QAM_BITS 2
+
+/// Maior arquivo de entrada, em bytes, do modo padrão: os números de símbolos são int, com
+/// folga para o preenchimento das streams. Arquivos maiores vão pelo modo streaming.
+#define ENTRADA_PADRAO_MAXIMA ((size_t) (INT_MAX / 2) / (8 / QAM_BITS))
+
+/// Número de índices expandidos de cada vez pelo mapeador (múltiplo de 8).
+#define QAM_TRECHO 1024
+
+/// Número de símbolos de cada vez nas áreas temporárias dos kernels zvet_ da cadeia.
+#define ZVET_TRECHO 256
+
+/// Semente do canal e do ruído quando ruido_canal_semente não é chamada.
+#define RUIDO_SEMENTE_PADRAO 2
+
+/// Fluxo do gerador por contador usado pelas entradas da matriz de canal (os fluxos 0 a Nr - 1 são o ruído de cada receptor).
+#define FLUXO_CANAL 0xffffffffu
+
+/// Fluxo do gerador por contador usado pelos bits transmitidos na simulação de Monte Carlo.
+#define FLUXO_DADOS 0xfffffffeu
+
+/// Número de símbolos processados de cada vez por realização na simulação de Monte Carlo.
+#define SIMULACAO_TRECHO 8192
+
+/// Memória máxima do cache de decomposições de cada thread da simulação de Monte Carlo.
+#define SIMULACAO_CACHE_BYTES (1 << 20)
+
+/// Senoides por eixo de cada entrada do canal com Doppler na simulação de Monte Carlo.
+#define SIMULACAO_SENOIDES_DOPPLER 16
+
+/// Semente do canal e do ruído.
+static uint64_t ruido_semente = RUIDO_SEMENTE_PADRAO;
 
 /// Lê os índices dos dados a serem transmitidos a partir de um arquivo.
 
+/// Os bytes do arquivo já são os índices empacotados (QAM_BITS bits por símbolo, ver
+/// indices_qam.h). O arquivo é mapeado em memória e o ponteiro devolvido aponta para o
+/// próprio mapeamento, sem cópia; ele vale até arquivo_entrada_fecha(entrada). Arquivos
+/// maiores que ENTRADA_PADRAO_MAXIMA são recusados, indicando o modo --streaming.
+
 /// @param filename o nome do arquivo
-/// @param size um ponteiro para armazenar o tamanho do array
-/// @return um ponteiro para o array de inteiros lidos do arquivo
+/// @param size um ponteiro para armazenar o número de símbolos
+/// @param entrada recebe o arquivo aberto, a ser fechado pelo chamador
+/// @return um ponteiro para os índices empacotados lidos do arquivo
 
-int *tx_data_read(char *filename, int *size) {
-    FILE *file = fopen(filename, "r");
-    if (file == NULL) {
+const uint8_t *tx_data_read(char *filename, int *size, arquivo_entrada *entrada) {
+    if (arquivo_entrada_abre(entrada, filename) != 0) {
         printf("Erro ao abrir o arquivo %s\n", filename);
         exit(1);
     }
-    fseek(file, 0, SEEK_END);
-    long file_size = ftell(file);
-    rewind(file);
-    char *buffer = (char*) malloc(sizeof(char) * file_size);
-    fread(buffer, 1, file_size, file);
-    fclose(file);
-
-    int *result = (int*) malloc(sizeof(int) * file_size * 4);
-    for (int i = 0; i < file_size; i++) {
-        for (int j = 3; j >= 0; j--) {
-            result[i * 4 + (3 - j)] = (buffer[i] >> (j * 2)) & 0b11;
-        }
+    if (entrada->tamanho > ENTRADA_PADRAO_MAXIMA) {
+        printf("Arquivo %s grande demais para o modo padrão (%zu bytes, máximo %zu); use --streaming\n",
+               filename, entrada->tamanho, ENTRADA_PADRAO_MAXIMA);
+        arquivo_entrada_fecha(entrada);
+        exit(1);
     }
-    free(buffer);
-    *size = file_size * 4;
-    return result;
+    *size = (int) (entrada->tamanho * 8 / QAM_BITS);
+    return entrada->dados;
 }
 
 
@@ -59,16 +110,42 @@ double complex *tx_data_padding(double complex *data, int size, int num_streams,
 
 /// Realiza o mapeamento dos índices para símbolos QAM.
 
-/// @param tx_indices um ponteiro para o array de índices
-/// @param size o tamanho do array de índices
+/// @param tx_indices os índices empacotados
+/// @param size o número de símbolos
 /// @return um ponteiro para o array de símbolos QAM
 
-double complex *QAMmapper(int *tx_indices, int size) {
+double complex *QAMmapper(const uint8_t *tx_indices, int size) {
     double complex mapping[] = { -1 + 1*I, -1 - 1*I, 1 + 1*I, 1 - 1*I };
     double complex *result = malloc(sizeof(double complex) * size);
-    for (int i = 0; i < size; i++) {
-        result[i] = mapping[tx_indices[i]];
+    uint8_t indices[QAM_TRECHO];
+    for (int i = 0; i < size; i += QAM_TRECHO) {
+        int n = size - i < QAM_TRECHO ? size - i : QAM_TRECHO;
+        indices_desempacota(tx_indices + (long) i * QAM_BITS / 8, QAM_BITS, n, indices);
+        for (int j = 0; j < n; j++) {
+            result[i + j] = mapping[indices[j]];
+        }
+    }
+    return result;
+}
+
+/// Realiza o mapeamento dos bits empacotados para símbolos de uma constelação M-QAM quadrada.
+
+/// Os símbolos têm código de Gray e energia média unitária (ver modulacao_qam.h); cada
+/// símbolo consome log2(M) bits da entrada.
+
+/// @param tx_bits os bits empacotados
+/// @param size o número de símbolos
+/// @param M o número de pontos da constelação (4, 16, 64, 256 ou 1024)
+/// @return um ponteiro para o array de símbolos QAM
+
+double complex *QAMmapper_M(const uint8_t *tx_bits, int size, int M) {
+    const modulacao_qam *mod = modulacao_qam_obtem(M);
+    if (mod == NULL) {
+        printf("Constelação %d-QAM não suportada\n", M);
+        exit(1);
     }
+    double complex *result = malloc(sizeof(double complex) * size);
+    qam_mapeia(mod, tx_bits, size, (double*) result);
     return result;
 }
 
@@ -90,21 +167,52 @@ double complex **tx_layer_mapper(double complex *data, int size, int num_streams
     return result;
 }
 
-/// Gera uma matriz de canal aleatória.
+/// Gera uma matriz de canal aleatória (a realização 0).
 
 /// @param Nr o número de receptores
 /// @param Nt o número de transmissores
 /// @return um ponteiro para a matriz de canal gerada
 
 double **channel_gen(int Nr, int Nt) {
+    return channel_gen_realizacao(Nr, Nt, 0);
+}
+
+/// Gera a matriz de canal de uma realização, com entradas uniformes em [-1, 1).
+
+/// A entrada (i, j) é a palavra i * Nt + j do fluxo FLUXO_CANAL da realização, então
+/// cada realização pode ser gerada isoladamente, em qualquer ordem.
+
+/// @param Nr o número de receptores
+/// @param Nt o número de transmissores
+/// @param realizacao o índice da realização
+/// @return um ponteiro para a matriz de canal gerada
+
+double **channel_gen_realizacao(int Nr, int Nt, uint32_t realizacao) {
     double **H = malloc(sizeof(double*) * Nr);
     for (int i = 0; i < Nr; i++) {
         H[i] = malloc(sizeof(double) * Nt);
+    }
+    channel_gen_realizacao_em(Nr, Nt, realizacao, H);
+    return H;
+}
+
+/// Gera a matriz de canal de uma realização em uma matriz já alocada pelo chamador.
+
+/// @param Nr o número de receptores
+/// @param Nt o número de transmissores
+/// @param realizacao o índice da realização
+/// @param H a matriz de saída (Nr x Nt)
+
+void channel_gen_realizacao_em(int Nr, int Nt, uint32_t realizacao, double **H) {
+    ruido_fluxo fluxo = { ruido_semente, realizacao, FLUXO_CANAL };
+
+    for (int i = 0; i < Nr; i++) {
         for (int j = 0; j < Nt; j++) {
-            H[i][j] = ((double) rand() / RAND_MAX) * 2.0 - 1.0;
+            uint64_t palavra;
+            ruido_fluxo_uniforme(&fluxo, (uint64_t) i * Nt + j, &palavra, 1);
+            H[i][j] = (palavra >> 11) * 0x1p-53 * 2.0 - 1.0;
         }
     }
-    return H;
 }
 
 /// Transpõe a matriz de canal.
@@ -125,8 +233,59 @@ double **matrix_transpose(double **H, int Nr, int Nt) {
     return Ht;
 }
 
+/// Ruído de transmite: o receptor i usa o fluxo i da realização, a partir do símbolo deslocamento.
+
+typedef struct {
+    uint32_t realizacao;
+    uint64_t deslocamento;
+    double media;
+    double desvio;
+} ruido_transmissao;
+
+/// Gera o ruído dos símbolos inicio a inicio + n - 1 do receptor linha (parcela de zgemm_streams_soma).
+
+static void ruido_trecho(void *ctx, int linha, long inicio, long n, double *z) {
+    const ruido_transmissao *r = ctx;
+    ruido_fluxo fluxo = { ruido_semente, r->realizacao, (uint32_t) linha };
+    ruido_fluxo_gaussiano(&fluxo, 2 * (r->deslocamento + inicio), z, 2 * n, r->media, r->desvio);
+}
+
+/// Aplica o canal e soma o ruído gaussiano de média media e desvio padrão desvio em cada eixo.
+
+/// Y = H X + ruído é um único produto em blocos (zgemm_streams_soma): o ruído de cada
+/// trecho é gerado logo antes da gravação e somado aos acumuladores, e cada stream
+/// recebido é escrito uma só vez. Como as amostras do gerador por contador dependem só da
+/// posição, o ruído é o mesmo de uma geração do stream inteiro. h é a matriz de canal já
+/// no formato contíguo complexo (ver coeficientes_canal), montada uma vez por canal.
+
+static void transmite(double complex **data, long len, const double *h, int Nr, int Nt, double media, double desvio, uint32_t realizacao, uint64_t deslocamento, double complex **result) {
+    ruido_transmissao ruido = { realizacao, deslocamento, media, desvio };
+    zgemm_streams_soma(Nr, Nt, h, Nt, (const double *const *) data, (double *const *) result, len, ruido_trecho, &ruido);
+}
+
+/// Monta a matriz de canal no formato contíguo complexo usado pela transmissão.
+
+/// Feito uma vez por canal, dá a matriz de channel_transmission_matriz_em e de
+/// channel_transmission_snr_matriz_em.
+
+/// @param H a matriz de canal (Nr x Nt)
+/// @param Nr o número de receptores
+/// @param Nt o número de transmissores
+/// @param h a matriz de saída (Nr x Nt, complexa, intercalada, por linhas)
+
+void coeficientes_canal(double **H, int Nr, int Nt, double *h) {
+    for (int i = 0; i < Nr; i++) {
+        for (int k = 0; k < Nt; k++) {
+            h[2 * (i * Nt + k)] = H[i][k];
+            h[2 * (i * Nt + k) + 1] = 0;
+        }
+    }
+}
+
 /// Realiza a transmissão dos dados pelo canal, adicionando ruído.
 
+/// O produto H x e a soma do ruído são feitos juntos, em blocos (ver transmite).
+
 /// @param data um ponteiro para o array de dados
 /// @param size o tamanho do array de dados
 /// @param num_streams o número de streams
@@ -141,21 +300,225 @@ double complex **channel_transmission(double complex **data, int size, int num_s
     double complex **result = malloc(sizeof(double complex*) * Nr);
     for (int i = 0; i < Nr; i++) {
         result[i] = malloc(sizeof(double complex) * size / num_streams);
-        for (int j = 0; j < size / num_streams; j++) {
-            result[i][j] = 0;
-            for (int k = 0; k < Nt; k++) {
-                result[i][j] += data[k][j] * H[i][k];
-            }
-            double ruido_real = ((double) rand() / RAND_MAX) * (ruido_max - ruido_min) + ruido_min;
-            double ruido_imaginary = ((double) rand() / RAND_MAX) * (ruido_max - ruido_min) + ruido_min;
-            result[i][j] += ruido_real + ruido_imaginary*I;
-        }
+    }
+    channel_transmission_em(data, size / num_streams, H, Nr, Nt, ruido_min, ruido_max, 0, 0, result);
+    return result;
+}
+
+/// Realiza a transmissão dos dados pelo canal com ruído calibrado por uma SNR (ver channel_transmission_snr_em).
+
+/// @param data um ponteiro para o array de dados
+/// @param size o tamanho do array de dados
+/// @param num_streams o número de streams
+/// @param H a matriz de canal
+/// @param Nr o número de receptores
+/// @param Nt o número de transmissores
+/// @param snr_db a SNR em dB
+/// @param snr_tipo SNR_ES_N0 ou SNR_EB_N0
+/// @param M o número de pontos da constelação
+/// @param N0 recebe a variância do ruído complexo usada (pode ser NULL)
+/// @return um ponteiro para o array de dados transmitidos
+
+double complex **channel_transmission_snr(double complex **data, int size, int num_streams, double **H, int Nr, int Nt, double snr_db, int snr_tipo, int M, double *N0) {
+    double complex **result = malloc(sizeof(double complex*) * Nr);
+    for (int i = 0; i < Nr; i++) {
+        result[i] = malloc(sizeof(double complex) * size / num_streams);
+    }
+    double n0 = channel_transmission_snr_em(data, size / num_streams, H, Nr, Nt, snr_db, snr_tipo, M, num_streams, 0, 0, result);
+    if (N0 != NULL) {
+        *N0 = n0;
     }
     return result;
 }
 
+/// Realiza a transmissão dos dados pelo canal em streams já alocados pelo chamador.
+
+/// O ruído é gaussiano, independente em cada eixo, com a média e a variância da
+/// distribuição uniforme em [ruido_min, ruido_max]; o bloco de ruído de cada receptor é
+/// gerado e somado de uma vez. O ruído do símbolo j do receptor i vem das posições
+/// 2 (deslocamento + j) e 2 (deslocamento + j) + 1 do fluxo i da realização, então um
+/// bloco qualquer pode ser transmitido isoladamente (em qualquer thread) com o mesmo
+/// resultado da transmissão sequencial de todos os blocos.
+
+/// @param data os Nt streams transmitidos
+/// @param len o número de símbolos de cada stream
+/// @param H a matriz de canal
+/// @param Nr o número de receptores
+/// @param Nt o número de transmissores
+/// @param ruido_min o valor mínimo do ruído
+/// @param ruido_max o valor máximo do ruído
+/// @param realizacao o índice da realização (do canal e do ruído)
+/// @param deslocamento a posição do primeiro símbolo do bloco em cada stream
+/// @param result os Nr streams recebidos (alocados pelo chamador)
+
+void channel_transmission_em(double complex **data, long len, double **H, int Nr, int Nt, double ruido_min, double ruido_max, uint32_t realizacao, uint64_t deslocamento, double complex **result) {
+    double *h = malloc(sizeof(double) * 2 * Nr * Nt);
+    coeficientes_canal(H, Nr, Nt, h);
+    channel_transmission_matriz_em(data, len, h, Nr, Nt, ruido_min, ruido_max, realizacao, deslocamento, result);
+    free(h);
+}
+
+/// Realiza a transmissão dos dados pelo canal com a matriz de canal já montada (ver coeficientes_canal).
+
+/// Mesmo resultado de channel_transmission_em, sem montar a matriz a cada bloco.
+
+/// @param data os Nt streams transmitidos
+/// @param len o número de símbolos de cada stream
+/// @param h a matriz de canal (Nr x Nt, complexa, intercalada, por linhas)
+/// @param Nr o número de receptores
+/// @param Nt o número de transmissores
+/// @param ruido_min o valor mínimo do ruído
+/// @param ruido_max o valor máximo do ruído
+/// @param realizacao o índice da realização (do canal e do ruído)
+/// @param deslocamento a posição do primeiro símbolo do bloco em cada stream
+/// @param result os Nr streams recebidos (alocados pelo chamador)
+
+void channel_transmission_matriz_em(double complex **data, long len, const double *h, int Nr, int Nt, double ruido_min, double ruido_max, uint32_t realizacao, uint64_t deslocamento, double complex **result) {
+    transmite(data, len, h, Nr, Nt, (ruido_min + ruido_max) / 2, (ruido_max - ruido_min) / sqrt(12), realizacao, deslocamento, result);
+}
+
+/// Realiza a transmissão dos dados pelo canal com ruído gaussiano branco calibrado por uma SNR.
+
+/// A densidade do ruído é calculada a partir da potência efetivamente transmitida no
+/// bloco (soma de |x|^2 nas Nt antenas, média por símbolo): Es é essa potência dividida
+/// pelo número de streams e Eb = Es / log2(M). O ruído complexo de cada receptor tem
+/// variância N0 = Es / 10^(SNR/10) (ou Eb / 10^(SNR/10) para SNR_EB_N0), metade em cada
+/// eixo. A SNR é medida na entrada do canal, antes do ganho de H.
+
+/// @param data os Nt streams transmitidos
+/// @param len o número de símbolos de cada stream
+/// @param H a matriz de canal
+/// @param Nr o número de receptores
+/// @param Nt o número de transmissores
+/// @param snr_db a SNR em dB
+/// @param snr_tipo SNR_ES_N0 ou SNR_EB_N0
+/// @param M o número de pontos da constelação
+/// @param num_streams o número de streams de dados
+/// @param realizacao o índice da realização (do canal e do ruído)
+/// @param deslocamento a posição do primeiro símbolo do bloco em cada stream
+/// @param result os Nr streams recebidos (alocados pelo chamador)
+/// @return a variância N0 do ruído complexo usada
+
+double channel_transmission_snr_em(double complex **data, long len, double **H, int Nr, int Nt, double snr_db, int snr_tipo, int M, int num_streams, uint32_t realizacao, uint64_t deslocamento, double complex **result) {
+    double *h = malloc(sizeof(double) * 2 * Nr * Nt);
+    coeficientes_canal(H, Nr, Nt, h);
+    double N0 = channel_transmission_snr_matriz_em(data, len, h, Nr, Nt, snr_db, snr_tipo, M, num_streams, realizacao, deslocamento, result);
+    free(h);
+    return N0;
+}
+
+/// Realiza a transmissão calibrada por uma SNR com a matriz de canal já montada (ver coeficientes_canal).
+
+/// @param data os Nt streams transmitidos
+/// @param len o número de símbolos de cada stream
+/// @param h a matriz de canal (Nr x Nt, complexa, intercalada, por linhas)
+/// @param Nr o número de receptores
+/// @param Nt o número de transmissores
+/// @param snr_db a SNR em dB
+/// @param snr_tipo SNR_ES_N0 ou SNR_EB_N0
+/// @param M o número de pontos da constelação
+/// @param num_streams o número de streams de dados
+/// @param realizacao o índice da realização (do canal e do ruído)
+/// @param deslocamento a posição do primeiro símbolo do bloco em cada stream
+/// @param result os Nr streams recebidos (alocados pelo chamador)
+/// @return a variância N0 do ruído complexo usada
+
+double channel_transmission_snr_matriz_em(double complex **data, long len, const double *h, int Nr, int Nt, double snr_db, int snr_tipo, int M, int num_streams, uint32_t realizacao, uint64_t deslocamento, double complex **result) {
+    double N0 = ruido_n0_snr(data, len, Nt, snr_db, snr_tipo, M, num_streams);
+
+    transmite(data, len, h, Nr, Nt, 0, sqrt(N0 / 2), realizacao, deslocamento, result);
+    return N0;
+}
+
+/// Variância do ruído complexo que dá a SNR pedida para um bloco de dados transmitidos.
+
+/// @param data os Nt streams transmitidos
+/// @param len o número de símbolos de cada stream
+/// @param Nt o número de transmissores
+/// @param snr_db a SNR em dB
+/// @param snr_tipo SNR_ES_N0 ou SNR_EB_N0
+/// @param M o número de pontos da constelação
+/// @param num_streams o número de streams de dados
+/// @return N0 (E|ruído|^2 em cada receptor), ou 0 se o bloco estiver vazio
+
+double ruido_n0_snr(double complex **data, long len, int Nt, double snr_db, int snr_tipo, int M, int num_streams) {
+    if (len <= 0) {
+        return 0;
+    }
+    double conjugado[2 * ZVET_TRECHO];
+    double energia[2] = {0, 0};
+    for (int k = 0; k < Nt; k++) {
+        const double *x = (const double*) data[k];
+        for (long j = 0; j < len; j += ZVET_TRECHO) {
+            size_t n = len - j < ZVET_TRECHO ? (size_t) (len - j) : ZVET_TRECHO;
+            zvet_conjugada(x + 2 * j, conjugado, n);
+            zvet_mac(x + 2 * j, conjugado, energia, n);
+        }
+    }
+    double Es = energia[0] / len / num_streams;
+    double E = snr_tipo == SNR_EB_N0 ? Es / log2(M) : Es;
+    return E / pow(10, snr_db / 10);
+}
+
+/// Define a semente do canal e do ruído.
+
+/// @param semente a semente
+
+void ruido_canal_semente(uint64_t semente) {
+    ruido_semente = semente;
+}
+
+/// Realiza a decomposição em valores singulares (SVD) da matriz de canal usando um contexto já criado.
+
+/// O contexto (svd_contexto_aloca(Nr, Nt)) guarda toda a memória de trabalho, então a
+/// decomposição não faz nenhuma alocação e o mesmo contexto serve para todas as
+/// realizações de canal com essas dimensões. Como H é real, U e V também são. O caso
+/// 2x2 usa a forma fechada real de dsvd_2x2.
+
+/// @param ctx o contexto de SVD, com as dimensões de H
+/// @param H a matriz a ser decomposta
+/// @param U um ponteiro para a matriz U resultante (Nr x min(Nr, Nt))
+/// @param S um ponteiro para o vetor S resultante (min(Nr, Nt) posições)
+/// @param V um ponteiro para a matriz V resultante (Nt x min(Nr, Nt))
+
+void svd_com_contexto(svd_contexto *ctx, double **H, double **U, double *S, double **V) {
+    int Nr = ctx->linhas, Nt = ctx->colunas, k = ctx->k;
+    if (Nr == 2 && Nt == 2) {
+        double h[4] = { H[0][0], H[0][1], H[1][0], H[1][1] };
+        double u[4], v[4];
+        dsvd_2x2(h, 2, u, 2, S, v, 2);
+        U[0][0] = u[0]; U[0][1] = u[1]; U[1][0] = u[2]; U[1][1] = u[3];
+        V[0][0] = v[0]; V[0][1] = v[1]; V[1][0] = v[2]; V[1][1] = v[3];
+        return;
+    }
+    for (int i = 0; i < Nr; i++) {
+        for (int j = 0; j < Nt; j++) {
+            ctx->entrada[2 * (i * Nt + j)] = H[i][j];
+            ctx->entrada[2 * (i * Nt + j) + 1] = 0;
+        }
+    }
+
+    svd_contexto_calcula(ctx, ctx->entrada, Nt);
+
+    for (int i = 0; i < Nr; i++) {
+        for (int j = 0; j < k; j++) {
+            U[i][j] = ctx->u[2 * (i * k + j)];
+        }
+    }
+    for (int i = 0; i < k; i++) {
+        S[i] = ctx->s[i];
+    }
+    for (int i = 0; i < Nt; i++) {
+        for (int j = 0; j < k; j++) {
+            V[i][j] = ctx->v[2 * (i * k + j)];
+        }
+    }
+}
+
 /// Realiza a decomposição em valores singulares (SVD) da matriz transposta de canal.
 
+/// Cria e destrói um contexto a cada chamada; para decomposições repetidas use svd_com_contexto.
+
 /// @param H a matriz a ser decomposta
 /// @param Nr o número de receptores
 /// @param Nt o número de transmissores
@@ -164,35 +527,73 @@ double complex **channel_transmission(double complex **data, int size, int num_s
 /// @param V um ponteiro para a matriz V resultante
 
 void svd(double **H, int Nr, int Nt, double **U, double *S, double **V) {
-    gsl_matrix *H_gsl = gsl_matrix_alloc(Nr, Nt);
+    svd_contexto ctx = svd_contexto_aloca(Nr, Nt);
+    svd_com_contexto(&ctx, H, U, S, V);
+    svd_contexto_libera(&ctx);
+}
+
+/// Realiza a decomposição em valores singulares (SVD) de uma matriz de canal complexa usando um contexto já criado.
+
+/// A decomposição H = U diag(S) V^H é feita diretamente sobre os números complexos
+/// (Jacobi unilateral, ver svd_complexa.h), sem a matriz real equivalente 2Nr x 2Nt,
+/// e sem alocar memória.
+
+/// @param ctx o contexto de SVD, com as dimensões de H
+/// @param H a matriz a ser decomposta
+/// @param U um ponteiro para a matriz U resultante (Nr x min(Nr, Nt))
+/// @param S um ponteiro para o vetor S resultante (min(Nr, Nt) posições)
+/// @param V um ponteiro para a matriz V resultante (Nt x min(Nr, Nt))
+
+void svd_complexa_com_contexto(svd_contexto *ctx, double complex **H, double complex **U, double *S, double complex **V) {
+    int Nr = ctx->linhas, Nt = ctx->colunas, k = ctx->k;
+    double complex *h = (double complex*) ctx->entrada;
+    double complex *u = (double complex*) ctx->u;
+    double complex *v = (double complex*) ctx->v;
+
     for (int i = 0; i < Nr; i++) {
         for (int j = 0; j < Nt; j++) {
-            gsl_matrix_set(H_gsl, i, j, H[i][j]);
+            h[i * Nt + j] = H[i][j];
         }
     }
 
-    gsl_matrix *V_gsl = gsl_matrix_alloc(Nt, Nt);
-    gsl_vector *S_gsl = gsl_vector_alloc(Nt);
-    gsl_vector *work = gsl_vector_alloc(Nt);
-
-    gsl_linalg_SV_decomp(H_gsl, V_gsl, S_gsl, work);
+    svd_contexto_calcula(ctx, ctx->entrada, Nt);
 
     for (int i = 0; i < Nr; i++) {
-        for (int j = 0; j < Nt; j++) {
-            U[i][j] = gsl_matrix_get(H_gsl, i, j);
+        for (int j = 0; j < k; j++) {
+            U[i][j] = u[i * k + j];
         }
     }
-
+    for (int i = 0; i < k; i++) {
+        S[i] = ctx->s[i];
+    }
     for (int i = 0; i < Nt; i++) {
-        S[i] = gsl_vector_get(S_gsl, i);
-        for (int j = 0; j < Nt; j++) {
-            V[i][j] = gsl_matrix_get(V_gsl, i, j);
+        for (int j = 0; j < k; j++) {
+            V[i][j] = v[i * k + j];
         }
     }
 }
 
+/// Realiza a decomposição em valores singulares (SVD) de uma matriz de canal complexa.
+
+/// Cria e destrói um contexto a cada chamada; para decomposições repetidas use svd_complexa_com_contexto.
+
+/// @param H a matriz a ser decomposta
+/// @param Nr o número de receptores
+/// @param Nt o número de transmissores
+/// @param U um ponteiro para a matriz U resultante (Nr x min(Nr, Nt))
+/// @param S um ponteiro para o vetor S resultante (min(Nr, Nt) posições)
+/// @param V um ponteiro para a matriz V resultante (Nt x min(Nr, Nt))
+
+void svd_complexa(double complex **H, int Nr, int Nt, double complex **U, double *S, double complex **V) {
+    svd_contexto ctx = svd_contexto_aloca(Nr, Nt);
+    svd_complexa_com_contexto(&ctx, H, U, S, V);
+    svd_contexto_libera(&ctx);
+}
+
 /// Pré-codifica os dados utilizando a matriz V resultante da decomposição SVD.
 
+/// O produto V^H x é feito por zgemm_streams (ver tx_precoder_matriz_em).
+
 /// @param data um ponteiro para o array de dados
 /// @param size o tamanho do array de dados
 /// @param num_streams o número de streams
@@ -203,18 +604,65 @@ double complex **tx_precoder(double complex **data, int size, int num_streams, d
     double complex **result = malloc(sizeof(double complex*) * num_streams);
     for (int i = 0; i < num_streams; i++) {
         result[i] = malloc(sizeof(double complex) * size / num_streams);
-        for (int j = 0; j < size / num_streams; j++) {
-            result[i][j] = 0;
-            for (int k = 0; k < num_streams; k++) {
-                result[i][j] += conj(V[k][i]) * data[k][j];
-            }
-        }
     }
+    tx_precoder_em(data, size / num_streams, num_streams, V, result);
     return result;
 }
 
+/// Pré-codifica os dados em streams já alocados pelo chamador.
+
+/// @param data os streams de entrada
+/// @param len o número de símbolos de cada stream
+/// @param num_streams o número de streams
+/// @param V a matriz V da decomposição SVD
+/// @param result os streams de saída (alocados pelo chamador)
+
+void tx_precoder_em(double complex **data, long len, int num_streams, double **V, double complex **result) {
+    double *w = malloc(sizeof(double) * 2 * num_streams * num_streams);
+    coeficientes_hermitiana(V, num_streams, num_streams, w);
+    tx_precoder_matriz_em(data, len, num_streams, w, result);
+    free(w);
+}
+
+/// Monta a conjugada transposta de uma matriz real no formato contíguo complexo.
+
+/// Feito uma vez por canal, dá a matriz de coeficientes de tx_precoder_matriz_em (com V)
+/// e de rx_combiner_matriz_em (com U).
+
+/// @param A a matriz (linhas x colunas)
+/// @param linhas o número de linhas de A
+/// @param colunas o número de colunas de A
+/// @param w a matriz de saída A^H (colunas x linhas, 2 * linhas * colunas posições)
+
+void coeficientes_hermitiana(double **A, int linhas, int colunas, double *w) {
+    for (int i = 0; i < colunas; i++) {
+        for (int k = 0; k < linhas; k++) {
+            w[2 * (i * linhas + k)] = A[k][i];
+            w[2 * (i * linhas + k) + 1] = 0;
+        }
+    }
+}
+
+/// Pré-codifica os dados com a matriz de coeficientes já montada.
+
+/// Os streams são vistos como uma matriz num_streams x len e o pré-codificador como o
+/// produto W x, feito em blocos de símbolos pelo kernel SIMD de zgemm_streams, direto nos
+/// streams de saída.
+
+/// @param data os streams de entrada
+/// @param len o número de símbolos de cada stream
+/// @param num_streams o número de streams
+/// @param w a matriz W = V^H (num_streams x num_streams, complexa, intercalada, por linhas)
+/// @param result os streams de saída (alocados pelo chamador, distintos de data)
+
+void tx_precoder_matriz_em(double complex **data, long len, int num_streams, const double *w, double complex **result) {
+    zgemm_streams(num_streams, num_streams, w, num_streams, (const double *const *) data, (double *const *) result, len, 0);
+}
+
 /// Combina os dados recebidos utilizando a matriz U resultante da decomposição SVD.
 
+/// O produto U^H y é feito por zgemm_streams (ver rx_combiner_matriz_em).
+
 /// @param data um ponteiro para o array de dados
 /// @param size o tamanho do array de dados
 /// @param num_streams o número de streams
@@ -225,16 +673,38 @@ double complex **rx_combiner(double complex **data, int size, int num_streams, d
     double complex **result = malloc(sizeof(double complex*) * num_streams);
     for (int i = 0; i < num_streams; i++) {
         result[i] = malloc(sizeof(double complex) * size / num_streams);
-        for (int j = 0; j < size / num_streams; j++) {
-            result[i][j] = 0;
-            for (int k = 0; k < num_streams; k++) {
-                result[i][j] += conj(U[k][i]) * data[k][j];
-            }
-        }
     }
+    rx_combiner_em(data, size / num_streams, num_streams, U, result);
     return result;
 }
 
+/// Combina os dados recebidos em streams já alocados pelo chamador.
+
+/// @param data os streams de entrada
+/// @param len o número de símbolos de cada stream
+/// @param num_streams o número de streams
+/// @param U a matriz U da decomposição SVD
+/// @param result os streams de saída (alocados pelo chamador)
+
+void rx_combiner_em(double complex **data, long len, int num_streams, double **U, double complex **result) {
+    double *w = malloc(sizeof(double) * 2 * num_streams * num_streams);
+    coeficientes_hermitiana(U, num_streams, num_streams, w);
+    rx_combiner_matriz_em(data, len, num_streams, w, result);
+    free(w);
+}
+
+/// Combina os dados recebidos com a matriz de coeficientes já montada (W = U^H).
+
+/// @param data os streams de entrada
+/// @param len o número de símbolos de cada stream
+/// @param num_streams o número de streams
+/// @param w a matriz W = U^H (num_streams x num_streams, complexa, intercalada, por linhas)
+/// @param result os streams de saída (alocados pelo chamador, distintos de data)
+
+void rx_combiner_matriz_em(double complex **data, long len, int num_streams, const double *w, double complex **result) {
+    zgemm_streams(num_streams, num_streams, w, num_streams, (const double *const *) data, (double *const *) result, len, 0);
+}
+
 /// Realiza o demapeamento em camada dos dados.
 
 /// @param data um ponteiro para o array de dados
@@ -252,6 +722,8 @@ double complex *rx_layer_demapper(double complex **data, int size, int num_strea
 
 /// Realiza a equalização dos dados recebidos.
 
+/// Para 2, 4 ou 8 streams usa o kernel especializado escolhido por mimo_escolhe_feq.
+
 /// @param data um ponteiro para o array de dados
 /// @param size o tamanho do array de dados
 /// @param num_streams o número de streams
@@ -262,34 +734,91 @@ double complex **rx_feq(double complex **data, int size, int num_streams, double
     double complex **result = malloc(sizeof(double complex*) * num_streams);
     for (int i = 0; i < num_streams; i++) {
         result[i] = malloc(sizeof(double complex) * size / num_streams);
-        for (int j = 0; j < size / num_streams; j++) {
-            result[i][j] = data[i][j] / S[i];
-        }
     }
+    rx_feq_em(data, size / num_streams, num_streams, S, result);
     return result;
 }
 
+/// Realiza a equalização dos dados recebidos em streams já alocados pelo chamador.
+
+/// @param data os streams de entrada
+/// @param len o número de símbolos de cada stream
+/// @param num_streams o número de streams
+/// @param S o vetor S da decomposição SVD
+/// @param result os streams equalizados (alocados pelo chamador; podem ser os próprios data)
+
+void rx_feq_em(double complex **data, long len, int num_streams, double *S, double complex **result) {
+    double inv_S_pilha[MIMO_KERNEL_MAX];
+    double *inv_S = num_streams <= MIMO_KERNEL_MAX ? inv_S_pilha : malloc(sizeof(double) * num_streams);
+    for (int i = 0; i < num_streams; i++) {
+        inv_S[i] = 1 / S[i];
+    }
+    rx_feq_inverso_em(data, len, num_streams, inv_S, result);
+    if (inv_S != inv_S_pilha) {
+        free(inv_S);
+    }
+}
+
+/// Realiza a equalização com os inversos dos valores singulares já calculados.
+
+/// Com 1 / S calculado uma vez por canal (como no cache de decomposições), cada símbolo
+/// custa só multiplicações. Para 2, 4 ou 8 streams usa o kernel de mimo_escolhe_feq; os
+/// demais números de streams usam zvet_axpy por trechos.
+
+/// @param data os streams de entrada
+/// @param len o número de símbolos de cada stream
+/// @param num_streams o número de streams
+/// @param inv_S os inversos dos valores singulares
+/// @param result os streams equalizados (alocados pelo chamador; podem ser os próprios data)
+
+void rx_feq_inverso_em(double complex **data, long len, int num_streams, const double *inv_S, double complex **result) {
+    mimo_kernel_equaliza kernel = mimo_escolhe_feq(num_streams);
+    if (kernel != NULL) {
+        kernel(inv_S, (const double *const *) data, (double *const *) result, len);
+        return;
+    }
+    double trecho[2 * ZVET_TRECHO];
+    for (int i = 0; i < num_streams; i++) {
+        const double alfa[2] = {inv_S[i], 0};
+        for (long j = 0; j < len; j += ZVET_TRECHO) {
+            size_t n = len - j < ZVET_TRECHO ? (size_t) (len - j) : ZVET_TRECHO;
+            memset(trecho, 0, sizeof(double) * 2 * n);
+            zvet_axpy(alfa, (const double*) (data[i] + j), trecho, n);
+            memcpy(result[i] + j, trecho, sizeof(double) * 2 * n);
+        }
+    }
+}
+
 /// Demapeia os símbolos QAM para obter os índices dos dados recebidos.
 
+/// A decisão de cada eixo é feita pelo sinal, em tempo constante (qam_demapeia); como só
+/// as fronteiras importam, a amplitude ±1 do QPSK de QAMmapper não precisa ser normalizada.
+
 /// @param data um ponteiro para o array de dados
 /// @param size o tamanho do array de dados
-/// @return um ponteiro para o array de índices demapeados
+/// @return um ponteiro para os índices demapeados, empacotados
 
-int *rx_qam_demapper(double complex *data, int size) {
-    double complex mapping[] = { -1 + 1*I, -1 - 1*I, 1 + 1*I, 1 - 1*I };
-    int *result = malloc(sizeof(int) * size);
-    for (int i = 0; i < size; i++) {
-        double min_distance = INFINITY;
-        int min_index = -1;
-        for (int j = 0; j < 4; j++) {
-            double distance = cabs(data[i] - mapping[j]);
-            if (distance < min_distance) {
-                min_distance = distance;
-                min_index = j;
-            }
-        }
-        result[i] = min_index;
+uint8_t *rx_qam_demapper(double complex *data, int size) {
+    uint8_t *result = malloc(indices_bytes(size, QAM_BITS));
+    qam_demapeia(modulacao_qam_obtem(4), (double*) data, size, result);
+    return result;
+}
+
+/// Demapeia (decisão abrupta) símbolos de uma constelação M-QAM quadrada de energia unitária.
+
+/// @param data os símbolos equalizados
+/// @param size o número de símbolos
+/// @param M o número de pontos da constelação (4, 16, 64, 256 ou 1024)
+/// @return um ponteiro para os bits demapeados, empacotados (log2(M) bits por símbolo)
+
+uint8_t *rx_qam_demapper_M(double complex *data, int size, int M) {
+    const modulacao_qam *mod = modulacao_qam_obtem(M);
+    if (mod == NULL) {
+        printf("Constelação %d-QAM não suportada\n", M);
+        exit(1);
     }
+    uint8_t *result = malloc(indices_bytes(size, mod->bits));
+    qam_demapeia(mod, (double*) data, size, result);
     return result;
 }
 
@@ -310,39 +839,676 @@ double complex *rx_data_depadding(double complex *data, int size, int num_stream
     return result;
 }
 
+/// Calcula as LLRs (max-log) dos bits recebidos, para uso por um decodificador de canal.
+
+/// Depois do combinador U^H (unitário) e da equalização por S_i, o ruído do stream i tem
+/// variância ruido_variancia / S_i^2, usada no cálculo das LLRs desse stream. As LLRs
+/// saem na ordem dos bits transmitidos (símbolo t = j * num_streams + i, log2(M) LLRs
+/// por símbolo); LLR positiva favorece o bit 0.
+
+/// @param data os streams equalizados (saída de rx_feq)
+/// @param len o número de símbolos de cada stream
+/// @param num_streams o número de streams
+/// @param S o vetor S da decomposição SVD
+/// @param ruido_variancia a variância do ruído complexo em cada receptor (E|ruído|^2)
+/// @param M o número de pontos da constelação (4, 16, 64, 256 ou 1024)
+/// @param llr o vetor de saída, com len * num_streams * log2(M) posições
+
+void rx_llr_demapper(double complex **data, long len, int num_streams, double *S, double ruido_variancia, int M, float *llr) {
+    const modulacao_qam *mod = modulacao_qam_obtem(M);
+    if (mod == NULL) {
+        printf("Constelação %d-QAM não suportada\n", M);
+        exit(1);
+    }
+    for (int i = 0; i < num_streams; i++) {
+        qam_llr(mod, (const double*) data[i], len, ruido_variancia / (S[i] * S[i]), llr + i * mod->bits, (long) num_streams * mod->bits);
+    }
+}
+
+/// Versão de rx_llr_demapper com LLRs quantizadas em int8 (multiplicadas por escala e saturadas em ±127).
+
+/// @param data os streams equalizados (saída de rx_feq)
+/// @param len o número de símbolos de cada stream
+/// @param num_streams o número de streams
+/// @param S o vetor S da decomposição SVD
+/// @param ruido_variancia a variância do ruído complexo em cada receptor (E|ruído|^2)
+/// @param M o número de pontos da constelação (4, 16, 64, 256 ou 1024)
+/// @param escala o fator de quantização
+/// @param llr o vetor de saída, com len * num_streams * log2(M) posições
+
+void rx_llr_demapper_int8(double complex **data, long len, int num_streams, double *S, double ruido_variancia, int M, double escala, int8_t *llr) {
+    const modulacao_qam *mod = modulacao_qam_obtem(M);
+    if (mod == NULL) {
+        printf("Constelação %d-QAM não suportada\n", M);
+        exit(1);
+    }
+    for (int i = 0; i < num_streams; i++) {
+        qam_llr_int8(mod, (const double*) data[i], len, ruido_variancia / (S[i] * S[i]), escala, llr + i * mod->bits, (long) num_streams * mod->bits);
+    }
+}
+
+/// Variância do ruído complexo gerado por channel_transmission (a de uma uniforme em [ruido_min, ruido_max] em cada eixo).
+
+/// @param ruido_min o valor mínimo do ruído
+/// @param ruido_max o valor máximo do ruído
+/// @return E|ruído|^2
+
+double ruido_variancia_uniforme(double ruido_min, double ruido_max) {
+    return 2 * (ruido_max - ruido_min) * (ruido_max - ruido_min) / 12;
+}
+
 /// Salva os índices dos dados recebidos em um arquivo.
 
-/// @param tx_indices um ponteiro para o array de índices
-/// @param size o tamanho do array de índices
+/// Como os índices já estão empacotados, o vetor inteiro é escrito em uma chamada. Se
+/// size * QAM_BITS não for múltiplo de 8, o último byte é escrito com os bits que
+/// sobram zerados.
+
+/// @param data os índices empacotados
+/// @param size o número de símbolos
 /// @param filename o nome do arquivo de saída
 
-void rx_data_write(int *data, int size, char *filename) {
-    FILE *file = fopen(filename, "wb");
-    if (file == NULL) {
+void rx_data_write(const uint8_t *data, int size, char *filename) {
+    arquivo_saida file;
+    if (arquivo_saida_abre(&file, filename, 0, 0) != 0) {
         printf("Erro ao abrir o arquivo %s\n", filename);
         exit(1);
     }
-    char byte = 0;
-    for (int i = 0; i < size; i++) {
-        byte |= data[i] << ((3 - (i % 4)) * 2);
-        if ((i + 1) % 4 == 0) {
-            fwrite(&byte, sizeof(char), 1, file);
-            byte = 0;
+    arquivo_saida_escreve(&file, data, indices_bytes(size, QAM_BITS));
+    if (arquivo_saida_fecha(&file) != 0) {
+        printf("Erro ao escrever o arquivo %s\n", filename);
+        exit(1);
+    }
+}
+
+/// Conta os símbolos recebidos com erro e imprime as estatísticas.
+
+/// @param tx_indices os índices transmitidos, empacotados
+/// @param rx_indices os índices recebidos, empacotados
+/// @param size o número de símbolos
+
+void gera_estatisticas(const uint8_t *tx_indices, const uint8_t *rx_indices, int size) {
+    gera_estatisticas_contagem(size, indices_diferencas(tx_indices, rx_indices, QAM_BITS, size));
+}
+
+/// Imprime as estatísticas de erro a partir das contagens já feitas.
+
+/// @param num_simbolos o número de símbolos QAM transmitidos
+/// @param num_errors o número de símbolos QAM recebidos com erro
+
+void gera_estatisticas_contagem(int64_t num_simbolos, int64_t num_errors) {
+    printf("Número de símbolos QAM transmitidos: %" PRId64 "\n", num_simbolos);
+    printf("Número de símbolos QAM recebidos com erro: %" PRId64 "\n", num_errors);
+    printf("Porcentagem de símbolos QAM recebidos com erro: %.2f %%\n", (double)num_errors / num_simbolos * 100);
+}
+
+/// Aloca num_streams vetores de len símbolos.
+
+static double complex **aloca_streams(int num_streams, long len) {
+    double complex **streams = malloc(sizeof(double complex*) * num_streams);
+    for (int i = 0; i < num_streams; i++) {
+        streams[i] = malloc(sizeof(double complex) * len);
+    }
+    return streams;
+}
+
+/// Libera os vetores criados por aloca_streams.
+
+static void libera_streams(double complex **streams, int num_streams) {
+    for (int i = 0; i < num_streams; i++) {
+        free(streams[i]);
+    }
+    free(streams);
+}
+
+/// Transmite um arquivo inteiro pela cadeia MIMO em blocos de tamanho fixo (modo streaming).
+
+/// Cada bloco de bytes passa por leitura, mapeamento M-QAM e em camadas, pré-codificação,
+/// canal, combinação, equalização, demapeamento e escrita, reaproveitando os mesmos
+/// buffers; a memória usada depende só do tamanho do bloco, não do arquivo. O último
+/// bloco é completado com símbolos nulos até um múltiplo de num_streams, e esses
+/// símbolos não são escritos. Supõe Nr = Nt = num_streams, como a cadeia de main.
+
+/// @param entrada o nome do arquivo de entrada
+/// @param saida o nome do arquivo de saída
+/// @param bloco o número de bytes da entrada por bloco (arredondado para baixo a um múltiplo de log2(M))
+/// @param M o número de pontos da constelação (4, 16, 64, 256 ou 1024)
+/// @param num_streams o número de streams
+/// @param H a matriz de canal
+/// @param Nr o número de receptores
+/// @param Nt o número de transmissores
+/// @param V a matriz V da decomposição SVD (pré-codificador)
+/// @param U a matriz U da decomposição SVD (combinador)
+/// @param S o vetor S da decomposição SVD (equalizador)
+/// @param ruido_min o valor mínimo do ruído
+/// @param ruido_max o valor máximo do ruído
+/// @param snr_tipo SNR_NENHUMA (ruído de ruido_min e ruido_max), SNR_ES_N0 ou SNR_EB_N0
+/// @param snr_db a SNR em dB, recalibrada em cada bloco pela potência transmitida
+/// @param saida_direta se diferente de zero, tenta escrever a saída com O_DIRECT
+/// @param num_simbolos recebe o número de símbolos transmitidos
+/// @param num_errors recebe o número de símbolos recebidos com erro
+
+void transmissao_streaming(char *entrada, char *saida, long bloco, int M, int num_streams, double **H, int Nr, int Nt, double **V, double **U, double *S, double ruido_min, double ruido_max, int snr_tipo, double snr_db, int saida_direta, int64_t *num_simbolos, int64_t *num_errors) {
+    const modulacao_qam *mod = modulacao_qam_obtem(M);
+    if (mod == NULL) {
+        printf("Constelação %d-QAM não suportada\n", M);
+        exit(1);
+    }
+    arquivo_entrada in;
+    if (arquivo_entrada_abre(&in, entrada) != 0) {
+        printf("Erro ao abrir o arquivo %s\n", entrada);
+        exit(1);
+    }
+    arquivo_saida out;
+    if (arquivo_saida_abre(&out, saida, ARQUIVO_SAIDA_BUFFER_PADRAO, saida_direta) != 0) {
+        printf("Erro ao abrir o arquivo %s\n", saida);
+        exit(1);
+    }
+
+    // Blocos de um número inteiro de grupos de 8 símbolos (mod->bits bytes cada).
+    long passo = bloco / mod->bits * mod->bits;
+    long max_simbolos = passo * 8 / mod->bits;
+    long max_len = (max_simbolos + num_streams - 1) / num_streams;
+    uint8_t *cauda = malloc(passo + 1);
+    double complex *simbolos_qam = malloc(sizeof(double complex) * max_simbolos);
+    double complex **layers = aloca_streams(num_streams, max_len);
+    double complex **precoded = aloca_streams(num_streams, max_len);
+    double complex **received = aloca_streams(Nr, max_len);
+    double complex **combined = aloca_streams(num_streams, max_len);
+    // H, V^H, U^H e 1 / S são montados uma vez para todos os blocos.
+    double *w_canal = malloc(sizeof(double) * 2 * Nr * Nt);
+    double *w_precoder = malloc(sizeof(double) * 2 * num_streams * num_streams);
+    double *w_combiner = malloc(sizeof(double) * 2 * num_streams * num_streams);
+    double *inv_S = malloc(sizeof(double) * num_streams);
+    coeficientes_canal(H, Nr, Nt, w_canal);
+    coeficientes_hermitiana(V, num_streams, num_streams, w_precoder);
+    coeficientes_hermitiana(U, num_streams, num_streams, w_combiner);
+    for (int i = 0; i < num_streams; i++) {
+        inv_S[i] = 1 / S[i];
+    }
+
+    *num_simbolos = 0;
+    *num_errors = 0;
+
+    for (size_t inicio = 0; inicio < in.tamanho; inicio += passo) {
+        const uint8_t *tx_bytes = in.dados + inicio;
+        size_t lidos = in.tamanho - inicio < (size_t) passo ? in.tamanho - inicio : (size_t) passo;
+        long simbolos = ((long) lidos * 8 + mod->bits - 1) / mod->bits;
+        long len = (simbolos + num_streams - 1) / num_streams;
+
+        // No fim do arquivo o último símbolo pode ficar incompleto: é completado com zeros.
+        if ((long) lidos * 8 % mod->bits != 0) {
+            memset(cauda, 0, indices_bytes(simbolos, mod->bits));
+            memcpy(cauda, tx_bytes, lidos);
+            tx_bytes = cauda;
+        }
+
+        qam_mapeia(mod, tx_bytes, simbolos, (double*) simbolos_qam);
+        for (long i = 0; i < len * num_streams; i++) {
+            layers[i % num_streams][i / num_streams] = i < simbolos ? simbolos_qam[i] : 0;
+        }
+
+        tx_precoder_matriz_em(layers, len, num_streams, w_precoder, precoded);
+        uint64_t deslocamento = (uint64_t) (inicio / passo) * max_len;
+        if (snr_tipo == SNR_NENHUMA) {
+            channel_transmission_matriz_em(precoded, len, w_canal, Nr, Nt, ruido_min, ruido_max, 0, deslocamento, received);
+        } else {
+            channel_transmission_snr_matriz_em(precoded, len, w_canal, Nr, Nt, snr_db, snr_tipo, M, num_streams, 0, deslocamento, received);
         }
+        rx_combiner_matriz_em(received, len, num_streams, w_combiner, combined);
+        rx_feq_inverso_em(combined, len, num_streams, inv_S, combined);
+
+        for (long i = 0; i < simbolos; i++) {
+            simbolos_qam[i] = combined[i % num_streams][i / num_streams];
+        }
+        uint8_t *rx_bytes = arquivo_saida_reserva(&out, indices_bytes(simbolos, mod->bits));
+        qam_demapeia(mod, (double*) simbolos_qam, simbolos, rx_bytes);
+        *num_errors += indices_diferencas(tx_bytes, rx_bytes, mod->bits, simbolos);
+        arquivo_saida_confirma(&out, lidos);
+        *num_simbolos += simbolos;
+        arquivo_entrada_descarta(&in, inicio + lidos);
     }
-    fclose(file);
+
+    arquivo_entrada_fecha(&in);
+    if (arquivo_saida_fecha(&out) != 0) {
+        printf("Erro ao escrever o arquivo %s\n", saida);
+        exit(1);
+    }
+    free(cauda);
+    free(simbolos_qam);
+    libera_streams(layers, num_streams);
+    libera_streams(precoded, num_streams);
+    libera_streams(received, Nr);
+    libera_streams(combined, num_streams);
+    free(w_canal);
+    free(w_precoder);
+    free(w_combiner);
+    free(inv_S);
 }
 
-void gera_estatisticas(int *tx_indices, int *rx_indices, int size) {
-    int num_errors = 0;
-    for (int i = 0; i < size; i++) {
-        if (tx_indices[i] != rx_indices[i]) {
-            num_errors++;
+/// Executa a cadeia em modo streaming: gera o canal, calcula a SVD e transmite o arquivo em blocos.
+
+/// @param entrada o nome do arquivo de entrada
+/// @param saida o nome do arquivo de saída
+/// @param M o número de pontos da constelação
+/// @param num_streams o número de streams
+/// @param Nr o número de receptores
+/// @param Nt o número de transmissores
+/// @param ruido_min o valor mínimo do ruído
+/// @param ruido_max o valor máximo do ruído
+/// @param snr_tipo SNR_NENHUMA, SNR_ES_N0 ou SNR_EB_N0
+/// @param snr_db a SNR em dB
+
+static void executa_streaming(char *entrada, char *saida, int M, int num_streams, int Nr, int Nt, double ruido_min, double ruido_max, int snr_tipo, double snr_db) {
+    double **H = channel_gen(Nr, Nt);
+    double **Ht = matrix_transpose(H, Nr, Nt);
+    double **Ut = malloc(sizeof(double*) * Nt);
+    for (int i = 0; i < Nt; i++) {
+        Ut[i] = malloc(sizeof(double) * Nr);
+    }
+    double *S = malloc(sizeof(double) * Nr);
+    double **Vt = malloc(sizeof(double*) * Nr);
+    for (int i = 0; i < Nr; i++) {
+        Vt[i] = malloc(sizeof(double) * Nr);
+    }
+
+    svd(Ht, Nt, Nr, Ut, S, Vt);
+
+    double **V = matrix_transpose(Vt, Nr, Nr);
+
+    int64_t num_simbolos, num_errors;
+    char *saida_direta = getenv("SAIDA_DIRETA");
+    transmissao_streaming(entrada, saida, STREAMING_BLOCO_PADRAO, M, num_streams, Ht, Nr, Nt, V, Ut, S, ruido_min, ruido_max, snr_tipo, snr_db,
+                          saida_direta != NULL && atoi(saida_direta) != 0, &num_simbolos, &num_errors);
+    gera_estatisticas_contagem(num_simbolos, num_errors);
+
+    for (int i = 0; i < Nr; i++) {
+        free(H[i]);
+        free(Vt[i]);
+    }
+    for (int i = 0; i < Nt; i++) {
+        free(Ht[i]);
+        free(Ut[i]);
+        free(V[i]);
+    }
+    free(H);
+    free(Vt);
+    free(Ht);
+    free(Ut);
+    free(V);
+    free(S);
+}
+
+/// Número de bits diferentes entre os primeiros num_bits bits (do mais significativo de cada byte) de a e b.
+
+static int64_t bits_diferentes(const uint8_t *a, const uint8_t *b, long num_bits) {
+    long bytes = num_bits / 8, i = 0;
+    int64_t total = 0;
+
+    for (; i + 8 <= bytes; i += 8) {
+        uint64_t x, y;
+        memcpy(&x, a + i, 8);
+        memcpy(&y, b + i, 8);
+        total += __builtin_popcountll(x ^ y);
+    }
+    for (; i < bytes; i++) {
+        total += __builtin_popcount(a[i] ^ b[i]);
+    }
+    if (num_bits % 8 != 0) {
+        total += __builtin_popcount((a[bytes] ^ b[bytes]) & (0xff00 >> (num_bits % 8)) & 0xff);
+    }
+    return total;
+}
+
+static double **aloca_matriz(int linhas, int colunas) {
+    double **A = malloc(sizeof(double*) * linhas);
+    for (int i = 0; i < linhas; i++) {
+        A[i] = malloc(sizeof(double) * colunas);
+    }
+    return A;
+}
+
+static void libera_matriz(double **A, int linhas) {
+    for (int i = 0; i < linhas; i++) {
+        free(A[i]);
+    }
+    free(A);
+}
+
+/// Estado de uma thread da simulação: buffers alocados uma vez e contadores próprios.
+
+typedef struct {
+    const simulacao_config *cfg;
+    const modulacao_qam *mod;
+    const double *snr_db;
+    int num_snr;
+    long *proxima;              /**< Próxima realização a simular (compartilhada entre as threads). */
+    long trecho;                /**< Símbolos por trecho (múltiplo de 64 e de num_streams). */
+    double **G;                 /**< Canal real gerado para um bloco novo (sem modelo de canal). */
+    const double *w_canal;      /**< H do canal atual (complexa), guardada no cache. */
+    const double *w_precoder;   /**< V^H do canal atual, guardada no cache. */
+    const double *w_combiner;   /**< U^H do canal atual, guardada no cache. */
+    const double *inv_S;        /**< 1 / S do canal atual, guardado no cache. */
+    cache_svd cache;            /**< Decomposições dos blocos de coerência, com o canal na área extra. */
+    double *instantes;          /**< Com Doppler: o canal de cada trecho da realização. */
+    double *uh;                 /**< Com Doppler: U^H do trecho atual. */
+    double *inv_s;              /**< Com Doppler: 1 / S do trecho atual. */
+    uint64_t *tx;               /**< Bits transmitidos do trecho (alinhados a 8 bytes). */
+    uint8_t *rx;
+    double complex *simbolos;
+    double complex **layers, **precoded, **received, **combined;
+    simulacao_ponto *pontos;    /**< Contagens desta thread, uma por ponto de SNR. */
+} simulacao_trabalhador;
+
+static void trabalhador_aloca(simulacao_trabalhador *w) {
+    const simulacao_config *cfg = w->cfg;
+    int ns = cfg->num_streams, bits = w->mod->bits;
+    long len = w->trecho / ns;
+
+    w->G = aloca_matriz(cfg->Nr, cfg->Nt);
+    w->cache = cache_svd_cria(cfg->Nr, cfg->Nt, 2 * (size_t) cfg->Nr * cfg->Nt, SIMULACAO_CACHE_BYTES);
+    w->tx = malloc(sizeof(uint64_t) * (w->trecho * bits / 64 + 1));
+    w->rx = malloc(w->trecho * bits / 8 + 1);
+    w->simbolos = malloc(sizeof(double complex) * w->trecho);
+    w->layers = aloca_streams(ns, len);
+    w->precoded = aloca_streams(cfg->Nt, len);
+    w->received = aloca_streams(cfg->Nr, len);
+    w->combined = aloca_streams(ns, len);
+    w->pontos = calloc(w->num_snr, sizeof(simulacao_ponto));
+    w->instantes = w->uh = w->inv_s = NULL;
+    if (cfg->canal != NULL && cfg->canal->senoides > 0) {
+        long trechos = (cfg->simbolos + w->trecho - 1) / w->trecho;
+        w->instantes = malloc(sizeof(double) * 2 * trechos * cfg->Nr * cfg->Nt);
+        w->uh = malloc(sizeof(double) * 2 * ns * cfg->Nr);
+        w->inv_s = malloc(sizeof(double) * ns);
+    }
+}
+
+static void trabalhador_libera(simulacao_trabalhador *w) {
+    const simulacao_config *cfg = w->cfg;
+    int ns = cfg->num_streams;
+
+    libera_matriz(w->G, cfg->Nr);
+    cache_svd_libera(&w->cache);
+    free(w->tx);
+    free(w->rx);
+    free(w->simbolos);
+    libera_streams(w->layers, ns);
+    libera_streams(w->precoded, cfg->Nt);
+    libera_streams(w->received, cfg->Nr);
+    libera_streams(w->combined, ns);
+    free(w->pontos);
+    free(w->instantes);
+    free(w->uh);
+    free(w->inv_s);
+}
+
+/// Obtém o canal do bloco de coerência e a sua SVD, calculando-os só na primeira vez que
+/// o bloco aparece para a thread (ou depois de ele ser descartado do cache).
+
+static void canal_do_bloco(simulacao_trabalhador *w, uint32_t bloco) {
+    const simulacao_config *cfg = w->cfg;
+    int Nr = cfg->Nr, Nt = cfg->Nt;
+    cache_svd_entrada *e = cache_svd_procura(&w->cache, bloco);
+
+    if (e == NULL) {
+        double *h = w->cache.svd.entrada;
+        if (cfg->canal != NULL) {
+            modelo_canal_gera(cfg->canal, bloco, 1, h);
+        } else {
+            channel_gen_realizacao_em(Nr, Nt, bloco, w->G);
+            coeficientes_canal(w->G, Nr, Nt, h);
+        }
+        e = cache_svd_calcula(&w->cache, bloco, h, Nt);
+        memcpy(e->extra, h, sizeof(double) * 2 * Nr * Nt);
+    }
+
+    // Com H = U S V^H, o pré-codificador é V (no canal real, a V^T de main transposta pela
+    // convenção da cadeia), o combinador U^H e o equalizador 1 / S, também com o canal complexo.
+    // Todas são usadas direto da entrada, que não é descartada antes do fim da realização,
+    // assim como o próprio H, guardado na área extra no formato da transmissão.
+    w->w_canal = e->extra;
+    w->w_precoder = e->v;
+    w->w_combiner = e->uh;
+    w->inv_S = e->inv_s;
+}
+
+/// Obtém o canal variante no tempo do trecho b da realização e a sua SVD.
+
+/// Os canais de todos os trechos foram amostrados de uma vez (modelo_canal_gera_instantes),
+/// no centro de cada trecho. A SVD do primeiro trecho é calculada do zero e a dos demais
+/// acompanha a do trecho anterior (svd_contexto_acompanha), então a realização não
+/// depende de qual thread a simula nem do que ela simulou antes.
+
+static void canal_do_trecho(simulacao_trabalhador *w, long b) {
+    int Nr = w->cfg->Nr, Nt = w->cfg->Nt;
+    svd_contexto *svd = &w->cache.svd;
+    const double *h = w->instantes + 2 * b * Nr * Nt;
+
+    if (b == 0) {
+        svd_contexto_calcula(svd, h, Nt);
+    } else {
+        svd_contexto_acompanha(svd, h, Nt);
+    }
+    for (int r = 0; r < Nr; r++) {
+        for (int j = 0; j < svd->k; j++) {
+            w->uh[2 * (j * Nr + r)] = svd->u[2 * (r * svd->k + j)];
+            w->uh[2 * (j * Nr + r) + 1] = -svd->u[2 * (r * svd->k + j) + 1];
+        }
+    }
+    for (int j = 0; j < svd->k; j++) {
+        w->inv_s[j] = svd->s[j] > 0 ? 1 / svd->s[j] : 0;
+    }
+
+    w->w_canal = h;
+    w->w_precoder = svd->v;
+    w->w_combiner = w->uh;
+    w->inv_S = w->inv_s;
+}
+
+/// Simula uma realização em todos os pontos de SNR: o canal e a SVD vêm do bloco de
+/// coerência (ou, com Doppler, de cada trecho), e cada ponto transmite os mesmos bits,
+/// mapeados e pré-codificados uma vez por trecho, com o mesmo ruído normalizado.
+
+static void simula_realizacao(simulacao_trabalhador *w, uint32_t r) {
+    const simulacao_config *cfg = w->cfg;
+    const modulacao_qam *mod = w->mod;
+    int ns = cfg->num_streams, bits = mod->bits;
+    ruido_fluxo dados = { ruido_semente, r, FLUXO_DADOS };
+
+    if (w->instantes != NULL) {
+        long len = w->trecho / ns;
+        modelo_canal_gera_instantes(cfg->canal, r, (len - 1) / 2.0, len, (int) ((cfg->simbolos + w->trecho - 1) / w->trecho), w->instantes);
+    } else {
+        canal_do_bloco(w, cfg->coerencia > 1 ? r / (uint32_t) cfg->coerencia : r);
+    }
+
+    for (long inicio = 0; inicio < cfg->simbolos; inicio += w->trecho) {
+        long n = cfg->simbolos - inicio < w->trecho ? cfg->simbolos - inicio : w->trecho;
+        long len = (n + ns - 1) / ns;
+        const uint8_t *tx = (const uint8_t*) w->tx;
+
+        if (w->instantes != NULL) {
+            canal_do_trecho(w, inicio / w->trecho);
+        }
+        ruido_fluxo_uniforme(&dados, (uint64_t) inicio * bits / 64, w->tx, (indices_bytes(n, bits) + 7) / 8);
+        qam_mapeia(mod, tx, n, (double*) w->simbolos);
+        for (long i = 0; i < len * ns; i++) {
+            w->layers[i % ns][i / ns] = i < n ? w->simbolos[i] : 0;
+        }
+        tx_precoder_matriz_em(w->layers, len, ns, w->w_precoder, w->precoded);
+
+        for (int p = 0; p < w->num_snr; p++) {
+            channel_transmission_snr_matriz_em(w->precoded, len, w->w_canal, cfg->Nr, cfg->Nt, w->snr_db[p], cfg->snr_tipo, cfg->M, ns, r, (uint64_t) inicio / ns, w->received);
+            rx_combiner_matriz_em(w->received, len, ns, w->w_combiner, w->combined);
+            rx_feq_inverso_em(w->combined, len, ns, w->inv_S, w->combined);
+
+            for (long i = 0; i < n; i++) {
+                w->simbolos[i] = w->combined[i % ns][i / ns];
+            }
+            qam_demapeia(mod, (double*) w->simbolos, n, w->rx);
+
+            w->pontos[p].simbolos += n;
+            w->pontos[p].erros_simbolo += indices_diferencas(tx, w->rx, bits, n);
+            w->pontos[p].bits += n * bits;
+            w->pontos[p].erros_bit += bits_diferentes(tx, w->rx, n * bits);
         }
     }
-    printf("Número de símbolos QAM transmitidos: %d\n", size);
-    printf("Número de símbolos QAM recebidos com erro: %d\n", num_errors);
-    printf("Porcentagem de símbolos QAM recebidos com erro: %.2f %%\n", (double)num_errors / size * 100);
+}
+
+/// Laço de uma thread: pega a próxima realização até acabarem.
+
+static void *simulacao_executa(void *arg) {
+    simulacao_trabalhador *w = arg;
+
+    for (;;) {
+        long r = __atomic_fetch_add(w->proxima, 1, __ATOMIC_RELAXED);
+        if (r >= w->cfg->realizacoes) {
+            break;
+        }
+        simula_realizacao(w, (uint32_t) r);
+    }
+    return NULL;
+}
+
+/// Simulação de Monte Carlo da taxa de erro de bit e de símbolo em vários pontos de SNR.
+
+/// As realizações são distribuídas dinamicamente entre as threads, que têm buffers e
+/// contadores próprios; as contagens são somadas só no final. Com cfg->coerencia = Q > 1
+/// as realizações qQ a qQ + Q - 1 usam o canal do bloco q, cuja SVD fica no cache de
+/// decomposições de cada thread (cache_svd.h); cada realização tem ainda bits e ruído
+/// próprios. Com cfg->canal o canal do bloco vem do modelo complexo (modelo_canal.h),
+/// também por contador. Se o modelo tiver Doppler, cada realização é uma trajetória do
+/// canal, atualizado a cada cfg->intervalo_canal símbolos por stream, com a SVD de um
+/// intervalo acompanhando a do anterior. Como o canal, os bits e o
+/// ruído de cada realização vêm do gerador por contador (realização r, ver
+/// channel_gen_realizacao e channel_transmission_em), o resultado não depende do número
+/// de threads nem da ordem em que as realizações são simuladas. Exige Nr = Nt = num_streams.
+
+/// @param cfg a configuração da simulação
+/// @param snr_db os pontos de SNR, em dB
+/// @param num_snr o número de pontos
+/// @param resultados o vetor de saída, com num_snr posições
+/// @return 0 em caso de sucesso, -1 se a configuração for inválida
+
+int simulacao_monte_carlo(const simulacao_config *cfg, const double *snr_db, int num_snr, simulacao_ponto *resultados) {
+    const modulacao_qam *mod = modulacao_qam_obtem(cfg->M);
+    if (mod == NULL || cfg->Nr != cfg->num_streams || cfg->Nt != cfg->num_streams || cfg->realizacoes <= 0 || cfg->simbolos <= 0 ||
+        (cfg->canal != NULL && (cfg->canal->Nr != cfg->Nr || cfg->canal->Nt != cfg->Nt)) ||
+        (cfg->canal != NULL && cfg->canal->senoides > 0 && (cfg->coerencia > 1 || cfg->intervalo_canal <= 0 || cfg->intervalo_canal * cfg->num_streams % 64 != 0)) ||
+        cfg->realizacoes > 0xffffffffL || (cfg->snr_tipo != SNR_ES_N0 && cfg->snr_tipo != SNR_EB_N0)) {
+        return -1;
+    }
+
+    long threads = cfg->threads > 0 ? cfg->threads : sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads < 1) {
+        threads = 1;
+    }
+    if (threads > cfg->realizacoes) {
+        threads = cfg->realizacoes;
+    }
+    long trecho = SIMULACAO_TRECHO / (64 * cfg->num_streams) * (64 * cfg->num_streams);
+    if (trecho == 0) {
+        trecho = 64 * cfg->num_streams;
+    }
+    // Com Doppler, cada trecho é um intervalo do canal.
+    if (cfg->canal != NULL && cfg->canal->senoides > 0) {
+        trecho = cfg->intervalo_canal * cfg->num_streams;
+    }
+
+    long proxima = 0;
+    simulacao_trabalhador *trabalhadores = malloc(sizeof(simulacao_trabalhador) * threads);
+    pthread_t *ids = malloc(sizeof(pthread_t) * threads);
+    int *criada = calloc(threads, sizeof(int));
+
+    for (long t = 0; t < threads; t++) {
+        simulacao_trabalhador *w = &trabalhadores[t];
+        w->cfg = cfg;
+        w->mod = mod;
+        w->snr_db = snr_db;
+        w->num_snr = num_snr;
+        w->proxima = &proxima;
+        w->trecho = trecho;
+        trabalhador_aloca(w);
+    }
+    // A thread chamadora é o trabalhador 0; se alguma thread não puder ser criada, as
+    // realizações dela ficam com as demais.
+    for (long t = 1; t < threads; t++) {
+        criada[t] = pthread_create(&ids[t], NULL, simulacao_executa, &trabalhadores[t]) == 0;
+    }
+    simulacao_executa(&trabalhadores[0]);
+
+    for (int p = 0; p < num_snr; p++) {
+        resultados[p] = (simulacao_ponto) { .snr_db = snr_db[p] };
+    }
+    for (long t = 0; t < threads; t++) {
+        if (criada[t]) {
+            pthread_join(ids[t], NULL);
+        }
+        for (int p = 0; p < num_snr; p++) {
+            resultados[p].simbolos += trabalhadores[t].pontos[p].simbolos;
+            resultados[p].erros_simbolo += trabalhadores[t].pontos[p].erros_simbolo;
+            resultados[p].bits += trabalhadores[t].pontos[p].bits;
+            resultados[p].erros_bit += trabalhadores[t].pontos[p].erros_bit;
+        }
+        trabalhador_libera(&trabalhadores[t]);
+    }
+    free(trabalhadores);
+    free(ids);
+    free(criada);
+    return 0;
+}
+
+/// Executa a simulação de Monte Carlo e imprime a tabela de BER e SER.
+
+/// @param cfg a configuração da simulação
+/// @param faixa os pontos de SNR: "inicial:final:passo" ou um único valor, em dB
+
+static void executa_monte_carlo(const simulacao_config *cfg, const char *faixa) {
+    double inicial, final, passo = 1;
+    int lidos = sscanf(faixa, "%lf:%lf:%lf", &inicial, &final, &passo);
+    if (lidos < 1 || passo <= 0) {
+        printf("Faixa de SNR inválida: %s\n", faixa);
+        exit(1);
+    }
+    if (lidos == 1) {
+        final = inicial;
+    }
+    int num_snr = (int) floor((final - inicial) / passo + 1e-9) + 1;
+    if (num_snr < 1) {
+        num_snr = 1;
+    }
+    double *snr_db = malloc(sizeof(double) * num_snr);
+    simulacao_ponto *resultados = malloc(sizeof(simulacao_ponto) * num_snr);
+    for (int p = 0; p < num_snr; p++) {
+        snr_db[p] = inicial + p * passo;
+    }
+
+    if (simulacao_monte_carlo(cfg, snr_db, num_snr, resultados) != 0) {
+        printf("Configuração de simulação inválida\n");
+        exit(1);
+    }
+
+    printf("%d-QAM, %d streams, %ld realizações de %ld símbolos por ponto", cfg->M, cfg->num_streams, cfg->realizacoes, cfg->simbolos);
+    if (cfg->coerencia > 1) {
+        printf(", %ld por bloco de canal", cfg->coerencia);
+    }
+    if (cfg->canal != NULL) {
+        printf(", canal complexo com K = %g", cfg->canal->K);
+        if (cfg->canal->rr != NULL) {
+            printf(" e correlação de Kronecker");
+        }
+        if (cfg->canal->senoides > 0) {
+            printf(", Doppler fd Ts = %g atualizado a cada %ld símbolos", cfg->canal->fd, cfg->intervalo_canal);
+        }
+    }
+    printf("\n\n");
+    printf("%10s %14s %14s %12s %12s\n", cfg->snr_tipo == SNR_EB_N0 ? "Eb/N0 (dB)" : "Es/N0 (dB)", "erros símb.", "erros bit", "SER", "BER");
+    for (int p = 0; p < num_snr; p++) {
+        printf("%10.2f %14" PRId64 " %14" PRId64 " %12.4e %12.4e\n", resultados[p].snr_db, resultados[p].erros_simbolo, resultados[p].erros_bit,
+               (double) resultados[p].erros_simbolo / resultados[p].simbolos, (double) resultados[p].erros_bit / resultados[p].bits);
+    }
+    free(snr_db);
+    free(resultados);
 }
 
 int main(int argc, char *argv[]) {
@@ -363,18 +1529,98 @@ int main(int argc, char *argv[]) {
 
     printf("\n");
 
-    if (argc != 3) {
-        printf("Uso: %s <arquivo de entrada> <arquivo de saída>\n", argv[0]);
+    // Opções: --streaming, --monte-carlo R N, --threads T, --coerencia Q (realizações por
+    // bloco de canal em Monte Carlo), --rayleigh, --rice K e --correlacao rho (canal
+    // complexo de modelo_canal.h em Monte Carlo, com fator de Rice K e correlação
+    // exponencial rho nos dois arranjos), --doppler fd L (o mesmo canal variante no tempo,
+    // com fd Ts = fd e atualizado a cada L símbolos por stream), --qam M (só em streaming ou
+    // Monte Carlo), --snr dB (Es/N0) ou --ebn0 dB (Eb/N0); em Monte Carlo a SNR pode ser
+    // uma faixa "inicial:final:passo".
+    int streaming = 0, M = 4, snr_tipo = SNR_NENHUMA, threads = 0, complexo = 0;
+    long realizacoes = 0, simbolos = 0, coerencia = 1;
+    long intervalo_canal = 0;
+    double snr_db = 0, rice = 0, correlacao = 0, fd = -1;
+    const char *snr_texto = NULL;
+    int arg = 1;
+    for (; arg < argc && strncmp(argv[arg], "--", 2) == 0; arg++) {
+        if (strcmp(argv[arg], "--streaming") == 0) {
+            streaming = 1;
+        } else if (strcmp(argv[arg], "--monte-carlo") == 0 && arg + 2 < argc) {
+            realizacoes = atol(argv[++arg]);
+            simbolos = atol(argv[++arg]);
+        } else if (strcmp(argv[arg], "--threads") == 0 && arg + 1 < argc) {
+            threads = atoi(argv[++arg]);
+        } else if (strcmp(argv[arg], "--coerencia") == 0 && arg + 1 < argc) {
+            coerencia = atol(argv[++arg]);
+        } else if (strcmp(argv[arg], "--rayleigh") == 0) {
+            complexo = 1;
+        } else if (strcmp(argv[arg], "--rice") == 0 && arg + 1 < argc) {
+            complexo = 1;
+            rice = atof(argv[++arg]);
+        } else if (strcmp(argv[arg], "--correlacao") == 0 && arg + 1 < argc) {
+            complexo = 1;
+            correlacao = atof(argv[++arg]);
+        } else if (strcmp(argv[arg], "--doppler") == 0 && arg + 2 < argc) {
+            complexo = 1;
+            fd = atof(argv[++arg]);
+            intervalo_canal = atol(argv[++arg]);
+        } else if (strcmp(argv[arg], "--qam") == 0 && arg + 1 < argc) {
+            M = atoi(argv[++arg]);
+        } else if (strcmp(argv[arg], "--snr") == 0 && arg + 1 < argc) {
+            snr_tipo = SNR_ES_N0;
+            snr_texto = argv[++arg];
+            snr_db = atof(snr_texto);
+        } else if (strcmp(argv[arg], "--ebn0") == 0 && arg + 1 < argc) {
+            snr_tipo = SNR_EB_N0;
+            snr_texto = argv[++arg];
+            snr_db = atof(snr_texto);
+        } else {
+            break;
+        }
+    }
+
+    if (realizacoes > 0 && argc == arg && snr_tipo != SNR_NENHUMA) {
+        simulacao_config cfg = { M, num_streams, Nr, Nt, snr_tipo, simbolos, realizacoes, threads, coerencia, NULL, intervalo_canal };
+        modelo_canal canal = modelo_canal_cria(Nr, Nt, RUIDO_SEMENTE_PADRAO);
+        if (complexo) {
+            double *Rr = malloc(sizeof(double) * 2 * Nr * Nr);
+            double *Rt = malloc(sizeof(double) * 2 * Nt * Nt);
+            modelo_canal_correlacao_exponencial(Nr, correlacao, Rr);
+            modelo_canal_correlacao_exponencial(Nt, correlacao, Rt);
+            if (correlacao < 0 || correlacao >= 1 || modelo_canal_rice(&canal, rice, NULL) != 0 || (correlacao != 0 && modelo_canal_correlacao(&canal, Rr, Rt) != 0) ||
+                (fd >= 0 && modelo_canal_doppler(&canal, fd, SIMULACAO_SENOIDES_DOPPLER) != 0)) {
+                printf("Modelo de canal inválido\n");
+                exit(1);
+            }
+            free(Rr);
+            free(Rt);
+            cfg.canal = &canal;
+        }
+        executa_monte_carlo(&cfg, snr_texto);
+        modelo_canal_libera(&canal);
+        return 0;
+    }
+
+    if (argc - arg != 2 || (!streaming && M != 4) || realizacoes > 0 || complexo) {
+        printf("Uso: %s [--streaming [--qam M]] [--snr dB | --ebn0 dB] <arquivo de entrada> <arquivo de saída>\n", argv[0]);
+        printf("     %s --monte-carlo <realizações> <símbolos> [--threads T] [--coerencia Q] [--rayleigh | --rice K] [--correlacao rho] [--doppler fd L] [--qam M] --snr|--ebn0 <inicial:final:passo>\n", argv[0]);
         exit(1);
     }
-    
-    int *tx_indices = tx_data_read(argv[1], &size);
+    char *arquivo_in = argv[arg], *arquivo_out = argv[arg + 1];
+
+    if (streaming) {
+        executa_streaming(arquivo_in, arquivo_out, M, num_streams, Nr, Nt, ruido_min, ruido_max, snr_tipo, snr_db);
+        return 0;
+    }
+
+    arquivo_entrada entrada;
+    const uint8_t *tx_indices = tx_data_read(arquivo_in, &size, &entrada);
 
     printf("\n");
 
     printf("Indices: [");
     for (int i = 0; i < size; i++) {
-        printf("%d", tx_indices[i]);
+        printf("%d", indices_obtem(tx_indices, QAM_BITS, i));
         if (i < size - 1) {
             printf(", ");
         }
@@ -439,15 +1685,16 @@ int main(int argc, char *argv[]) {
         Vt[i] = malloc(sizeof(double) * Nr);
     }
 
-    svd(Ht, Nt, Nr, Ut, S, Vt);
+    svd_contexto svd_ctx = svd_contexto_aloca(Nt, Nr);
+
+    svd_com_contexto(&svd_ctx, Ht, Ut, S, Vt);
 
-    double **U = matrix_transpose(Ut, Nt, Nr);
     double **V = matrix_transpose(Vt, Nr, Nr);
 
     printf("Matriz U:\n");
     for (int i = 0; i < Nr; i++) {
         for (int j = 0; j < Nt; j++) {
-            printf("%f ", U[i][j]);
+            printf("%f ", Ut[i][j]);
         }
         printf("\n");
     }
@@ -491,7 +1738,14 @@ int main(int argc, char *argv[]) {
 
     printf("\n");
 
-    double complex **canal_data = channel_transmission(precoded_data, size, num_streams, Ht, Nr, Nt, ruido_min, ruido_max);
+    double complex **canal_data;
+    if (snr_tipo == SNR_NENHUMA) {
+        canal_data = channel_transmission(precoded_data, size, num_streams, Ht, Nr, Nt, ruido_min, ruido_max);
+    } else {
+        double N0;
+        canal_data = channel_transmission_snr(precoded_data, size, num_streams, Ht, Nr, Nt, snr_db, snr_tipo, 4, &N0);
+        printf("SNR de %.2f dB (%s): N0 = %g\n\n", snr_db, snr_tipo == SNR_EB_N0 ? "Eb/N0" : "Es/N0", N0);
+    }
 
     printf("Dados transmitidos:\n");
     for (int i = 0; i < Nr; i++) {
@@ -507,7 +1761,7 @@ int main(int argc, char *argv[]) {
 
     printf("\n");
 
-    double complex **combined_data = rx_combiner(canal_data, size, num_streams, U);
+    double complex **combined_data = rx_combiner(canal_data, size, num_streams, Ut);
 
     printf("Dados combinados:\n");
     for (int i = 0; i < num_streams; i++) {
@@ -552,11 +1806,11 @@ int main(int argc, char *argv[]) {
 
     printf("\n");
 
-    int *rx_indices = rx_qam_demapper(rx_demapper, size);
+    uint8_t *rx_indices = rx_qam_demapper(rx_demapper, size);
 
     printf("Indices recuperados: [");
     for (int i = 0; i < size; i++) {
-        printf("%d", rx_indices[i]);
+        printf("%d", indices_obtem(rx_indices, QAM_BITS, i));
         if (i < size - 1) {
             printf(", ");
         }
@@ -591,16 +1845,14 @@ int main(int argc, char *argv[]) {
 
     gera_estatisticas(tx_indices, rx_indices, size);
 
-    rx_data_write(rx_indices, size, argv[2]);
+    rx_data_write(rx_indices, size, arquivo_out);
 
     for (int i = 0; i < Nr; i++) {
         free(H[i]);
-        free(U[i]);
         free(Vt[i]);
         free(canal_data[i]);
     }
     free(H);
-    free(U);
     free(S);
     free(Vt);
     free(canal_data);
@@ -625,12 +1877,14 @@ int main(int argc, char *argv[]) {
     free(Ut);
     free(V);
 
-    free(tx_indices);
+    arquivo_entrada_fecha(&entrada);
     free(data);
     free(padded_data);
     free(rx_indices);
     free(rx_demapper);
     free(depadded_data);
 
+    svd_contexto_libera(&svd_ctx);
+
     return 0;
 }
@@ -7,16 +7,35 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <complex.h>
-#include <gsl/gsl_linalg.h>
+#include <stdint.h>
+#include "../matrizes/svd_complexa.h"
+#include "arquivo_entrada.h"
+#include "modelo_canal.h"
+
+/**
+ * Como a SNR pedida a channel_transmission_snr é definida.
+ */
+enum {
+    SNR_NENHUMA = 0, /**< Sem SNR: ruído dado por ruido_min e ruido_max. */
+    SNR_ES_N0 = 1,   /**< Energia por símbolo de cada stream sobre N0. */
+    SNR_EB_N0 = 2    /**< Energia por bit (Es / log2(M)) sobre N0. */
+};
 
 /**
  * Lê os índices dos dados a serem transmitidos a partir de um arquivo.
  *
+ * Os bytes do arquivo já são os índices empacotados (2 bits por símbolo, ver indices_qam.h).
+ * O arquivo é mapeado em memória e o ponteiro devolvido aponta para o próprio
+ * mapeamento, sem cópia; ele vale até arquivo_entrada_fecha(entrada). Como os números
+ * de símbolos da cadeia padrão são int, arquivos de mais de 256 MiB são recusados com uma
+ * mensagem indicando o modo --streaming.
+ *
  * @param filename o nome do arquivo
- * @param size um ponteiro para armazenar o tamanho do array
- * @return um ponteiro para o array de inteiros lidos do arquivo
+ * @param size um ponteiro para armazenar o número de símbolos
+ * @param entrada recebe o arquivo aberto, a ser fechado pelo chamador
+ * @return um ponteiro para os índices empacotados lidos do arquivo
  */
-int *tx_data_read(char *filename, int *size);
+const uint8_t *tx_data_read(char *filename, int *size, arquivo_entrada *entrada);
 
 /**
  * Preenche os dados com zeros para atingir o tamanho desejado, considerando o número de streams e transmissores.
@@ -32,11 +51,24 @@ double complex *tx_data_padding(double complex *data, int size, int num_streams,
 /**
  * Realiza o mapeamento dos índices para símbolos QAM.
  *
- * @param tx_indices um ponteiro para o array de índices
- * @param size o tamanho do array de índices
+ * @param tx_indices os índices empacotados
+ * @param size o número de símbolos
  * @return um ponteiro para o array de símbolos QAM
  */
-double complex *QAMmapper(int *tx_indices, int size);
+double complex *QAMmapper(const uint8_t *tx_indices, int size);
+
+/**
+ * Realiza o mapeamento dos bits empacotados para símbolos de uma constelação M-QAM quadrada.
+ *
+ * Os símbolos têm código de Gray e energia média unitária (ver modulacao_qam.h); cada
+ * símbolo consome log2(M) bits da entrada.
+ *
+ * @param tx_bits os bits empacotados
+ * @param size o número de símbolos
+ * @param M o número de pontos da constelação (4, 16, 64, 256 ou 1024)
+ * @return um ponteiro para o array de símbolos QAM
+ */
+double complex *QAMmapper_M(const uint8_t *tx_bits, int size, int M);
 
 /**
  * Realiza o mapeamento em camada dos dados, dividindo-os em streams.
@@ -49,7 +81,7 @@ double complex *QAMmapper(int *tx_indices, int size);
 double complex **tx_layer_mapper(double complex *data, int size, int num_streams);
 
 /**
- * Gera uma matriz de canal aleatória.
+ * Gera uma matriz de canal aleatória (a realização 0).
  *
  * @param Nr o número de receptores
  * @param Nt o número de transmissores
@@ -57,6 +89,28 @@ double complex **tx_layer_mapper(double complex *data, int size, int num_streams
  */
 double **channel_gen(int Nr, int Nt);
 
+/**
+ * Gera a matriz de canal de uma realização, com entradas uniformes em [-1, 1).
+ *
+ * A matriz depende apenas da semente e da realização (gerador por contador).
+ *
+ * @param Nr o número de receptores
+ * @param Nt o número de transmissores
+ * @param realizacao o índice da realização
+ * @return um ponteiro para a matriz de canal gerada
+ */
+double **channel_gen_realizacao(int Nr, int Nt, uint32_t realizacao);
+
+/**
+ * Gera a matriz de canal de uma realização em uma matriz já alocada pelo chamador.
+ *
+ * @param Nr o número de receptores
+ * @param Nt o número de transmissores
+ * @param realizacao o índice da realização
+ * @param H a matriz de saída (Nr x Nt)
+ */
+void channel_gen_realizacao_em(int Nr, int Nt, uint32_t realizacao, double **H);
+
 /**
  * Transpõe a matriz de canal.
  *
@@ -82,9 +136,154 @@ double **matrix_transpose(double **H, int Nr, int Nt);
  */
 double complex **channel_transmission(double complex **data, int size, int num_streams, double **H, int Nr, int Nt, double ruido_min, double ruido_max);
 
+/**
+ * Realiza a transmissão dos dados pelo canal em streams já alocados pelo chamador.
+ *
+ * O ruído é gaussiano, independente em cada eixo, com a média e a variância da
+ * distribuição uniforme em [ruido_min, ruido_max]. O ruído de cada símbolo depende
+ * apenas da semente, da realização, do receptor e da posição do símbolo, então os
+ * blocos podem ser transmitidos isoladamente e em qualquer ordem.
+ *
+ * @param data os Nt streams transmitidos
+ * @param len o número de símbolos de cada stream
+ * @param H a matriz de canal
+ * @param Nr o número de receptores
+ * @param Nt o número de transmissores
+ * @param ruido_min o valor mínimo do ruído
+ * @param ruido_max o valor máximo do ruído
+ * @param realizacao o índice da realização (do canal e do ruído)
+ * @param deslocamento a posição do primeiro símbolo do bloco em cada stream
+ * @param result os Nr streams recebidos (alocados pelo chamador)
+ */
+void channel_transmission_em(double complex **data, long len, double **H, int Nr, int Nt, double ruido_min, double ruido_max, uint32_t realizacao, uint64_t deslocamento, double complex **result);
+
+/**
+ * Monta a matriz de canal no formato contíguo complexo usado pela transmissão, uma vez por canal.
+ *
+ * @param H a matriz de canal (Nr x Nt)
+ * @param Nr o número de receptores
+ * @param Nt o número de transmissores
+ * @param h a matriz de saída (Nr x Nt, complexa, intercalada, por linhas)
+ */
+void coeficientes_canal(double **H, int Nr, int Nt, double *h);
+
+/**
+ * Realiza a transmissão dos dados pelo canal com a matriz de canal já montada por coeficientes_canal.
+ *
+ * Mesmo resultado de channel_transmission_em, sem montar a matriz a cada bloco.
+ *
+ * @param data os Nt streams transmitidos
+ * @param len o número de símbolos de cada stream
+ * @param h a matriz de canal (Nr x Nt, complexa, intercalada, por linhas)
+ * @param Nr o número de receptores
+ * @param Nt o número de transmissores
+ * @param ruido_min o valor mínimo do ruído
+ * @param ruido_max o valor máximo do ruído
+ * @param realizacao o índice da realização (do canal e do ruído)
+ * @param deslocamento a posição do primeiro símbolo do bloco em cada stream
+ * @param result os Nr streams recebidos (alocados pelo chamador)
+ */
+void channel_transmission_matriz_em(double complex **data, long len, const double *h, int Nr, int Nt, double ruido_min, double ruido_max, uint32_t realizacao, uint64_t deslocamento, double complex **result);
+
+/**
+ * Realiza a transmissão dos dados pelo canal com ruído calibrado por uma SNR.
+ *
+ * @param data um ponteiro para o array de dados
+ * @param size o tamanho do array de dados
+ * @param num_streams o número de streams
+ * @param H a matriz de canal
+ * @param Nr o número de receptores
+ * @param Nt o número de transmissores
+ * @param snr_db a SNR em dB
+ * @param snr_tipo SNR_ES_N0 ou SNR_EB_N0
+ * @param M o número de pontos da constelação
+ * @param N0 recebe a variância do ruído complexo usada (pode ser NULL)
+ * @return um ponteiro para o array de dados transmitidos
+ */
+double complex **channel_transmission_snr(double complex **data, int size, int num_streams, double **H, int Nr, int Nt, double snr_db, int snr_tipo, int M, double *N0);
+
+/**
+ * Realiza a transmissão dos dados pelo canal com ruído gaussiano branco calibrado por uma SNR.
+ *
+ * N0 é calculada a partir da potência efetivamente transmitida no bloco: Es é a soma
+ * de |x|^2 nas Nt antenas, média por símbolo, dividida pelo número de streams, e
+ * Eb = Es / log2(M). A SNR é medida na entrada do canal, antes do ganho de H.
+ *
+ * @param data os Nt streams transmitidos
+ * @param len o número de símbolos de cada stream
+ * @param H a matriz de canal
+ * @param Nr o número de receptores
+ * @param Nt o número de transmissores
+ * @param snr_db a SNR em dB
+ * @param snr_tipo SNR_ES_N0 ou SNR_EB_N0
+ * @param M o número de pontos da constelação
+ * @param num_streams o número de streams de dados
+ * @param realizacao o índice da realização (do canal e do ruído)
+ * @param deslocamento a posição do primeiro símbolo do bloco em cada stream
+ * @param result os Nr streams recebidos (alocados pelo chamador)
+ * @return a variância N0 do ruído complexo usada
+ */
+double channel_transmission_snr_em(double complex **data, long len, double **H, int Nr, int Nt, double snr_db, int snr_tipo, int M, int num_streams, uint32_t realizacao, uint64_t deslocamento, double complex **result);
+
+/**
+ * Realiza a transmissão calibrada por uma SNR com a matriz de canal já montada por coeficientes_canal.
+ *
+ * @param data os Nt streams transmitidos
+ * @param len o número de símbolos de cada stream
+ * @param h a matriz de canal (Nr x Nt, complexa, intercalada, por linhas)
+ * @param Nr o número de receptores
+ * @param Nt o número de transmissores
+ * @param snr_db a SNR em dB
+ * @param snr_tipo SNR_ES_N0 ou SNR_EB_N0
+ * @param M o número de pontos da constelação
+ * @param num_streams o número de streams de dados
+ * @param realizacao o índice da realização (do canal e do ruído)
+ * @param deslocamento a posição do primeiro símbolo do bloco em cada stream
+ * @param result os Nr streams recebidos (alocados pelo chamador)
+ * @return a variância N0 do ruído complexo usada
+ */
+double channel_transmission_snr_matriz_em(double complex **data, long len, const double *h, int Nr, int Nt, double snr_db, int snr_tipo, int M, int num_streams, uint32_t realizacao, uint64_t deslocamento, double complex **result);
+
+/**
+ * Variância do ruído complexo que dá a SNR pedida para um bloco de dados transmitidos.
+ *
+ * @param data os Nt streams transmitidos
+ * @param len o número de símbolos de cada stream
+ * @param Nt o número de transmissores
+ * @param snr_db a SNR em dB
+ * @param snr_tipo SNR_ES_N0 ou SNR_EB_N0
+ * @param M o número de pontos da constelação
+ * @param num_streams o número de streams de dados
+ * @return N0 (E|ruído|^2 em cada receptor), ou 0 se o bloco estiver vazio
+ */
+double ruido_n0_snr(double complex **data, long len, int Nt, double snr_db, int snr_tipo, int M, int num_streams);
+
+/**
+ * Define a semente do canal e do ruído (sem chamada, a semente é 2).
+ *
+ * @param semente a semente
+ */
+void ruido_canal_semente(uint64_t semente);
+
+/**
+ * Realiza a decomposição em valores singulares (SVD) da matriz de canal usando um contexto já criado.
+ *
+ * O contexto (svd_contexto_aloca(Nr, Nt)) guarda toda a memória de trabalho, então a
+ * decomposição não faz nenhuma alocação.
+ *
+ * @param ctx o contexto de SVD, com as dimensões de H
+ * @param H a matriz a ser decomposta
+ * @param U um ponteiro para a matriz U resultante (Nr x min(Nr, Nt))
+ * @param S um ponteiro para o vetor S resultante (min(Nr, Nt) posições)
+ * @param V um ponteiro para a matriz V resultante (Nt x min(Nr, Nt))
+ */
+void svd_com_contexto(svd_contexto *ctx, double **H, double **U, double *S, double **V);
+
 /**
  * Realiza a decomposição em valores singulares (SVD) da matriz transposta de canal.
  *
+ * Cria e destrói um contexto a cada chamada; para decomposições repetidas use svd_com_contexto.
+ *
  * @param H a matriz a ser decomposta
  * @param Nr o número de receptores
  * @param Nt o número de transmissores
@@ -94,6 +293,33 @@ double complex **channel_transmission(double complex **data, int size, int num_s
  */
 void svd(double **H, int Nr, int Nt, double **U, double *S, double **V);
 
+/**
+ * Realiza a decomposição em valores singulares (SVD) de uma matriz de canal complexa usando um contexto já criado.
+ *
+ * @param ctx o contexto de SVD, com as dimensões de H
+ * @param H a matriz a ser decomposta
+ * @param U um ponteiro para a matriz U resultante (Nr x min(Nr, Nt))
+ * @param S um ponteiro para o vetor S resultante (min(Nr, Nt) posições)
+ * @param V um ponteiro para a matriz V resultante (Nt x min(Nr, Nt))
+ */
+void svd_complexa_com_contexto(svd_contexto *ctx, double complex **H, double complex **U, double *S, double complex **V);
+
+/**
+ * Realiza a decomposição em valores singulares (SVD) de uma matriz de canal complexa.
+ *
+ * A decomposição H = U diag(S) V^H é feita diretamente sobre os números complexos
+ * (Jacobi unilateral), sem a matriz real equivalente 2Nr x 2Nt. Com k = min(Nr, Nt),
+ * U é Nr x k, S tem k posições e V é Nt x k.
+ *
+ * @param H a matriz a ser decomposta
+ * @param Nr o número de receptores
+ * @param Nt o número de transmissores
+ * @param U um ponteiro para a matriz U resultante
+ * @param S um ponteiro para o vetor S resultante
+ * @param V um ponteiro para a matriz V resultante
+ */
+void svd_complexa(double complex **H, int Nr, int Nt, double complex **U, double *S, double complex **V);
+
 /**
  * Pré-codifica os dados utilizando a matriz V resultante da decomposição SVD.
  *
@@ -105,6 +331,41 @@ void svd(double **H, int Nr, int Nt, double **U, double *S, double **V);
  */
 double complex **tx_precoder(double complex **data, int size, int num_streams, double **V);
 
+/**
+ * Pré-codifica os dados em streams já alocados pelo chamador.
+ *
+ * @param data os streams de entrada
+ * @param len o número de símbolos de cada stream
+ * @param num_streams o número de streams
+ * @param V a matriz V da decomposição SVD
+ * @param result os streams de saída (alocados pelo chamador)
+ */
+void tx_precoder_em(double complex **data, long len, int num_streams, double **V, double complex **result);
+
+/**
+ * Monta a conjugada transposta de uma matriz real no formato contíguo complexo.
+ *
+ * Feito uma vez por canal, dá a matriz de tx_precoder_matriz_em (com V) e de
+ * rx_combiner_matriz_em (com U).
+ *
+ * @param A a matriz (linhas x colunas)
+ * @param linhas o número de linhas de A
+ * @param colunas o número de colunas de A
+ * @param w a matriz de saída A^H (colunas x linhas, 2 * linhas * colunas posições)
+ */
+void coeficientes_hermitiana(double **A, int linhas, int colunas, double *w);
+
+/**
+ * Pré-codifica os dados com a matriz W = V^H já montada, como o produto W x feito por zgemm_streams.
+ *
+ * @param data os streams de entrada
+ * @param len o número de símbolos de cada stream
+ * @param num_streams o número de streams
+ * @param w a matriz W (num_streams x num_streams, complexa, intercalada, por linhas)
+ * @param result os streams de saída (alocados pelo chamador, distintos de data)
+ */
+void tx_precoder_matriz_em(double complex **data, long len, int num_streams, const double *w, double complex **result);
+
 /**
  * Combina os dados recebidos utilizando a matriz U resultante da decomposição SVD.
  *
@@ -116,6 +377,28 @@ double complex **tx_precoder(double complex **data, int size, int num_streams, d
  */
 double complex **rx_combiner(double complex **data, int size, int num_streams, double **U);
 
+/**
+ * Combina os dados recebidos em streams já alocados pelo chamador.
+ *
+ * @param data os streams de entrada
+ * @param len o número de símbolos de cada stream
+ * @param num_streams o número de streams
+ * @param U a matriz U da decomposição SVD
+ * @param result os streams de saída (alocados pelo chamador)
+ */
+void rx_combiner_em(double complex **data, long len, int num_streams, double **U, double complex **result);
+
+/**
+ * Combina os dados recebidos com a matriz W = U^H já montada, como o produto W y feito por zgemm_streams.
+ *
+ * @param data os streams de entrada
+ * @param len o número de símbolos de cada stream
+ * @param num_streams o número de streams
+ * @param w a matriz W (num_streams x num_streams, complexa, intercalada, por linhas)
+ * @param result os streams de saída (alocados pelo chamador, distintos de data)
+ */
+void rx_combiner_matriz_em(double complex **data, long len, int num_streams, const double *w, double complex **result);
+
 /**
  * Realiza o demapeamento em camada dos dados.
  *
@@ -137,14 +420,46 @@ double complex *rx_layer_demapper(double complex **data, int size, int num_strea
  */
 double complex **rx_feq(double complex **data, int size, int num_streams, double *S);
 
+/**
+ * Realiza a equalização dos dados recebidos em streams já alocados pelo chamador.
+ *
+ * @param data os streams de entrada
+ * @param len o número de símbolos de cada stream
+ * @param num_streams o número de streams
+ * @param S o vetor S da decomposição SVD
+ * @param result os streams equalizados (alocados pelo chamador; podem ser os próprios data)
+ */
+void rx_feq_em(double complex **data, long len, int num_streams, double *S, double complex **result);
+
+/**
+ * Realiza a equalização com os inversos dos valores singulares já calculados (ver cache_svd.h).
+ *
+ * @param data os streams de entrada
+ * @param len o número de símbolos de cada stream
+ * @param num_streams o número de streams
+ * @param inv_S os inversos dos valores singulares (0 para valores singulares nulos)
+ * @param result os streams equalizados (alocados pelo chamador; podem ser os próprios data)
+ */
+void rx_feq_inverso_em(double complex **data, long len, int num_streams, const double *inv_S, double complex **result);
+
 /**
  * Demapeia os símbolos QAM para obter os índices dos dados recebidos.
  *
  * @param data um ponteiro para o array de dados
  * @param size o tamanho do array de dados
- * @return um ponteiro para o array de índices demapeados
+ * @return um ponteiro para os índices demapeados, empacotados
  */
-int *rx_qam_demapper(double complex *data, int size);
+uint8_t *rx_qam_demapper(double complex *data, int size);
+
+/**
+ * Demapeia (decisão abrupta) símbolos de uma constelação M-QAM quadrada de energia unitária.
+ *
+ * @param data os símbolos equalizados
+ * @param size o número de símbolos
+ * @param M o número de pontos da constelação (4, 16, 64, 256 ou 1024)
+ * @return um ponteiro para os bits demapeados, empacotados (log2(M) bits por símbolo)
+ */
+uint8_t *rx_qam_demapper_M(double complex *data, int size, int M);
 
 /**
  * Remove o preenchimento dos dados.
@@ -157,22 +472,149 @@ int *rx_qam_demapper(double complex *data, int size);
  */
 double complex *rx_data_depadding(double complex *data, int size, int num_streams, int Nt);
 
+/**
+ * Calcula as LLRs (max-log) dos bits recebidos, para uso por um decodificador de canal.
+ *
+ * O ruído do stream i depois do combinador e da equalização tem variância
+ * ruido_variancia / S_i^2. As LLRs saem na ordem dos bits transmitidos, log2(M) por
+ * símbolo; LLR positiva favorece o bit 0.
+ *
+ * @param data os streams equalizados (saída de rx_feq)
+ * @param len o número de símbolos de cada stream
+ * @param num_streams o número de streams
+ * @param S o vetor S da decomposição SVD
+ * @param ruido_variancia a variância do ruído complexo em cada receptor (E|ruído|^2)
+ * @param M o número de pontos da constelação (4, 16, 64, 256 ou 1024)
+ * @param llr o vetor de saída, com len * num_streams * log2(M) posições
+ */
+void rx_llr_demapper(double complex **data, long len, int num_streams, double *S, double ruido_variancia, int M, float *llr);
+
+/**
+ * Versão de rx_llr_demapper com LLRs quantizadas em int8 (multiplicadas por escala e saturadas em ±127).
+ *
+ * @param data os streams equalizados (saída de rx_feq)
+ * @param len o número de símbolos de cada stream
+ * @param num_streams o número de streams
+ * @param S o vetor S da decomposição SVD
+ * @param ruido_variancia a variância do ruído complexo em cada receptor (E|ruído|^2)
+ * @param M o número de pontos da constelação (4, 16, 64, 256 ou 1024)
+ * @param escala o fator de quantização
+ * @param llr o vetor de saída, com len * num_streams * log2(M) posições
+ */
+void rx_llr_demapper_int8(double complex **data, long len, int num_streams, double *S, double ruido_variancia, int M, double escala, int8_t *llr);
+
+/**
+ * Variância do ruído complexo gerado por channel_transmission (a de uma uniforme em [ruido_min, ruido_max] em cada eixo).
+ *
+ * @param ruido_min o valor mínimo do ruído
+ * @param ruido_max o valor máximo do ruído
+ * @return E|ruído|^2
+ */
+double ruido_variancia_uniforme(double ruido_min, double ruido_max);
+
 /**
  * Salva os índices dos dados recebidos em um arquivo.
  *
- * @param tx_indices um ponteiro para o array de índices
- * @param size o tamanho do array de índices
+ * O último byte incompleto, se houver, é escrito com os bits que sobram zerados.
+ *
+ * @param data os índices empacotados
+ * @param size o número de símbolos
  * @param filename o nome do arquivo de saída
  */
-void rx_data_write(int *data, int size, char *filename);
+void rx_data_write(const uint8_t *data, int size, char *filename);
 
 /**
  * Gera estatísticas de erro de transmissão.
  *
- * @param tx_indices um ponteiro para o array de índices transmitidos
- * @param rx_indices um ponteiro para o array de índices recebidos
- * @param size o tamanho dos arrays de índices
+ * @param tx_indices os índices transmitidos, empacotados
+ * @param rx_indices os índices recebidos, empacotados
+ * @param size o número de símbolos
+ */
+void gera_estatisticas(const uint8_t *tx_indices, const uint8_t *rx_indices, int size);
+
+/**
+ * Imprime as estatísticas de erro a partir das contagens já feitas.
+ *
+ * @param num_simbolos o número de símbolos QAM transmitidos
+ * @param num_errors o número de símbolos QAM recebidos com erro
+ */
+void gera_estatisticas_contagem(int64_t num_simbolos, int64_t num_errors);
+
+/**
+ * Transmite um arquivo inteiro pela cadeia MIMO em blocos de tamanho fixo (modo streaming).
+ *
+ * A memória usada depende só do tamanho do bloco, não do tamanho do arquivo, e as
+ * contagens são de 64 bits. Supõe Nr = Nt = num_streams.
+ *
+ * @param entrada o nome do arquivo de entrada
+ * @param saida o nome do arquivo de saída
+ * @param bloco o número de bytes da entrada por bloco (arredondado para baixo a um múltiplo de log2(M))
+ * @param M o número de pontos da constelação (4, 16, 64, 256 ou 1024)
+ * @param num_streams o número de streams
+ * @param H a matriz de canal
+ * @param Nr o número de receptores
+ * @param Nt o número de transmissores
+ * @param V a matriz V da decomposição SVD (pré-codificador)
+ * @param U a matriz U da decomposição SVD (combinador)
+ * @param S o vetor S da decomposição SVD (equalizador)
+ * @param ruido_min o valor mínimo do ruído
+ * @param ruido_max o valor máximo do ruído
+ * @param snr_tipo SNR_NENHUMA (ruído de ruido_min e ruido_max), SNR_ES_N0 ou SNR_EB_N0
+ * @param snr_db a SNR em dB, recalibrada em cada bloco pela potência transmitida
+ * @param saida_direta se diferente de zero, tenta escrever a saída com O_DIRECT
+ * @param num_simbolos recebe o número de símbolos transmitidos
+ * @param num_errors recebe o número de símbolos recebidos com erro
+ */
+void transmissao_streaming(char *entrada, char *saida, long bloco, int M, int num_streams, double **H, int Nr, int Nt, double **V, double **U, double *S, double ruido_min, double ruido_max, int snr_tipo, double snr_db, int saida_direta, int64_t *num_simbolos, int64_t *num_errors);
+
+/**
+ * Configuração de uma simulação de Monte Carlo (ver simulacao_monte_carlo).
+ */
+typedef struct {
+    int M;            /**< Número de pontos da constelação. */
+    int num_streams;  /**< Número de streams (igual a Nr e Nt). */
+    int Nr;           /**< Número de receptores. */
+    int Nt;           /**< Número de transmissores. */
+    int snr_tipo;     /**< SNR_ES_N0 ou SNR_EB_N0. */
+    long simbolos;    /**< Símbolos transmitidos por realização em cada ponto de SNR. */
+    long realizacoes; /**< Realizações independentes do canal por ponto de SNR. */
+    int threads;      /**< Número de threads (0 usa todos os processadores). */
+    long coerencia;   /**< Realizações consecutivas com o mesmo canal (0 ou 1: canal próprio em cada uma). */
+    const modelo_canal *canal; /**< Modelo de canal complexo (Nr x Nt), ou NULL para o canal real de channel_gen_realizacao. */
+    long intervalo_canal; /**< Com Doppler no modelo: símbolos por stream entre atualizações do canal (intervalo_canal * num_streams múltiplo de 64). */
+} simulacao_config;
+
+/**
+ * Contagens de um ponto de SNR da simulação de Monte Carlo.
+ */
+typedef struct {
+    double snr_db;          /**< A SNR do ponto, em dB. */
+    int64_t simbolos;       /**< Símbolos transmitidos. */
+    int64_t erros_simbolo;  /**< Símbolos recebidos com erro. */
+    int64_t bits;           /**< Bits transmitidos. */
+    int64_t erros_bit;      /**< Bits recebidos com erro. */
+} simulacao_ponto;
+
+/**
+ * Simulação de Monte Carlo da taxa de erro de bit e de símbolo em vários pontos de SNR.
+ *
+ * Cada realização gera o canal e a SVD uma vez e transmite, em cada ponto de SNR,
+ * cfg->simbolos símbolos de bits aleatórios pela cadeia completa. Com desvanecimento
+ * em blocos (cfg->coerencia > 1), as realizações de um mesmo bloco compartilham o canal,
+ * e a SVD é reaproveitada de um cache por thread. Com cfg->canal, o canal do bloco q é a
+ * realização q do modelo (modelo_canal_gera), complexa, no lugar da real. Se o modelo
+ * tiver Doppler (exige cfg->coerencia <= 1), cada realização amostra a sua trajetória a
+ * cada cfg->intervalo_canal símbolos por stream (modelo_canal_gera_instantes), e a SVD de
+ * cada intervalo acompanha a do anterior (svd_contexto_acompanha). As realizações são
+ * distribuídas entre as threads, que têm buffers e contadores próprios, somados no
+ * final. O resultado não depende do número de threads (gerador por contador).
+ *
+ * @param cfg a configuração da simulação (exige Nr = Nt = num_streams, também no modelo de canal)
+ * @param snr_db os pontos de SNR, em dB
+ * @param num_snr o número de pontos
+ * @param resultados o vetor de saída, com num_snr posições
+ * @return 0 em caso de sucesso, -1 se a configuração for inválida
  */
-void gera_estatisticas(int *tx_indices, int *rx_indices, int size);
+int simulacao_monte_carlo(const simulacao_config *cfg, const double *snr_db, int num_snr, simulacao_ponto *resultados);
 
 #endif /* PDS_TELECOM_H */
\ No newline at end of file
@@ -0,0 +1,339 @@
+/// @file ruido_gaussiano.c
+/// @brief Ruído gaussiano por contador: Philox4x32-10 vetorizado e Ziggurat com caminho rápido em AVX2.
+
+#include <math.h>
+#include <string.h>
+#include "ruido_gaussiano.h"
+#include "../matrizes/simd_complexo.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define RUIDO_X86 1
+#include <immintrin.h>
+#else
+#define RUIDO_X86 0
+#endif
+
+/// Número de palavras uniformes geradas de cada vez.
+
+#define RUIDO_TRECHO 512
+
+/// Número de camadas do Ziggurat (a camada é escolhida com 7 bits de cada palavra).
+
+#define ZIG_CAMADAS 128
+
+/// Início da cauda (borda direita da primeira camada retangular) para 128 camadas.
+
+#define ZIG_R 3.442619855899
+
+/// Área de cada camada para 128 camadas.
+
+#define ZIG_V 9.91256303526217e-3
+
+/* Bordas das camadas: zig_x[0] = V / f(R) é a largura da camada de base (que inclui a
+   cauda), zig_x[1] = R e zig_x[128] = 0; zig_f[i] = f(zig_x[i]), com f(x) = exp(-x²/2). */
+
+static double zig_x[ZIG_CAMADAS + 1];
+static double zig_f[ZIG_CAMADAS + 1];
+
+/// Calcula as bordas das camadas na inicialização do programa.
+
+__attribute__((constructor))
+static void ruido_inicializa(void) {
+    double f_r = exp(-0.5 * ZIG_R * ZIG_R);
+
+    zig_x[0] = ZIG_V / f_r;
+    zig_x[1] = ZIG_R;
+    for (int i = 1; i < ZIG_CAMADAS - 1; i++) {
+        zig_x[i + 1] = sqrt(-2 * log(ZIG_V / zig_x[i] + exp(-0.5 * zig_x[i] * zig_x[i])));
+    }
+    zig_x[ZIG_CAMADAS] = 0;
+    for (int i = 0; i <= ZIG_CAMADAS; i++) {
+        zig_f[i] = exp(-0.5 * zig_x[i] * zig_x[i]);
+    }
+}
+
+/// Valor em [0, 1) com os 52 bits mais altos da palavra (montado direto no expoente de 1.0).
+
+static inline double abscissa(uint64_t r) {
+    uint64_t bits = (r >> 12) | 0x3ff0000000000000;
+    double d;
+
+    memcpy(&d, &bits, sizeof d);
+    return d - 1.0;
+}
+
+/* Philox4x32-10: cada rodada multiplica as palavras 0 e 2 do contador por constantes
+   (produto de 64 bits), troca as metades e mistura a chave, incrementada a cada rodada. */
+
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+#define PHILOX_RODADAS 10
+
+/// Bit da palavra 1 do contador que separa as palavras das rejeições das palavras do fluxo.
+
+#define FLUXO_REJEICAO (1u << 31)
+
+void ruido_philox(const uint32_t contador[4], const uint32_t chave[2], uint32_t saida[4]) {
+    uint32_t c0 = contador[0], c1 = contador[1], c2 = contador[2], c3 = contador[3];
+    uint32_t k0 = chave[0], k1 = chave[1];
+
+    for (int r = 0; r < PHILOX_RODADAS; r++) {
+        uint64_t p0 = (uint64_t) PHILOX_M0 * c0;
+        uint64_t p1 = (uint64_t) PHILOX_M1 * c2;
+
+        c0 = (uint32_t) (p1 >> 32) ^ c1 ^ k0;
+        c1 = (uint32_t) p1;
+        c2 = (uint32_t) (p0 >> 32) ^ c3 ^ k1;
+        c3 = (uint32_t) p0;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    saida[0] = c0;
+    saida[1] = c1;
+    saida[2] = c2;
+    saida[3] = c3;
+}
+
+/// As duas palavras do bloco b de um fluxo; alto é somado aos bits altos da palavra 1 do contador.
+
+static inline void bloco_fluxo(const ruido_fluxo *f, uint64_t b, uint32_t alto, uint64_t *w) {
+    uint32_t contador[4] = { (uint32_t) b, (uint32_t) (b >> 32) | alto, f->fluxo, f->realizacao };
+    uint32_t chave[2] = { (uint32_t) f->semente, (uint32_t) (f->semente >> 32) };
+    uint32_t saida[4];
+
+    ruido_philox(contador, chave, saida);
+    w[0] = saida[0] | (uint64_t) saida[1] << 32;
+    w[1] = saida[2] | (uint64_t) saida[3] << 32;
+}
+
+/// Fonte das palavras extras consumidas por uma rejeição.
+
+typedef uint64_t (*fonte_palavras)(void *estado);
+
+/// Resolve uma palavra rejeitada pelo caminho rápido, com novas palavras da fonte.
+
+/// Bits da palavra: 3 a 9 escolhem a camada, o bit 10 o sinal e os 52 mais altos a
+/// abscissa (os 3 bits mais baixos não são usados).
+
+static double rejeicao(uint64_t r, fonte_palavras proxima, void *estado) {
+    for (;;) {
+        int i = (r >> 3) & (ZIG_CAMADAS - 1);
+        int negativo = (r >> 10) & 1;
+        double x = abscissa(r) * zig_x[i];
+
+        if (x < zig_x[i + 1]) {
+            return negativo ? -x : x;
+        }
+        if (i == 0) {
+            double a, b;
+            do {
+                a = -log(1.0 - abscissa(proxima(estado))) / ZIG_R;
+                b = -log(1.0 - abscissa(proxima(estado)));
+            } while (b + b < a * a);
+            return negativo ? -(ZIG_R + a) : ZIG_R + a;
+        }
+        if (zig_f[i + 1] + abscissa(proxima(estado)) * (zig_f[i] - zig_f[i + 1]) < exp(-0.5 * x * x)) {
+            return negativo ? -x : x;
+        }
+        r = proxima(estado);
+    }
+}
+
+/// Resolve a rejeição da palavra r, na posição p do trecho em conversão.
+
+typedef double (*resolve_rejeicao)(void *contexto, long p, uint64_t r);
+
+/// Converte as palavras r[inicio..n) em amostras x[inicio..n).
+
+static inline __attribute__((always_inline))
+void converte_escalar(resolve_rejeicao resolve, void *contexto, const uint64_t *r, double *x, long inicio, long n, double media, double desvio) {
+    for (long p = inicio; p < n; p++) {
+        int i = (r[p] >> 3) & (ZIG_CAMADAS - 1);
+        double v = abscissa(r[p]) * zig_x[i];
+
+        if (v < zig_x[i + 1]) {
+            v = (r[p] >> 10) & 1 ? -v : v;
+        } else {
+            v = resolve(contexto, p, r[p]);
+        }
+        x[p] = media + desvio * v;
+    }
+}
+
+#if RUIDO_X86
+
+/// Caminho rápido do Ziggurat em grupos de 4 palavras; as posições rejeitadas são
+/// resolvidas em ordem por rejeicao, como na versão escalar.
+
+static inline __attribute__((always_inline, target("avx2")))
+void converte_avx2(resolve_rejeicao resolve, void *contexto, const uint64_t *r, double *x, long n, double media, double desvio) {
+    const __m256i camada = _mm256_set1_epi64x(ZIG_CAMADAS - 1);
+    const __m256i um = _mm256_set1_epi64x(0x3ff0000000000000);
+    const __m256d vmedia = _mm256_set1_pd(media), vdesvio = _mm256_set1_pd(desvio);
+    long p = 0;
+
+    for (; p + 4 <= n; p += 4) {
+        __m256i w = _mm256_loadu_si256((const __m256i*) (r + p));
+        __m256i i = _mm256_and_si256(_mm256_srli_epi64(w, 3), camada);
+        __m256d borda = _mm256_i64gather_pd(zig_x, i, 8);
+        __m256d interna = _mm256_i64gather_pd(zig_x + 1, i, 8);
+        __m256d u = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(w, 12), um)), _mm256_set1_pd(1.0));
+        __m256d v = _mm256_mul_pd(u, borda);
+        int aceitos = _mm256_movemask_pd(_mm256_cmp_pd(v, interna, _CMP_LT_OQ));
+
+        v = _mm256_xor_pd(v, _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_srli_epi64(w, 10), 63)));
+        if (aceitos != 0xf) {
+            double t[4];
+            _mm256_storeu_pd(t, v);
+            for (int k = 0; k < 4; k++) {
+                if (!(aceitos >> k & 1)) {
+                    t[k] = resolve(contexto, p + k, r[p + k]);
+                }
+            }
+            v = _mm256_loadu_pd(t);
+        }
+        _mm256_storeu_pd(x + p, _mm256_add_pd(vmedia, _mm256_mul_pd(vdesvio, v)));
+    }
+    converte_escalar(resolve, contexto, r, x, p, n, media, desvio);
+}
+
+#endif
+
+static void blocos_escalar(const ruido_fluxo *f, uint64_t b, long blocos, uint64_t *w) {
+    for (long j = 0; j < blocos; j++) {
+        bloco_fluxo(f, b + j, 0, w + 2 * j);
+    }
+}
+
+#if RUIDO_X86
+
+/// Quatro blocos consecutivos por vez, um por posição de 64 bits (cada palavra de 32 bits
+/// do contador ocupa a metade baixa da posição, o formato de entrada de _mm256_mul_epu32).
+
+__attribute__((target("avx2")))
+static void blocos_avx2(const ruido_fluxo *f, uint64_t b, long blocos, uint64_t *w) {
+    const __m256i baixo = _mm256_set1_epi64x(0xffffffff);
+    const __m256i m0 = _mm256_set1_epi64x(PHILOX_M0), m1 = _mm256_set1_epi64x(PHILOX_M1);
+    __m256i k0[PHILOX_RODADAS], k1[PHILOX_RODADAS];
+    __m256i indice = _mm256_add_epi64(_mm256_set1_epi64x(b), _mm256_setr_epi64x(0, 1, 2, 3));
+    __m256i fluxo = _mm256_set1_epi64x(f->fluxo), realizacao = _mm256_set1_epi64x(f->realizacao);
+    uint32_t c0 = (uint32_t) f->semente, c1 = (uint32_t) (f->semente >> 32);
+    long j = 0;
+
+    for (int r = 0; r < PHILOX_RODADAS; r++) {
+        k0[r] = _mm256_set1_epi64x(c0);
+        k1[r] = _mm256_set1_epi64x(c1);
+        c0 += PHILOX_W0;
+        c1 += PHILOX_W1;
+    }
+    for (; j + 4 <= blocos; j += 4) {
+        __m256i x0 = _mm256_and_si256(indice, baixo), x1 = _mm256_srli_epi64(indice, 32);
+        __m256i x2 = fluxo, x3 = realizacao;
+
+        for (int r = 0; r < PHILOX_RODADAS; r++) {
+            __m256i p0 = _mm256_mul_epu32(x0, m0);
+            __m256i p1 = _mm256_mul_epu32(x2, m1);
+
+            x0 = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(p1, 32), x1), k0[r]);
+            x1 = _mm256_and_si256(p1, baixo);
+            x2 = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(p0, 32), x3), k1[r]);
+            x3 = _mm256_and_si256(p0, baixo);
+        }
+        __m256i w0 = _mm256_or_si256(x0, _mm256_slli_epi64(x1, 32));
+        __m256i w1 = _mm256_or_si256(x2, _mm256_slli_epi64(x3, 32));
+        __m256i pares = _mm256_unpacklo_epi64(w0, w1), impares = _mm256_unpackhi_epi64(w0, w1);
+        _mm256_storeu_si256((__m256i*) (w + 2 * j), _mm256_permute2x128_si256(pares, impares, 0x20));
+        _mm256_storeu_si256((__m256i*) (w + 2 * j + 4), _mm256_permute2x128_si256(pares, impares, 0x31));
+        indice = _mm256_add_epi64(indice, _mm256_set1_epi64x(4));
+    }
+    blocos_escalar(f, b + j, blocos - j, w + 2 * j);
+}
+
+#endif
+
+static void blocos(const ruido_fluxo *f, uint64_t b, long n, uint64_t *w) {
+#if RUIDO_X86
+    if (simd_nivel() >= SIMD_AVX2) {
+        blocos_avx2(f, b, n, w);
+        return;
+    }
+#endif
+    blocos_escalar(f, b, n, w);
+}
+
+/// Palavras extras da rejeição da amostra na posição posicao: os blocos 0 a 127 do
+/// contador (posicao, FLUXO_REJEICAO | bloco << 24, fluxo, realização).
+
+typedef struct {
+    const ruido_fluxo *fluxo;
+    uint64_t posicao;
+    uint32_t indice;
+} fonte_contador;
+
+static uint64_t proxima_contador(void *estado) {
+    fonte_contador *fonte = estado;
+    uint64_t w[2];
+
+    bloco_fluxo(fonte->fluxo, fonte->posicao, FLUXO_REJEICAO | ((fonte->indice >> 1) & 127) << 24, w);
+    return w[fonte->indice++ & 1];
+}
+
+/// Trecho em conversão: o fluxo e a posição da primeira palavra.
+
+typedef struct {
+    const ruido_fluxo *fluxo;
+    uint64_t posicao;
+} trecho_contador;
+
+static double rejeicao_contador(void *contexto, long p, uint64_t r) {
+    trecho_contador *trecho = contexto;
+    fonte_contador fonte = { trecho->fluxo, trecho->posicao + p, 0 };
+
+    return rejeicao(r, proxima_contador, &fonte);
+}
+
+#if RUIDO_X86
+
+__attribute__((target("avx2")))
+static void converte_trecho_avx2(trecho_contador *trecho, const uint64_t *w, double *x, long m, double media, double desvio) {
+    converte_avx2(rejeicao_contador, trecho, w, x, m, media, desvio);
+}
+
+#endif
+
+static void converte_trecho(trecho_contador *trecho, const uint64_t *w, double *x, long m, double media, double desvio) {
+#if RUIDO_X86
+    if (simd_nivel() >= SIMD_AVX2) {
+        converte_trecho_avx2(trecho, w, x, m, media, desvio);
+        return;
+    }
+#endif
+    converte_escalar(rejeicao_contador, trecho, w, x, 0, m, media, desvio);
+}
+
+void ruido_fluxo_gaussiano(const ruido_fluxo *f, uint64_t posicao, double *x, long n, double media, double desvio) {
+    uint64_t w[RUIDO_TRECHO + 2];
+
+    for (long p = 0; p < n; p += RUIDO_TRECHO) {
+        long m = n - p < RUIDO_TRECHO ? n - p : RUIDO_TRECHO;
+        trecho_contador trecho = { f, posicao + p };
+        int impar = trecho.posicao & 1;
+
+        blocos(f, trecho.posicao >> 1, (impar + m + 1) / 2, w);
+        converte_trecho(&trecho, w + impar, x + p, m, media, desvio);
+    }
+}
+
+void ruido_fluxo_uniforme(const ruido_fluxo *f, uint64_t posicao, uint64_t *r, long n) {
+    uint64_t w[RUIDO_TRECHO + 2];
+
+    for (long p = 0; p < n; p += RUIDO_TRECHO) {
+        long m = n - p < RUIDO_TRECHO ? n - p : RUIDO_TRECHO;
+        int impar = (posicao + p) & 1;
+
+        blocos(f, (posicao + p) >> 1, (impar + m + 1) / 2, w);
+        memcpy(r + p, w + impar, sizeof(uint64_t) * m);
+    }
+}
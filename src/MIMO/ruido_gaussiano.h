@@ -0,0 +1,50 @@
+/// @file ruido_gaussiano.h
+/// @brief Geração de ruído gaussiano por contador: Philox4x32-10 e Ziggurat.
+
+/// O gerador uniforme é Philox4x32-10: a palavra p de um fluxo é uma função pura de
+/// (semente, realização, fluxo, p), então qualquer trecho de qualquer fluxo pode ser
+/// gerado isoladamente, em qualquer ordem ou thread, com o mesmo resultado de uma geração
+/// sequencial. A palavra p é a metade p % 2 da saída de Philox para o contador
+/// (p / 2, fluxo, realização) com a semente como chave; quatro contadores são cifrados
+/// juntos em AVX2.
+
+/// A conversão para a normal usa o método Ziggurat com 128 camadas: cada palavra de 64
+/// bits dá a camada, o sinal e a abscissa, e em cerca de 99% dos casos o valor é aceito
+/// com uma comparação, sem logaritmos nem exponenciais. O caminho rápido é feito quatro
+/// palavras por vez (gather das bordas das camadas em AVX2); as poucas rejeições, e a
+/// cauda, usam contadores próprios da amostra rejeitada, de modo que cada amostra depende
+/// apenas da sua posição e o resultado é o mesmo em qualquer nível SIMD.
+
+#ifndef RUIDO_GAUSSIANO_H
+#define RUIDO_GAUSSIANO_H
+
+#include <stdint.h>
+
+/// @brief Aplica Philox4x32-10 a um contador de 128 bits.
+
+/// @param contador O contador (4 palavras de 32 bits).
+/// @param chave A chave (2 palavras de 32 bits).
+/// @param saida As 4 palavras de saída.
+
+void ruido_philox(const uint32_t contador[4], const uint32_t chave[2], uint32_t saida[4]);
+
+/// @brief Identificação de um fluxo do gerador por contador.
+
+typedef struct {
+    uint64_t semente;    /**< Chave de Philox. */
+    uint32_t realizacao; /**< Realização (por exemplo, o índice da simulação de Monte Carlo). */
+    uint32_t fluxo;      /**< Fluxo dentro da realização (por exemplo, a antena). */
+} ruido_fluxo;
+
+/// @brief Palavras posicao a posicao + n - 1 de um fluxo (posições menores que 2^56).
+
+void ruido_fluxo_uniforme(const ruido_fluxo *f, uint64_t posicao, uint64_t *r, long n);
+
+/// @brief Amostras gaussianas posicao a posicao + n - 1 de um fluxo, com média media e desvio padrão desvio.
+
+/// O resultado de cada posição não depende de como o fluxo é dividido em chamadas nem do
+/// nível SIMD. O ruído do símbolo j de um vetor complexo ocupa as posições 2j e 2j + 1.
+
+void ruido_fluxo_gaussiano(const ruido_fluxo *f, uint64_t posicao, double *x, long n, double media, double desvio);
+
+#endif // RUIDO_GAUSSIANO_H
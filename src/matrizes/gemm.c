@@ -0,0 +1,1062 @@
+/// @file gemm.c
+/// @brief Implementação do produto matricial complexo em blocos (estilo GotoBLAS/BLIS).
+
+/// O produto é dividido em três níveis de blocagem. Um bloco KC x NC de b é
+/// empacotado em micro-painéis de NR colunas (cabe na L3), um bloco MC x KC de a é
+/// empacotado em micro-painéis de MR linhas (cabe na L2) e o micro-kernel percorre um
+/// micro-painel de a contra um de b (cabe na L1), mantendo o bloco MR x NR de r em
+/// registradores. No painel de b as partes real e imaginária ficam separadas, de forma
+/// que o micro-kernel só faz multiplicações e somas, sem embaralhar elementos.
+
+#include <stdlib.h>
+#include <string.h>
+#include "gemm.h"
+#include "simd_complexo.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define GEMM_X86 1
+#include <immintrin.h>
+#else
+#define GEMM_X86 0
+#endif
+
+///Linhas de a (em números complexos) por bloco empacotado; dimensionado para a L2.
+#define GEMM_MC 96
+
+///Profundidade (em números complexos) dos painéis; dimensionado para a L1.
+#define GEMM_KC 256
+
+///Colunas de b (em números complexos) por bloco empacotado; dimensionado para a L3.
+#define GEMM_NC 2048
+
+///Maior MR suportado por qualquer micro-kernel.
+#define GEMM_MR_MAX 8
+
+///Maior NR suportado por qualquer micro-kernel.
+#define GEMM_NR_MAX 16
+
+///Abaixo deste número de multiplicações complexas o empacotamento não compensa.
+#define GEMM_LIMIAR_DIRETO (32 * 32 * 32)
+
+///Assinatura de um micro-kernel: calcula um bloco MR x NR de r a partir de um micro-painel de a e um de b.
+
+/// @param kc Profundidade dos painéis.
+/// @param ap Micro-painel de a: para cada k, MR pares (real, imag).
+/// @param bp Micro-painel de b: para cada k, NR partes reais seguidas de NR partes imaginárias.
+/// @param r Bloco de saída (intercalado).
+/// @param ldr Dimensão principal de r, em números complexos.
+/// @param acumula Se diferente de zero, soma ao conteúdo de r.
+
+typedef void (*gemm_micro_kernel)(int kc, const float* ap, const float* bp, float* r, int ldr, int acumula);
+
+///Descrição de um micro-kernel e do formato de painel que ele espera.
+typedef struct {
+    int mr;                   /**< Linhas do bloco de registradores. */
+    int nr;                   /**< Colunas do bloco de registradores. */
+    gemm_micro_kernel kernel; /**< Função do micro-kernel. */
+} gemm_kernel;
+
+///Micro-kernel genérico em C (4 x 8). O compilador consegue vetorizar o laço em j porque as partes real e imaginária de b estão separadas.
+
+static void micro_kernel_generico(int kc, const float* ap, const float* bp, float* r, int ldr, int acumula) {
+    enum { MR = 4, NR = 8 };
+    float acc_re[MR][NR] = {{0}};
+    float acc_im[MR][NR] = {{0}};
+    int p, i, j;
+
+    for (p = 0; p < kc; p++) {
+        for (i = 0; i < MR; i++) {
+            float ar = ap[2 * i];
+            float ai = ap[2 * i + 1];
+
+            for (j = 0; j < NR; j++) {
+                acc_re[i][j] += ar * bp[j] - ai * bp[NR + j];
+                acc_im[i][j] += ar * bp[NR + j] + ai * bp[j];
+            }
+        }
+        ap += 2 * MR;
+        bp += 2 * NR;
+    }
+
+    for (i = 0; i < MR; i++) {
+        float* ri = r + 2 * (size_t) i * ldr;
+
+        for (j = 0; j < NR; j++) {
+            if (acumula) {
+                ri[2 * j] += acc_re[i][j];
+                ri[2 * j + 1] += acc_im[i][j];
+            } else {
+                ri[2 * j] = acc_re[i][j];
+                ri[2 * j + 1] = acc_im[i][j];
+            }
+        }
+    }
+}
+
+///Descrição do micro-kernel genérico.
+static const gemm_kernel kernel_generico = { 4, 8, micro_kernel_generico };
+
+#if GEMM_X86
+
+///Atualiza uma linha do bloco de registradores: re += ar*br - ai*bi, im += ar*bi + ai*br.
+#define GEMM_LINHA_AVX2(i) { \
+    __m256 ar = _mm256_broadcast_ss(ap + 2 * (i)); \
+    __m256 ai = _mm256_broadcast_ss(ap + 2 * (i) + 1); \
+    re##i = _mm256_fnmadd_ps(ai, bi, _mm256_fmadd_ps(ar, br, re##i)); \
+    im##i = _mm256_fmadd_ps(ai, br, _mm256_fmadd_ps(ar, bi, im##i)); \
+}
+
+///Intercala as partes real e imaginária de uma linha do bloco e grava (ou acumula) em r.
+#define GEMM_GRAVA_AVX2(i) { \
+    float* ri = r + 2 * (size_t) (i) * ldr; \
+    __m256 lo = _mm256_unpacklo_ps(re##i, im##i); \
+    __m256 hi = _mm256_unpackhi_ps(re##i, im##i); \
+    __m256 r0 = _mm256_permute2f128_ps(lo, hi, 0x20); \
+    __m256 r1 = _mm256_permute2f128_ps(lo, hi, 0x31); \
+    if (acumula) { \
+        r0 = _mm256_add_ps(r0, _mm256_loadu_ps(ri)); \
+        r1 = _mm256_add_ps(r1, _mm256_loadu_ps(ri + 8)); \
+    } \
+    _mm256_storeu_ps(ri, r0); \
+    _mm256_storeu_ps(ri + 8, r1); \
+}
+
+///Micro-kernel AVX2 + FMA (6 x 8): 12 acumuladores, 2 registradores para b e 2 para a.
+
+__attribute__((target("avx2,fma")))
+static void micro_kernel_avx2(int kc, const float* ap, const float* bp, float* r, int ldr, int acumula) {
+    __m256 re0 = _mm256_setzero_ps(), im0 = _mm256_setzero_ps();
+    __m256 re1 = _mm256_setzero_ps(), im1 = _mm256_setzero_ps();
+    __m256 re2 = _mm256_setzero_ps(), im2 = _mm256_setzero_ps();
+    __m256 re3 = _mm256_setzero_ps(), im3 = _mm256_setzero_ps();
+    __m256 re4 = _mm256_setzero_ps(), im4 = _mm256_setzero_ps();
+    __m256 re5 = _mm256_setzero_ps(), im5 = _mm256_setzero_ps();
+    int p;
+
+    for (p = 0; p < kc; p++) {
+        __m256 br = _mm256_loadu_ps(bp);
+        __m256 bi = _mm256_loadu_ps(bp + 8);
+
+        GEMM_LINHA_AVX2(0)
+        GEMM_LINHA_AVX2(1)
+        GEMM_LINHA_AVX2(2)
+        GEMM_LINHA_AVX2(3)
+        GEMM_LINHA_AVX2(4)
+        GEMM_LINHA_AVX2(5)
+        ap += 12;
+        bp += 16;
+    }
+
+    GEMM_GRAVA_AVX2(0)
+    GEMM_GRAVA_AVX2(1)
+    GEMM_GRAVA_AVX2(2)
+    GEMM_GRAVA_AVX2(3)
+    GEMM_GRAVA_AVX2(4)
+    GEMM_GRAVA_AVX2(5)
+}
+
+///Descrição do micro-kernel AVX2.
+static const gemm_kernel kernel_avx2 = { 6, 8, micro_kernel_avx2 };
+
+///Atualiza uma linha do bloco de registradores AVX-512.
+#define GEMM_LINHA_AVX512(i) { \
+    __m512 ar = _mm512_set1_ps(ap[2 * (i)]); \
+    __m512 ai = _mm512_set1_ps(ap[2 * (i) + 1]); \
+    re##i = _mm512_fnmadd_ps(ai, bi, _mm512_fmadd_ps(ar, br, re##i)); \
+    im##i = _mm512_fmadd_ps(ai, br, _mm512_fmadd_ps(ar, bi, im##i)); \
+}
+
+///Intercala e grava uma linha do bloco AVX-512 (16 complexos = 2 registradores).
+#define GEMM_GRAVA_AVX512(i) { \
+    float* ri = r + 2 * (size_t) (i) * ldr; \
+    __m512 lo = _mm512_unpacklo_ps(re##i, im##i); \
+    __m512 hi = _mm512_unpackhi_ps(re##i, im##i); \
+    __m512 r0 = _mm512_permutex2var_ps(lo, ordem0, hi); \
+    __m512 r1 = _mm512_permutex2var_ps(lo, ordem1, hi); \
+    if (acumula) { \
+        r0 = _mm512_add_ps(r0, _mm512_loadu_ps(ri)); \
+        r1 = _mm512_add_ps(r1, _mm512_loadu_ps(ri + 16)); \
+    } \
+    _mm512_storeu_ps(ri, r0); \
+    _mm512_storeu_ps(ri + 16, r1); \
+}
+
+///Micro-kernel AVX-512 (8 x 16): 16 acumuladores de 512 bits.
+
+__attribute__((target("avx512f")))
+static void micro_kernel_avx512(int kc, const float* ap, const float* bp, float* r, int ldr, int acumula) {
+    const __m512i ordem0 = _mm512_set_epi32(23, 22, 21, 20, 7, 6, 5, 4, 19, 18, 17, 16, 3, 2, 1, 0);
+    const __m512i ordem1 = _mm512_set_epi32(31, 30, 29, 28, 15, 14, 13, 12, 27, 26, 25, 24, 11, 10, 9, 8);
+    __m512 re0 = _mm512_setzero_ps(), im0 = _mm512_setzero_ps();
+    __m512 re1 = _mm512_setzero_ps(), im1 = _mm512_setzero_ps();
+    __m512 re2 = _mm512_setzero_ps(), im2 = _mm512_setzero_ps();
+    __m512 re3 = _mm512_setzero_ps(), im3 = _mm512_setzero_ps();
+    __m512 re4 = _mm512_setzero_ps(), im4 = _mm512_setzero_ps();
+    __m512 re5 = _mm512_setzero_ps(), im5 = _mm512_setzero_ps();
+    __m512 re6 = _mm512_setzero_ps(), im6 = _mm512_setzero_ps();
+    __m512 re7 = _mm512_setzero_ps(), im7 = _mm512_setzero_ps();
+    int p;
+
+    for (p = 0; p < kc; p++) {
+        __m512 br = _mm512_loadu_ps(bp);
+        __m512 bi = _mm512_loadu_ps(bp + 16);
+
+        GEMM_LINHA_AVX512(0)
+        GEMM_LINHA_AVX512(1)
+        GEMM_LINHA_AVX512(2)
+        GEMM_LINHA_AVX512(3)
+        GEMM_LINHA_AVX512(4)
+        GEMM_LINHA_AVX512(5)
+        GEMM_LINHA_AVX512(6)
+        GEMM_LINHA_AVX512(7)
+        ap += 16;
+        bp += 32;
+    }
+
+    GEMM_GRAVA_AVX512(0)
+    GEMM_GRAVA_AVX512(1)
+    GEMM_GRAVA_AVX512(2)
+    GEMM_GRAVA_AVX512(3)
+    GEMM_GRAVA_AVX512(4)
+    GEMM_GRAVA_AVX512(5)
+    GEMM_GRAVA_AVX512(6)
+    GEMM_GRAVA_AVX512(7)
+}
+
+///Descrição do micro-kernel AVX-512.
+static const gemm_kernel kernel_avx512 = { 8, 16, micro_kernel_avx512 };
+
+#endif // GEMM_X86
+
+///Escolhe o micro-kernel de acordo com o conjunto de instruções em uso (simd_complexo.c).
+
+static const gemm_kernel* escolhe_kernel(void) {
+#if GEMM_X86
+    switch (simd_nivel()) {
+    case SIMD_AVX512:
+        return &kernel_avx512;
+    case SIMD_AVX2:
+        return &kernel_avx2;
+    default:
+        break;
+    }
+#endif
+    return &kernel_generico;
+}
+
+///Descrição de um operando: intercalado (im == NULL, re aponta para os pares) ou planar (re e im separados).
+typedef struct {
+    const float* re; /**< Pares (real, imag) ou, no formato planar, as partes reais. */
+    const float* im; /**< Partes imaginárias no formato planar; NULL no formato intercalado. */
+    int ld;          /**< Dimensão principal, em números complexos. */
+} gemm_operando;
+
+///Empacota um bloco mc x kc de a em micro-painéis de mr linhas, completando com zeros a última fatia.
+
+static void empacota_a(int mc, int kc, const gemm_operando* a, int i_ini, int p_ini, int mr, float* ap) {
+    int i0, i, p;
+
+    for (i0 = 0; i0 < mc; i0 += mr) {
+        int linhas = mc - i0 < mr ? mc - i0 : mr;
+
+        for (p = 0; p < kc; p++) {
+            size_t pos = (size_t) (i_ini + i0) * a->ld + p_ini + p;
+
+            if (a->im == NULL) {
+                for (i = 0; i < linhas; i++) {
+                    const float* x = a->re + 2 * (pos + (size_t) i * a->ld);
+
+                    ap[2 * i] = x[0];
+                    ap[2 * i + 1] = x[1];
+                }
+            } else {
+                for (i = 0; i < linhas; i++) {
+                    ap[2 * i] = a->re[pos + (size_t) i * a->ld];
+                    ap[2 * i + 1] = a->im[pos + (size_t) i * a->ld];
+                }
+            }
+            for (; i < mr; i++) {
+                ap[2 * i] = 0;
+                ap[2 * i + 1] = 0;
+            }
+            ap += 2 * mr;
+        }
+    }
+}
+
+///Empacota um bloco kc x nc de b em micro-painéis de nr colunas, separando parte real e imaginária e completando com zeros a última fatia. No formato planar cada linha do painel é uma cópia direta.
+
+static void empacota_b(int kc, int nc, const gemm_operando* b, int p_ini, int j_ini, int nr, float* bp) {
+    int j0, j, p;
+
+    for (j0 = 0; j0 < nc; j0 += nr) {
+        int colunas = nc - j0 < nr ? nc - j0 : nr;
+
+        for (p = 0; p < kc; p++) {
+            size_t pos = (size_t) (p_ini + p) * b->ld + j_ini + j0;
+
+            if (b->im == NULL) {
+                const float* x = b->re + 2 * pos;
+
+                for (j = 0; j < colunas; j++) {
+                    bp[j] = x[2 * j];
+                    bp[nr + j] = x[2 * j + 1];
+                }
+            } else {
+                memcpy(bp, b->re + pos, colunas * sizeof(float));
+                memcpy(bp + nr, b->im + pos, colunas * sizeof(float));
+                j = colunas;
+            }
+            for (; j < nr; j++) {
+                bp[j] = 0;
+                bp[nr + j] = 0;
+            }
+            bp += 2 * nr;
+        }
+    }
+}
+
+///Descrição da saída: intercalada (im == NULL) ou planar.
+typedef struct {
+    float* re; /**< Pares (real, imag) ou, no formato planar, as partes reais. */
+    float* im; /**< Partes imaginárias no formato planar; NULL no formato intercalado. */
+    int ld;    /**< Dimensão principal, em números complexos. */
+} gemm_saida;
+
+///Percorre os micro-painéis de um bloco empacotado. Blocos completos de saída intercalada são gravados direto pelo micro-kernel; bordas e saídas planares passam por um bloco temporário.
+
+static void macro_kernel(const gemm_kernel* k, int mc, int nc, int kc, const float* ap, const float* bp,
+                         const gemm_saida* r, int i_ini, int j_ini, int acumula) {
+    float borda[2 * GEMM_MR_MAX * GEMM_NR_MAX];
+    int ir, jr, i, j;
+
+    for (jr = 0; jr < nc; jr += k->nr) {
+        int colunas = nc - jr < k->nr ? nc - jr : k->nr;
+
+        for (ir = 0; ir < mc; ir += k->mr) {
+            int linhas = mc - ir < k->mr ? mc - ir : k->mr;
+            const float* a_painel = ap + 2 * (size_t) ir * kc;
+            const float* b_painel = bp + 2 * (size_t) jr * kc;
+            size_t pos = (size_t) (i_ini + ir) * r->ld + j_ini + jr;
+
+            if (r->im == NULL && linhas == k->mr && colunas == k->nr) {
+                k->kernel(kc, a_painel, b_painel, r->re + 2 * pos, r->ld, acumula);
+                continue;
+            }
+
+            k->kernel(kc, a_painel, b_painel, borda, k->nr, 0);
+            for (i = 0; i < linhas; i++) {
+                const float* origem = borda + 2 * i * k->nr;
+                size_t linha = pos + (size_t) i * r->ld;
+
+                if (r->im == NULL) {
+                    float* destino = r->re + 2 * linha;
+
+                    for (j = 0; j < 2 * colunas; j++) {
+                        destino[j] = acumula ? destino[j] + origem[j] : origem[j];
+                    }
+                } else {
+                    float* destino_re = r->re + linha;
+                    float* destino_im = r->im + linha;
+
+                    for (j = 0; j < colunas; j++) {
+                        destino_re[j] = acumula ? destino_re[j] + origem[2 * j] : origem[2 * j];
+                        destino_im[j] = acumula ? destino_im[j] + origem[2 * j + 1] : origem[2 * j + 1];
+                    }
+                }
+            }
+        }
+    }
+}
+
+///Produto direto (laço i-k-j) para matrizes pequenas, em que empacotar custaria mais que multiplicar.
+
+static void gemm_direto(int l, int c, int m, const float* a, int lda, const float* b, int ldb, float* r, int ldr, int acumula) {
+    int i, j, k;
+
+    for (i = 0; i < l; i++) {
+        float* ri = r + 2 * (size_t) i * ldr;
+
+        if (!acumula) {
+            memset(ri, 0, 2 * (size_t) m * sizeof(float));
+        }
+        for (k = 0; k < c; k++) {
+            float ar = a[2 * ((size_t) i * lda + k)];
+            float ai = a[2 * ((size_t) i * lda + k) + 1];
+            const float* bk = b + 2 * (size_t) k * ldb;
+
+            for (j = 0; j < m; j++) {
+                ri[2 * j] += ar * bk[2 * j] - ai * bk[2 * j + 1];
+                ri[2 * j + 1] += ar * bk[2 * j + 1] + ai * bk[2 * j];
+            }
+        }
+    }
+}
+
+///Produto direto no formato planar. Sem intercalação, o laço em j vira multiplicações e somas diretas sobre vetores reais.
+
+static void gemm_direto_planar(int l, int c, int m, const gemm_operando* a, const gemm_operando* b, const gemm_saida* r, int acumula) {
+    int i, j, k;
+
+    for (i = 0; i < l; i++) {
+        float* rr = r->re + (size_t) i * r->ld;
+        float* ri = r->im + (size_t) i * r->ld;
+
+        if (!acumula) {
+            memset(rr, 0, (size_t) m * sizeof(float));
+            memset(ri, 0, (size_t) m * sizeof(float));
+        }
+        for (k = 0; k < c; k++) {
+            float ar = a->re[(size_t) i * a->ld + k];
+            float ai = a->im[(size_t) i * a->ld + k];
+            const float* br = b->re + (size_t) k * b->ld;
+            const float* bi = b->im + (size_t) k * b->ld;
+
+            for (j = 0; j < m; j++) {
+                rr[j] += ar * br[j] - ai * bi[j];
+                ri[j] += ar * bi[j] + ai * br[j];
+            }
+        }
+    }
+}
+
+///Laços de blocagem comuns aos formatos intercalado e planar.
+
+static int gemm_blocos(int l, int c, int m, const gemm_operando* a, const gemm_operando* b, const gemm_saida* r, int acumula) {
+    const gemm_kernel* k = escolhe_kernel();
+    float* ap = (float*) aligned_alloc(64, 2 * sizeof(float) * (GEMM_MC + GEMM_MR_MAX) * GEMM_KC);
+    float* bp = (float*) aligned_alloc(64, 2 * sizeof(float) * (GEMM_NC + GEMM_NR_MAX) * GEMM_KC);
+    int jc, pc, ic;
+
+    if (ap == NULL || bp == NULL) {
+        free(ap);
+        free(bp);
+        return 0;
+    }
+
+    for (jc = 0; jc < m; jc += GEMM_NC) {
+        int nc = m - jc < GEMM_NC ? m - jc : GEMM_NC;
+
+        for (pc = 0; pc < c; pc += GEMM_KC) {
+            int kc = c - pc < GEMM_KC ? c - pc : GEMM_KC;
+            int acumula_bloco = acumula || pc > 0;
+
+            empacota_b(kc, nc, b, pc, jc, k->nr, bp);
+
+            for (ic = 0; ic < l; ic += GEMM_MC) {
+                int mc = l - ic < GEMM_MC ? l - ic : GEMM_MC;
+
+                empacota_a(mc, kc, a, ic, pc, k->mr, ap);
+                macro_kernel(k, mc, nc, kc, ap, bp, r, ic, jc, acumula_bloco);
+            }
+        }
+    }
+
+    free(ap);
+    free(bp);
+    return 1;
+}
+
+///Calcula r = a * b (ou r += a * b) com blocagem em três níveis de cache e micro-painéis empacotados.
+
+/// @param l Número de linhas de a e de r.
+/// @param c Número de colunas de a e de linhas de b.
+/// @param m Número de colunas de b e de r.
+/// @param a Primeira matriz de entrada (l x c).
+/// @param lda Dimensão principal de a.
+/// @param b Segunda matriz de entrada (c x m).
+/// @param ldb Dimensão principal de b.
+/// @param r Matriz resultante (l x m).
+/// @param ldr Dimensão principal de r.
+/// @param acumula Se diferente de zero, soma o produto ao conteúdo atual de r.
+
+void cgemm(int l, int c, int m, const float* a, int lda, const float* b, int ldb, float* r, int ldr, int acumula) {
+    gemm_operando op_a = { a, NULL, lda };
+    gemm_operando op_b = { b, NULL, ldb };
+    gemm_saida op_r = { r, NULL, ldr };
+
+    if (l <= 0 || m <= 0) {
+        return;
+    }
+    if (c <= 0 || (long long) l * c * m <= GEMM_LIMIAR_DIRETO || !gemm_blocos(l, c, m, &op_a, &op_b, &op_r, acumula)) {
+        gemm_direto(l, c, m, a, lda, b, ldb, r, ldr, acumula);
+    }
+}
+
+///Versão planar de cgemm: as mesmas etapas de blocagem, com o empacotamento lendo direto das partes real e imaginária.
+
+/// @param l Número de linhas de a e de r.
+/// @param c Número de colunas de a e de linhas de b.
+/// @param m Número de colunas de b e de r.
+/// @param a_re Partes reais de a.
+/// @param a_im Partes imaginárias de a.
+/// @param lda Dimensão principal de a.
+/// @param b_re Partes reais de b.
+/// @param b_im Partes imaginárias de b.
+/// @param ldb Dimensão principal de b.
+/// @param r_re Partes reais de r.
+/// @param r_im Partes imaginárias de r.
+/// @param ldr Dimensão principal de r.
+/// @param acumula Se diferente de zero, soma o produto ao conteúdo atual de r.
+
+void cgemm_planar(int l, int c, int m, const float* a_re, const float* a_im, int lda,
+                  const float* b_re, const float* b_im, int ldb,
+                  float* r_re, float* r_im, int ldr, int acumula) {
+    gemm_operando op_a = { a_re, a_im, lda };
+    gemm_operando op_b = { b_re, b_im, ldb };
+    gemm_saida op_r = { r_re, r_im, ldr };
+
+    if (l <= 0 || m <= 0) {
+        return;
+    }
+    if (c <= 0 || (long long) l * c * m <= GEMM_LIMIAR_DIRETO || !gemm_blocos(l, c, m, &op_a, &op_b, &op_r, acumula)) {
+        gemm_direto_planar(l, c, m, &op_a, &op_b, &op_r, acumula);
+    }
+}
+
+///Maior dimensão (linhas, colunas ou profundidade) tratada pelo produto em lote intercalado.
+#define LOTE_MAX 8
+
+///Número de matrizes processadas em paralelo: uma por posição do vetor.
+#define LOTE_LARGURA 16
+
+///Vetor com uma posição por matriz do grupo. O compilador divide as operações nos registradores disponíveis (4 xmm, 2 ymm ou 1 zmm).
+typedef float lote_vetor __attribute__((vector_size(LOTE_LARGURA * sizeof(float))));
+
+///Multiplica um grupo de até LOTE_LARGURA matrizes. Os elementos são transpostos para que a posição w de cada vetor pertença à matriz w; assim cada operação vetorial avança todas as matrizes do grupo ao mesmo tempo.
+
+static inline __attribute__((always_inline))
+void lote_grupo(int l, int c, int m, const float* a, int lda, long passo_a, const float* b, int ldb, long passo_b,
+                float* r, int ldr, long passo_r, int grupo) {
+    lote_vetor a_re[LOTE_MAX * LOTE_MAX], a_im[LOTE_MAX * LOTE_MAX];
+    lote_vetor b_re[LOTE_MAX * LOTE_MAX], b_im[LOTE_MAX * LOTE_MAX];
+    int i, j, k, w;
+
+    for (i = 0; i < l; i++) {
+        for (k = 0; k < c; k++) {
+            lote_vetor re = {0}, im = {0};
+
+            for (w = 0; w < grupo; w++) {
+                const float* x = a + 2 * (w * passo_a + (long) i * lda + k);
+
+                re[w] = x[0];
+                im[w] = x[1];
+            }
+            a_re[i * c + k] = re;
+            a_im[i * c + k] = im;
+        }
+    }
+    for (k = 0; k < c; k++) {
+        for (j = 0; j < m; j++) {
+            lote_vetor re = {0}, im = {0};
+
+            for (w = 0; w < grupo; w++) {
+                const float* x = b + 2 * (w * passo_b + (long) k * ldb + j);
+
+                re[w] = x[0];
+                im[w] = x[1];
+            }
+            b_re[k * m + j] = re;
+            b_im[k * m + j] = im;
+        }
+    }
+
+    for (i = 0; i < l; i++) {
+        for (j = 0; j < m; j++) {
+            lote_vetor re = {0}, im = {0};
+
+            for (k = 0; k < c; k++) {
+                re += a_re[i * c + k] * b_re[k * m + j] - a_im[i * c + k] * b_im[k * m + j];
+                im += a_re[i * c + k] * b_im[k * m + j] + a_im[i * c + k] * b_re[k * m + j];
+            }
+            for (w = 0; w < grupo; w++) {
+                float* x = r + 2 * (w * passo_r + (long) i * ldr + j);
+
+                x[0] = re[w];
+                x[1] = im[w];
+            }
+        }
+    }
+}
+
+///Percorre o lote em grupos de LOTE_LARGURA matrizes.
+
+static inline __attribute__((always_inline))
+void lote_percorre(int l, int c, int m, const float* a, int lda, long passo_a, const float* b, int ldb, long passo_b,
+                   float* r, int ldr, long passo_r, int lote) {
+    int inicio;
+
+    for (inicio = 0; inicio < lote; inicio += LOTE_LARGURA) {
+        int grupo = lote - inicio < LOTE_LARGURA ? lote - inicio : LOTE_LARGURA;
+
+        lote_grupo(l, c, m, a + 2 * inicio * passo_a, lda, passo_a, b + 2 * inicio * passo_b, ldb, passo_b,
+                   r + 2 * inicio * passo_r, ldr, passo_r, grupo);
+    }
+}
+
+///Versão do lote compilada sem instruções específicas (SSE2 no x86-64).
+
+static void lote_generico(int l, int c, int m, const float* a, int lda, long passo_a, const float* b, int ldb, long passo_b,
+                          float* r, int ldr, long passo_r, int lote) {
+    lote_percorre(l, c, m, a, lda, passo_a, b, ldb, passo_b, r, ldr, passo_r, lote);
+}
+
+#if GEMM_X86
+
+///Versão do lote com AVX2 + FMA.
+
+__attribute__((target("avx2,fma")))
+static void lote_avx2(int l, int c, int m, const float* a, int lda, long passo_a, const float* b, int ldb, long passo_b,
+                      float* r, int ldr, long passo_r, int lote) {
+    lote_percorre(l, c, m, a, lda, passo_a, b, ldb, passo_b, r, ldr, passo_r, lote);
+}
+
+///Versão do lote com AVX-512.
+
+__attribute__((target("avx512f")))
+static void lote_avx512(int l, int c, int m, const float* a, int lda, long passo_a, const float* b, int ldb, long passo_b,
+                        float* r, int ldr, long passo_r, int lote) {
+    lote_percorre(l, c, m, a, lda, passo_a, b, ldb, passo_b, r, ldr, passo_r, lote);
+}
+
+#endif // GEMM_X86
+
+///Calcula r[t] = a[t] * b[t] para t = 0 .. lote - 1, com as matrizes intercaladas entre as posições dos vetores SIMD.
+
+/// @param l Número de linhas de cada a e de cada r.
+/// @param c Número de colunas de cada a e de linhas de cada b.
+/// @param m Número de colunas de cada b e de cada r.
+/// @param a Primeira matriz do lote de entrada.
+/// @param lda Dimensão principal de cada a.
+/// @param passo_a Distância, em números complexos, entre duas matrizes a consecutivas.
+/// @param b Primeira matriz do segundo lote de entrada.
+/// @param ldb Dimensão principal de cada b.
+/// @param passo_b Distância, em números complexos, entre duas matrizes b consecutivas.
+/// @param r Primeira matriz do lote de saída.
+/// @param ldr Dimensão principal de cada r.
+/// @param passo_r Distância, em números complexos, entre duas matrizes r consecutivas.
+/// @param lote Número de produtos.
+
+void cgemm_lote(int l, int c, int m, const float* a, int lda, long passo_a, const float* b, int ldb, long passo_b,
+                float* r, int ldr, long passo_r, int lote) {
+    int t;
+
+    if (l <= 0 || m <= 0 || lote <= 0) {
+        return;
+    }
+    if (l > LOTE_MAX || c > LOTE_MAX || m > LOTE_MAX) {
+        for (t = 0; t < lote; t++) {
+            cgemm(l, c, m, a + 2 * t * passo_a, lda, b + 2 * t * passo_b, ldb, r + 2 * t * passo_r, ldr, 0);
+        }
+        return;
+    }
+
+#if GEMM_X86
+    switch (simd_nivel()) {
+    case SIMD_AVX512:
+        lote_avx512(l, c, m, a, lda, passo_a, b, ldb, passo_b, r, ldr, passo_r, lote);
+        return;
+    case SIMD_AVX2:
+        lote_avx2(l, c, m, a, lda, passo_a, b, ldb, passo_b, r, ldr, passo_r, lote);
+        return;
+    default:
+        break;
+    }
+#endif
+    lote_generico(l, c, m, a, lda, passo_a, b, ldb, passo_b, r, ldr, passo_r, lote);
+}
+
+///Máximo de símbolos de cada bloco de zgemm_streams (e tamanho do trecho passado a zgemm_parcela).
+#define ZGEMM_BLOCO 256
+
+///Streams de saída calculados juntos por zgemm_streams (cada trecho de entrada é lido uma vez por grupo).
+#define ZGEMM_MR 4
+
+///Bytes dos trechos de entrada de um bloco de zgemm_streams (o bloco encolhe quando c é grande).
+#define ZGEMM_BYTES_X (64 * 1024)
+
+///Maior número de streams de entrada das faixas com c fixo (2, 4 e 8).
+#define ZGEMM_C_FIXO 8
+
+///Desenrola por completo os laços sobre linhas e streams de entrada nas faixas com c fixo.
+#define ZGEMM_DESENROLA _Pragma("GCC unroll 8")
+
+///Calcula as linhas de um grupo de y nos símbolos inicio a inicio + n - 1.
+
+/// Os coeficientes são lidos direto de w (partes real e imaginária intercaladas, linha i em
+/// w + 2 i ldw), sem cópia. Na gravação soma-se a cada linha i a parcela z[i] (indexada a
+/// partir de inicio), ou nada se z for NULL: y é escrito uma única vez.
+
+typedef void (*zgemm_faixa)(int mr, int c, const double* w, int ldw, const double* const* x, double* const* y,
+                            const double* const* z, long inicio, long n);
+
+///Instancia a faixa base_c com c fixo em C, chamando o corpo base_corpo (os atributos de alvo vêm em seguida).
+#define ZGEMM_FAIXA_FIXA(base, C, ...)                                                                      \
+__VA_ARGS__ static void base##_##C(int mr, int c, const double* w, int ldw, const double* const* x,        \
+                                   double* const* y, const double* const* z, long inicio, long n) {        \
+    (void) c;                                                                                              \
+    base##_corpo(mr, C, w, ldw, x, y, z, inicio, n);                                                       \
+}
+
+///Versão genérica, um símbolo por vez. Como nas versões vetoriais, re = sum wr xr - sum wi xi e im = sum wr xi + sum wi xr.
+
+static void faixa_generica(int mr, int c, const double* w, int ldw, const double* const* x, double* const* y,
+                           const double* const* z, long inicio, long n) {
+    long j;
+    int i, k;
+
+    for (j = inicio; j < inicio + n; j++) {
+        for (i = 0; i < mr; i++) {
+            const double* wl = w + 2 * (long) i * ldw;
+            double pr = 0, pi = 0, qr = 0, qi = 0;
+
+            for (k = 0; k < c; k++) {
+                double xr = x[k][2 * j], xi = x[k][2 * j + 1];
+
+                pr += wl[2 * k] * xr;
+                pi += wl[2 * k] * xi;
+                qr += wl[2 * k + 1] * xi;
+                qi += wl[2 * k + 1] * xr;
+            }
+            if (z != NULL) {
+                y[i][2 * j] = (pr - qr) + z[i][2 * (j - inicio)];
+                y[i][2 * j + 1] = (pi + qi) + z[i][2 * (j - inicio) + 1];
+            } else {
+                y[i][2 * j] = pr - qr;
+                y[i][2 * j + 1] = pi + qi;
+            }
+        }
+    }
+}
+
+///Corpo escalar para mr linhas e c (até ZGEMM_C_FIXO) constantes, com as mesmas somas de faixa_generica.
+
+/// Os coeficientes e os ponteiros de entrada são copiados para variáveis locais, que as
+/// gravações em y não podem alterar, e cada símbolo de entrada é lido uma vez para as mr linhas.
+
+static inline __attribute__((always_inline))
+void corpo_escalar(int mr, int c, const double* w, int ldw, const double* const* x, double* const* y,
+                   const double* const* z, long inicio, long n) {
+    double wr[ZGEMM_MR][ZGEMM_C_FIXO], wi[ZGEMM_MR][ZGEMM_C_FIXO];
+    const double* xp[ZGEMM_C_FIXO];
+    long j;
+    int i, k;
+
+    ZGEMM_DESENROLA
+    for (k = 0; k < c; k++) {
+        xp[k] = x[k];
+        ZGEMM_DESENROLA
+        for (i = 0; i < mr; i++) {
+            wr[i][k] = w[2 * ((long) i * ldw + k)];
+            wi[i][k] = w[2 * ((long) i * ldw + k) + 1];
+        }
+    }
+    for (j = inicio; j < inicio + n; j++) {
+        double xr[ZGEMM_C_FIXO], xi[ZGEMM_C_FIXO];
+
+        ZGEMM_DESENROLA
+        for (k = 0; k < c; k++) {
+            xr[k] = xp[k][2 * j];
+            xi[k] = xp[k][2 * j + 1];
+        }
+        ZGEMM_DESENROLA
+        for (i = 0; i < mr; i++) {
+            double pr = 0, pi = 0, qr = 0, qi = 0;
+
+            ZGEMM_DESENROLA
+            for (k = 0; k < c; k++) {
+                pr += wr[i][k] * xr[k];
+                pi += wr[i][k] * xi[k];
+                qr += wi[i][k] * xi[k];
+                qi += wi[i][k] * xr[k];
+            }
+            if (z != NULL) {
+                y[i][2 * j] = (pr - qr) + z[i][2 * (j - inicio)];
+                y[i][2 * j + 1] = (pi + qi) + z[i][2 * (j - inicio) + 1];
+            } else {
+                y[i][2 * j] = pr - qr;
+                y[i][2 * j + 1] = pi + qi;
+            }
+        }
+    }
+}
+
+///Faixa escalar com c fixo: grupos de ZGEMM_MR linhas pelo corpo de ZGEMM_MR linhas, os demais pelo corpo de mr linhas.
+
+static inline __attribute__((always_inline))
+void faixa_escalar_corpo(int mr, int c, const double* w, int ldw, const double* const* x, double* const* y,
+                         const double* const* z, long inicio, long n) {
+    if (mr == ZGEMM_MR) {
+        corpo_escalar(ZGEMM_MR, c, w, ldw, x, y, z, inicio, n);
+    } else {
+        corpo_escalar(mr, c, w, ldw, x, y, z, inicio, n);
+    }
+}
+
+ZGEMM_FAIXA_FIXA(faixa_escalar, 2)
+ZGEMM_FAIXA_FIXA(faixa_escalar, 4)
+ZGEMM_FAIXA_FIXA(faixa_escalar, 8)
+
+///Completa pela versão genérica os símbolos j a inicio + n - 1 que sobram das versões vetoriais.
+
+static void faixa_restante(int mr, int c, const double* w, int ldw, const double* const* x, double* const* y,
+                           const double* const* z, long inicio, long j, long n) {
+    const double* zr[ZGEMM_MR];
+    int i;
+
+    if (j >= inicio + n) {
+        return;
+    }
+    for (i = 0; z != NULL && i < mr; i++) {
+        zr[i] = z[i] + 2 * (j - inicio);
+    }
+    faixa_generica(mr, c, w, ldw, x, y, z != NULL ? zr : NULL, j, inicio + n - j);
+}
+
+#if GEMM_X86
+
+///Corpo AVX2 para mr linhas (constante): 2 símbolos por registrador, com p = sum wr x e q = sum wi troca(x), e y = addsub(p, q).
+
+__attribute__((target("avx2,fma")))
+static inline __attribute__((always_inline))
+long corpo_avx2(int mr, int c, const double* w, int ldw, const double* const* x, double* const* y,
+                const double* const* z, long inicio, long n) {
+    long j, fim = inicio + n;
+    int i, k;
+
+    for (j = inicio; j + 2 <= fim; j += 2) {
+        __m256d p[ZGEMM_MR], q[ZGEMM_MR];
+
+        for (i = 0; i < mr; i++) {
+            p[i] = _mm256_setzero_pd();
+            q[i] = _mm256_setzero_pd();
+        }
+        ZGEMM_DESENROLA
+        for (k = 0; k < c; k++) {
+            __m256d xv = _mm256_loadu_pd(x[k] + 2 * j);
+            __m256d xt = _mm256_permute_pd(xv, 0x5);
+
+            for (i = 0; i < mr; i++) {
+                p[i] = _mm256_fmadd_pd(_mm256_broadcast_sd(w + 2 * ((long) i * ldw + k)), xv, p[i]);
+                q[i] = _mm256_fmadd_pd(_mm256_broadcast_sd(w + 2 * ((long) i * ldw + k) + 1), xt, q[i]);
+            }
+        }
+        for (i = 0; i < mr; i++) {
+            __m256d v = _mm256_addsub_pd(p[i], q[i]);
+
+            if (z != NULL) {
+                v = _mm256_add_pd(v, _mm256_loadu_pd(z[i] + 2 * (j - inicio)));
+            }
+            _mm256_storeu_pd(y[i] + 2 * j, v);
+        }
+    }
+    return j;
+}
+
+///Faixa AVX2: grupos completos pelo corpo de ZGEMM_MR linhas, os demais linha a linha; a sobra de símbolos pela versão genérica.
+
+__attribute__((target("avx2,fma")))
+static inline __attribute__((always_inline))
+void faixa_avx2_corpo(int mr, int c, const double* w, int ldw, const double* const* x, double* const* y,
+                      const double* const* z, long inicio, long n) {
+    long j = inicio;
+    int i;
+
+    if (mr == ZGEMM_MR) {
+        j = corpo_avx2(ZGEMM_MR, c, w, ldw, x, y, z, inicio, n);
+    } else {
+        for (i = 0; i < mr; i++) {
+            j = corpo_avx2(1, c, w + 2 * (long) i * ldw, ldw, x, y + i, z != NULL ? z + i : NULL, inicio, n);
+        }
+    }
+    faixa_restante(mr, c, w, ldw, x, y, z, inicio, j, n);
+}
+
+///Faixa AVX2 para qualquer c.
+
+__attribute__((target("avx2,fma")))
+static void faixa_avx2(int mr, int c, const double* w, int ldw, const double* const* x, double* const* y,
+                       const double* const* z, long inicio, long n) {
+    faixa_avx2_corpo(mr, c, w, ldw, x, y, z, inicio, n);
+}
+
+ZGEMM_FAIXA_FIXA(faixa_avx2, 2, __attribute__((target("avx2,fma"))))
+ZGEMM_FAIXA_FIXA(faixa_avx2, 4, __attribute__((target("avx2,fma"))))
+ZGEMM_FAIXA_FIXA(faixa_avx2, 8, __attribute__((target("avx2,fma"))))
+
+///Corpo AVX-512 para mr linhas (constante): 4 símbolos por registrador; fmaddsub(1, p, q) faz o papel de addsub.
+
+__attribute__((target("avx512f")))
+static inline __attribute__((always_inline))
+long corpo_avx512(int mr, int c, const double* w, int ldw, const double* const* x, double* const* y,
+                  const double* const* z, long inicio, long n) {
+    const __m512d um = _mm512_set1_pd(1);
+    long j, fim = inicio + n;
+    int i, k;
+
+    for (j = inicio; j + 4 <= fim; j += 4) {
+        __m512d p[ZGEMM_MR], q[ZGEMM_MR];
+
+        for (i = 0; i < mr; i++) {
+            p[i] = _mm512_setzero_pd();
+            q[i] = _mm512_setzero_pd();
+        }
+        ZGEMM_DESENROLA
+        for (k = 0; k < c; k++) {
+            __m512d xv = _mm512_loadu_pd(x[k] + 2 * j);
+            __m512d xt = _mm512_permute_pd(xv, 0x55);
+
+            for (i = 0; i < mr; i++) {
+                p[i] = _mm512_fmadd_pd(_mm512_set1_pd(w[2 * ((long) i * ldw + k)]), xv, p[i]);
+                q[i] = _mm512_fmadd_pd(_mm512_set1_pd(w[2 * ((long) i * ldw + k) + 1]), xt, q[i]);
+            }
+        }
+        for (i = 0; i < mr; i++) {
+            __m512d v = _mm512_fmaddsub_pd(um, p[i], q[i]);
+
+            if (z != NULL) {
+                v = _mm512_add_pd(v, _mm512_loadu_pd(z[i] + 2 * (j - inicio)));
+            }
+            _mm512_storeu_pd(y[i] + 2 * j, v);
+        }
+    }
+    return j;
+}
+
+///Faixa AVX-512, com a mesma divisão de faixa_avx2_corpo.
+
+__attribute__((target("avx512f")))
+static inline __attribute__((always_inline))
+void faixa_avx512_corpo(int mr, int c, const double* w, int ldw, const double* const* x, double* const* y,
+                        const double* const* z, long inicio, long n) {
+    long j = inicio;
+    int i;
+
+    if (mr == ZGEMM_MR) {
+        j = corpo_avx512(ZGEMM_MR, c, w, ldw, x, y, z, inicio, n);
+    } else {
+        for (i = 0; i < mr; i++) {
+            j = corpo_avx512(1, c, w + 2 * (long) i * ldw, ldw, x, y + i, z != NULL ? z + i : NULL, inicio, n);
+        }
+    }
+    faixa_restante(mr, c, w, ldw, x, y, z, inicio, j, n);
+}
+
+///Faixa AVX-512 para qualquer c.
+
+__attribute__((target("avx512f")))
+static void faixa_avx512(int mr, int c, const double* w, int ldw, const double* const* x, double* const* y,
+                         const double* const* z, long inicio, long n) {
+    faixa_avx512_corpo(mr, c, w, ldw, x, y, z, inicio, n);
+}
+
+ZGEMM_FAIXA_FIXA(faixa_avx512, 2, __attribute__((target("avx512f"))))
+ZGEMM_FAIXA_FIXA(faixa_avx512, 4, __attribute__((target("avx512f"))))
+ZGEMM_FAIXA_FIXA(faixa_avx512, 8, __attribute__((target("avx512f"))))
+
+#endif // GEMM_X86
+
+///Escolhe a faixa do nível SIMD atual: com c fixo quando há c = 2, 4 ou 8 streams de entrada, a genérica nos demais casos.
+
+/// @param c Número de streams de entrada.
+/// @return A faixa.
+
+static zgemm_faixa zgemm_escolhe_faixa(int c) {
+    static const zgemm_faixa genericas[] = { faixa_escalar_2, faixa_escalar_4, faixa_escalar_8, faixa_generica };
+#if GEMM_X86
+    static const zgemm_faixa avx2[] = { faixa_avx2_2, faixa_avx2_4, faixa_avx2_8, faixa_avx2 };
+    static const zgemm_faixa avx512[] = { faixa_avx512_2, faixa_avx512_4, faixa_avx512_8, faixa_avx512 };
+#endif
+    int t = c == 2 ? 0 : c == 4 ? 1 : c == 8 ? 2 : 3;
+
+#if GEMM_X86
+    switch (simd_nivel()) {
+    case SIMD_AVX512:
+        return avx512[t];
+    case SIMD_AVX2:
+        return avx2[t];
+    default:
+        break;
+    }
+#endif
+    return genericas[t];
+}
+
+///Produto de streams em blocos de até ZGEMM_BLOCO símbolos e grupos de ZGEMM_MR streams de saída.
+
+/// @param l Número de linhas de w e de streams de saída.
+/// @param c Número de colunas de w e de streams de entrada.
+/// @param w Matriz de coeficientes (l x c).
+/// @param ldw Dimensão principal de w.
+/// @param x Os c streams de entrada.
+/// @param y Os l streams de saída.
+/// @param len Número de símbolos de cada stream.
+/// @param parcela Função que dá o termo somado a cada trecho de y, ou NULL.
+/// @param ctx Argumento repassado a parcela.
+/// @param acumula Se diferente de zero (e parcela for NULL), soma o produto ao conteúdo atual de y.
+
+static void zgemm_percorre(int l, int c, const double* w, int ldw, const double* const* x, double* const* y, long len,
+                           zgemm_parcela parcela, void* ctx, int acumula) {
+    double termo[ZGEMM_MR][2 * ZGEMM_BLOCO];
+    const double* z[ZGEMM_MR];
+    zgemm_faixa faixa = zgemm_escolhe_faixa(c);
+    long inicio, bloco;
+    int i, t;
+
+    if (l <= 0 || len <= 0) {
+        return;
+    }
+
+    // Com muitos streams de entrada o bloco encolhe para que os trechos continuem na cache.
+    bloco = c > 0 ? (long) (ZGEMM_BYTES_X / (2 * sizeof(double) * c)) / 4 * 4 : ZGEMM_BLOCO;
+    bloco = bloco < 32 ? 32 : bloco > ZGEMM_BLOCO ? ZGEMM_BLOCO : bloco;
+    for (inicio = 0; inicio < len; inicio += bloco) {
+        long n = len - inicio < bloco ? len - inicio : bloco;
+
+        for (i = 0; i < l; i += ZGEMM_MR) {
+            int mr = l - i < ZGEMM_MR ? l - i : ZGEMM_MR;
+
+            for (t = 0; t < mr; t++) {
+                if (parcela != NULL) {
+                    parcela(ctx, i + t, inicio, n, termo[t]);
+                    z[t] = termo[t];
+                } else {
+                    z[t] = y[i + t] + 2 * inicio;
+                }
+            }
+            faixa(mr, c, w + 2 * (long) i * ldw, ldw, x, y + i, parcela != NULL || acumula ? z : NULL, inicio, n);
+        }
+    }
+}
+
+///Calcula y = w x (ou y += w x) para streams de símbolos complexos de precisão dupla.
+
+/// @param l Número de linhas de w e de streams de saída.
+/// @param c Número de colunas de w e de streams de entrada.
+/// @param w Matriz de coeficientes (l x c).
+/// @param ldw Dimensão principal de w.
+/// @param x Os c streams de entrada.
+/// @param y Os l streams de saída.
+/// @param len Número de símbolos de cada stream.
+/// @param acumula Se diferente de zero, soma o produto ao conteúdo atual de y.
+
+void zgemm_streams(int l, int c, const double* w, int ldw, const double* const* x, double* const* y, long len, int acumula) {
+    zgemm_percorre(l, c, w, ldw, x, y, len, NULL, NULL, acumula);
+}
+
+///Calcula y = w x + z, com z produzido por parcela trecho a trecho e somado na gravação.
+
+/// @param l Número de linhas de w e de streams de saída.
+/// @param c Número de colunas de w e de streams de entrada.
+/// @param w Matriz de coeficientes (l x c).
+/// @param ldw Dimensão principal de w.
+/// @param x Os c streams de entrada.
+/// @param y Os l streams de saída.
+/// @param len Número de símbolos de cada stream.
+/// @param parcela Função que preenche o termo de cada trecho.
+/// @param ctx Argumento repassado a parcela.
+
+void zgemm_streams_soma(int l, int c, const double* w, int ldw, const double* const* x, double* const* y, long len,
+                        zgemm_parcela parcela, void* ctx) {
+    zgemm_percorre(l, c, w, ldw, x, y, len, parcela, ctx, 0);
+}
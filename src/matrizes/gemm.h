@@ -0,0 +1,123 @@
+/// @file gemm.h
+/// @brief Produto matricial complexo com blocagem em cache e empacotamento de painéis (GEMM).
+
+#ifndef GEMM_H
+#define GEMM_H
+
+/// @brief Calcula r = a * b (ou r += a * b) para matrizes complexas de precisão simples.
+
+/// As matrizes são guardadas por linhas, com parte real e imaginária intercaladas
+/// (o mesmo formato de um vetor de complex). As dimensões principais são dadas em
+/// números complexos, não em floats.
+
+/// @param l Número de linhas de a e de r.
+/// @param c Número de colunas de a e de linhas de b.
+/// @param m Número de colunas de b e de r.
+/// @param a Primeira matriz de entrada (l x c).
+/// @param lda Dimensão principal de a.
+/// @param b Segunda matriz de entrada (c x m).
+/// @param ldb Dimensão principal de b.
+/// @param r Matriz resultante (l x m).
+/// @param ldr Dimensão principal de r.
+/// @param acumula Se diferente de zero, soma o produto ao conteúdo atual de r.
+
+void cgemm(int l, int c, int m, const float* a, int lda, const float* b, int ldb, float* r, int ldr, int acumula);
+
+/// @brief Versão de cgemm para matrizes no formato planar (partes real e imaginária em vetores separados).
+
+/// Os seis vetores de partes reais e imaginárias usam as dimensões principais dadas.
+/// Serve a quem já guarda os dados nesse formato; para matrizes intercaladas cgemm é
+/// tão rápido quanto este e dispensa a conversão.
+
+/// @param l Número de linhas de a e de r.
+/// @param c Número de colunas de a e de linhas de b.
+/// @param m Número de colunas de b e de r.
+/// @param a_re Partes reais de a.
+/// @param a_im Partes imaginárias de a.
+/// @param lda Dimensão principal de a.
+/// @param b_re Partes reais de b.
+/// @param b_im Partes imaginárias de b.
+/// @param ldb Dimensão principal de b.
+/// @param r_re Partes reais de r.
+/// @param r_im Partes imaginárias de r.
+/// @param ldr Dimensão principal de r.
+/// @param acumula Se diferente de zero, soma o produto ao conteúdo atual de r.
+
+void cgemm_planar(int l, int c, int m, const float* a_re, const float* a_im, int lda,
+                  const float* b_re, const float* b_im, int ldb,
+                  float* r_re, float* r_im, int ldr, int acumula);
+
+/// @brief Calcula r[t] = a[t] * b[t] para um lote de matrizes pequenas de mesmo formato.
+
+/// As matrizes de cada lote ficam a uma distância fixa (passo) umas das outras. Para
+/// dimensões até 8 o lote é transposto de forma que cada posição de um vetor SIMD
+/// carregue uma matriz diferente, e 16 produtos avançam juntos; acima disso cada
+/// produto é feito por cgemm.
+
+/// @param l Número de linhas de cada a e de cada r.
+/// @param c Número de colunas de cada a e de linhas de cada b.
+/// @param m Número de colunas de cada b e de cada r.
+/// @param a Primeira matriz do lote de entrada.
+/// @param lda Dimensão principal de cada a.
+/// @param passo_a Distância, em números complexos, entre duas matrizes a consecutivas.
+/// @param b Primeira matriz do segundo lote de entrada.
+/// @param ldb Dimensão principal de cada b.
+/// @param passo_b Distância, em números complexos, entre duas matrizes b consecutivas.
+/// @param r Primeira matriz do lote de saída.
+/// @param ldr Dimensão principal de cada r.
+/// @param passo_r Distância, em números complexos, entre duas matrizes r consecutivas.
+/// @param lote Número de produtos.
+
+void cgemm_lote(int l, int c, int m, const float* a, int lda, long passo_a, const float* b, int ldb, long passo_b,
+                float* r, int ldr, long passo_r, int lote);
+
+/// @brief Calcula y = w x (ou y += w x) para streams de símbolos complexos de precisão dupla.
+
+/// x são c streams e y são l streams de len números complexos cada (um vetor por stream,
+/// com parte real e imaginária intercaladas), ou seja, as linhas de matrizes c x len e
+/// l x len dadas por ponteiros. w é l x c, por linhas. Os símbolos são percorridos em
+/// blocos, e em cada bloco um grupo de linhas de y é calculado com os acumuladores em
+/// registradores (AVX2 ou AVX-512, conforme simd_nivel), lendo os trechos de x da cache.
+/// Para c = 2, 4 ou 8 são usadas versões com c fixo, com os laços sobre x desenrolados.
+
+/// @param l Número de linhas de w e de streams de saída.
+/// @param c Número de colunas de w e de streams de entrada.
+/// @param w Matriz de coeficientes (l x c).
+/// @param ldw Dimensão principal de w.
+/// @param x Os c streams de entrada.
+/// @param y Os l streams de saída (distintos dos de entrada).
+/// @param len Número de símbolos de cada stream.
+/// @param acumula Se diferente de zero, soma o produto ao conteúdo atual de y.
+
+void zgemm_streams(int l, int c, const double* w, int ldw, const double* const* x, double* const* y, long len, int acumula);
+
+/// @brief Produz o termo somado por zgemm_streams_soma a um trecho de um stream de saída.
+
+/// @param ctx O argumento dado a zgemm_streams_soma.
+/// @param linha O stream de saída.
+/// @param inicio O primeiro símbolo do trecho.
+/// @param n O número de símbolos do trecho (no máximo 256).
+/// @param z O termo (n números complexos intercalados) a preencher.
+
+typedef void (*zgemm_parcela)(void* ctx, int linha, long inicio, long n, double* z);
+
+/// @brief Calcula y = w x + z, com o termo z somado na gravação de cada trecho de y.
+
+/// Igual a zgemm_streams, mas o termo de cada trecho de símbolos de cada stream de saída
+/// é produzido por parcela logo antes da gravação (por exemplo, ruído gerado por trecho),
+/// de modo que y é escrito uma única vez e z nunca existe inteiro na memória.
+
+/// @param l Número de linhas de w e de streams de saída.
+/// @param c Número de colunas de w e de streams de entrada.
+/// @param w Matriz de coeficientes (l x c).
+/// @param ldw Dimensão principal de w.
+/// @param x Os c streams de entrada.
+/// @param y Os l streams de saída (distintos dos de entrada).
+/// @param len Número de símbolos de cada stream.
+/// @param parcela Função que preenche o termo de cada trecho.
+/// @param ctx Argumento repassado a parcela.
+
+void zgemm_streams_soma(int l, int c, const double* w, int ldw, const double* const* x, double* const* y, long len,
+                        zgemm_parcela parcela, void* ctx);
+
+#endif // GEMM_H
@@ -3,7 +3,11 @@
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <gsl/gsl_linalg.h>
+#include <string.h>
+#include "matrizes.h"
+#include "gemm.h"
+#include "simd_complexo.h"
+#include "svd_complexa.h"
 
 ///número de linhas gerais usadas pelas matrizes e vetores no cálculo da técnica de decomposição svd.
 #define M 6
@@ -22,28 +26,426 @@ double a_data[M][n] = {
     {31, 32, 33, 34, 35, 36}
 };
 
-typedef struct {
-    float real;
-    float imag;
-} complex;
+///Arredonda o número de colunas para que cada linha comece alinhada em MATRIZ_ALINHAMENTO bytes.
+
+/// @param c Número de colunas.
+/// @return A dimensão principal (ld) a ser usada.
+
+static int ld_alinhado(int c) {
+    int por_linha = MATRIZ_ALINHAMENTO / sizeof(complex);
+
+    return ((c + por_linha - 1) / por_linha) * por_linha;
+}
+
+///Aloca uma matriz contígua: um único buffer alinhado guarda todas as linhas, o que mantém os elementos próximos na cache e dispensa a leitura de um ponteiro por linha.
+
+/// @param l Número de linhas.
+/// @param c Número de colunas.
+/// @return A matriz alocada (dados == NULL em caso de falha).
+
+matriz matriz_aloca(int l, int c) {
+    matriz m;
+    size_t bytes;
+
+    m.linhas = l;
+    m.colunas = c;
+    m.ld = ld_alinhado(c > 0 ? c : 1);
+    m.proprietaria = 1;
+    bytes = (size_t) (l > 0 ? l : 1) * m.ld * sizeof(complex);
+    m.dados = (complex*) aligned_alloc(MATRIZ_ALINHAMENTO, bytes);
+    if (m.dados != NULL) {
+        memset(m.dados, 0, bytes);
+    }
+    return m;
+}
+
+///Libera o buffer de uma matriz. Visões não são donas do buffer e por isso não são liberadas.
+
+/// @param m Matriz a ser liberada.
+
+void matriz_libera(matriz* m) {
+    if (m->proprietaria) {
+        free(m->dados);
+    }
+    m->dados = NULL;
+    m->linhas = 0;
+    m->colunas = 0;
+}
+
+///Cria uma visão de uma sub-matriz: a visão aponta para o mesmo buffer e herda a dimensão principal da origem.
+
+/// @param m Matriz de origem.
+/// @param i0 Linha inicial.
+/// @param j0 Coluna inicial.
+/// @param l Número de linhas da visão.
+/// @param c Número de colunas da visão.
+/// @return A visão.
+
+matriz matriz_visao(const matriz* m, int i0, int j0, int l, int c) {
+    return matriz_visao_passo(m, i0, j0, l, c, 1);
+}
+
+///Cria uma visão que toma uma linha a cada passo linhas da origem, multiplicando a dimensão principal pelo passo.
+
+/// @param m Matriz de origem.
+/// @param i0 Linha inicial.
+/// @param j0 Coluna inicial.
+/// @param l Número de linhas da visão.
+/// @param c Número de colunas da visão.
+/// @param passo Distância, em linhas de m, entre duas linhas consecutivas da visão.
+/// @return A visão.
+
+matriz matriz_visao_passo(const matriz* m, int i0, int j0, int l, int c, int passo) {
+    matriz v;
+
+    v.dados = &MATRIZ_ELEM(m, i0, j0);
+    v.linhas = l;
+    v.colunas = c;
+    v.ld = m->ld * passo;
+    v.proprietaria = 0;
+    return v;
+}
+
+///Monta uma tabela de ponteiros de linha sobre o buffer da matriz, para uso com as funções que recebem complex**.
+
+/// @param m Matriz de origem.
+/// @return Tabela com m->linhas ponteiros (liberar apenas a tabela).
+
+complex** matriz_linhas(const matriz* m) {
+    int i;
+    complex** linhas = (complex**) malloc(m->linhas * sizeof(complex*));
+
+    for (i = 0; i < m->linhas; i++) {
+        linhas[i] = &MATRIZ_ELEM(m, i, 0);
+    }
+    return linhas;
+}
+
+///Converte uma matriz complex** em uma cópia contígua. As linhas de complex** são alocadas separadamente, então não há como saber se formam um único buffer (subtrair ponteiros de blocos distintos é indefinido), e uma visão poderia apontar para memória de outra matriz.
+
+/// @param a Matriz no formato antigo.
+/// @param l Número de linhas.
+/// @param c Número de colunas.
+/// @param copia Se diferente de zero, os elementos são copiados para a cópia (use 0 para matrizes de saída).
+/// @return A matriz equivalente (dados == NULL em caso de falha).
+
+static matriz matriz_de_linhas(complex** a, int l, int c, int copia) {
+    matriz m = matriz_aloca(l, c);
+    int i;
+
+    if (m.dados != NULL && copia) {
+        for (i = 0; i < l; i++) {
+            memcpy(&MATRIZ_ELEM(&m, i, 0), a[i], c * sizeof(complex));
+        }
+    }
+    return m;
+}
+
+///Copia o resultado de uma operação para a matriz complex** de saída.
+
+/// @param m Matriz obtida com matriz_de_linhas.
+/// @param a Matriz de saída no formato antigo.
+
+static void matriz_para_linhas(const matriz* m, complex** a) {
+    int i;
+
+    for (i = 0; i < m->linhas; i++) {
+        memcpy(a[i], &MATRIZ_ELEM(m, i, 0), m->colunas * sizeof(complex));
+    }
+}
+
 ///A transposição de uma matriz envolve a troca de suas linhas pelas colunas correspondentes. Isso significa que o elemento (i, j) da matriz original será colocado como elemento (j, i) na matriz transposta.
 
+/// @param a Matriz de entrada (l x c).
+/// @param result Matriz resultante (c x l).
+
+void matriz_transposta(const matriz* a, matriz* result) {
+    int i, j;
+
+    for (i = 0; i < a->colunas; i++) {
+        for (j = 0; j < a->linhas; j++) {
+            MATRIZ_ELEM(result, i, j) = MATRIZ_ELEM(a, j, i);
+        }
+    }
+}
+
+///A conjugada de uma matriz é obtida trocando o sinal da parte imaginária de cada elemento complexo da matriz. Cada linha é processada pelo kernel vetorial cvet_conjugada.
+
+/// @param a Matriz de entrada (l x c).
+/// @param result Matriz resultante (l x c).
+
+void matriz_conjugada(const matriz* a, matriz* result) {
+    int i;
+
+    for (i = 0; i < a->linhas; i++) {
+        cvet_conjugada((const float*) &MATRIZ_ELEM(a, i, 0), (float*) &MATRIZ_ELEM(result, i, 0), a->colunas);
+    }
+}
+
+///Uma matriz hermitiana é uma matriz complexa que é igual à sua matriz conjugada transposta. Isso significa que os elementos (i, j) da matriz original são iguais aos elementos (j, i) da matriz conjugada transposta.
+
+/// @param a Matriz de entrada (l x c).
+/// @param result Matriz resultante (c x l).
+
+void matriz_hermitiana(const matriz* a, matriz* result) {
+    int i, j;
+
+    for (i = 0; i < a->colunas; i++) {
+        for (j = 0; j < a->linhas; j++) {
+            MATRIZ_ELEM(result, i, j).real = MATRIZ_ELEM(a, j, i).real;
+            MATRIZ_ELEM(result, i, j).imag = -MATRIZ_ELEM(a, j, i).imag;
+        }
+    }
+}
+
+///Para somar duas matrizes complexas, você deve somar separadamente a parte real e a parte imaginária de cada elemento correspondente das matrizes. Cada linha é somada pelo kernel vetorial cvet_soma.
+
+/// @param a Primeira matriz de entrada.
+/// @param b Segunda matriz de entrada.
+/// @param result Matriz resultante.
+
+void matriz_soma(const matriz* a, const matriz* b, matriz* result) {
+    int i;
+
+    for (i = 0; i < a->linhas; i++) {
+        cvet_soma((const float*) &MATRIZ_ELEM(a, i, 0), (const float*) &MATRIZ_ELEM(b, i, 0),
+                  (float*) &MATRIZ_ELEM(result, i, 0), a->colunas);
+    }
+}
+///Para subtrair duas matrizes complexas, você deve subtrair separadamente a parte real e a parte imaginária de cada elemento correspondente das matrizes. Cada linha é subtraída pelo kernel vetorial cvet_subtracao.
+
+/// @param a Primeira matriz de entrada.
+/// @param b Segunda matriz de entrada.
+/// @param result Matriz resultante.
+
+void matriz_subtracao(const matriz* a, const matriz* b, matriz* result) {
+    int i;
+
+    for (i = 0; i < a->linhas; i++) {
+        cvet_subtracao((const float*) &MATRIZ_ELEM(a, i, 0), (const float*) &MATRIZ_ELEM(b, i, 0),
+                       (float*) &MATRIZ_ELEM(result, i, 0), a->colunas);
+    }
+}
+
+///Produto matricial sobre matrizes contíguas. O cálculo é delegado ao GEMM em blocos (gemm.c), que empacota a e b em micro-painéis para aproveitar as caches.
+
+/// @param a Primeira matriz de entrada (l x c).
+/// @param b Segunda matriz de entrada (c x m).
+/// @param result Matriz resultante (l x m).
+
+void matriz_produto(const matriz* a, const matriz* b, matriz* result) {
+    cgemm(a->linhas, a->colunas, b->colunas,
+          (const float*) a->dados, a->ld,
+          (const float*) b->dados, b->ld,
+          (float*) result->dados, result->ld, 0);
+}
+
+///Aloca uma matriz planar: dois buffers alinhados, um para as partes reais e outro para as imaginárias, com a mesma dimensão principal.
+
+/// @param l Número de linhas.
+/// @param c Número de colunas.
+/// @return A matriz alocada (real == NULL em caso de falha).
+
+matriz_planar matriz_planar_aloca(int l, int c) {
+    matriz_planar m;
+    int por_linha = MATRIZ_ALINHAMENTO / sizeof(float);
+    size_t bytes;
+
+    m.linhas = l;
+    m.colunas = c;
+    m.ld = ((c > 0 ? c : 1) + por_linha - 1) / por_linha * por_linha;
+    m.proprietaria = 1;
+    bytes = (size_t) (l > 0 ? l : 1) * m.ld * sizeof(float);
+    m.real = (float*) aligned_alloc(MATRIZ_ALINHAMENTO, bytes);
+    m.imag = (float*) aligned_alloc(MATRIZ_ALINHAMENTO, bytes);
+    if (m.real == NULL || m.imag == NULL) {
+        free(m.real);
+        free(m.imag);
+        m.real = NULL;
+        m.imag = NULL;
+        return m;
+    }
+    memset(m.real, 0, bytes);
+    memset(m.imag, 0, bytes);
+    return m;
+}
+
+///Libera os buffers de uma matriz planar. Visões não são donas dos buffers e por isso não são liberadas.
+
+/// @param m Matriz a ser liberada.
+
+void matriz_planar_libera(matriz_planar* m) {
+    if (m->proprietaria) {
+        free(m->real);
+        free(m->imag);
+    }
+    m->real = NULL;
+    m->imag = NULL;
+    m->linhas = 0;
+    m->colunas = 0;
+}
+
+///Separa cada linha de uma matriz intercalada em partes real e imaginária com o kernel vetorial cvet_separa.
+
+/// @param a Matriz intercalada de entrada.
+/// @param result Matriz planar de saída.
+
+void matriz_para_planar(const matriz* a, matriz_planar* result) {
+    int i;
+
+    for (i = 0; i < a->linhas; i++) {
+        cvet_separa((const float*) &MATRIZ_ELEM(a, i, 0), result->real + (size_t) i * result->ld,
+                    result->imag + (size_t) i * result->ld, a->colunas);
+    }
+}
+
+///Junta as partes real e imaginária de cada linha de uma matriz planar com o kernel vetorial cvet_intercala.
+
+/// @param a Matriz planar de entrada.
+/// @param result Matriz intercalada de saída.
+
+void matriz_de_planar(const matriz_planar* a, matriz* result) {
+    int i;
+
+    for (i = 0; i < a->linhas; i++) {
+        cvet_intercala(a->real + (size_t) i * a->ld, a->imag + (size_t) i * a->ld,
+                       (float*) &MATRIZ_ELEM(result, i, 0), a->colunas);
+    }
+}
+
+///SVD reduzida com um contexto já criado. Os dados são convertidos para precisão dupla na área de entrada do contexto e decompostos por svd_contexto_calcula.
+
+/// @param ctx Contexto de SVD com as dimensões de a.
+/// @param a Matriz de entrada.
+/// @param u Matriz de saída com os vetores singulares à esquerda (linhas x k).
+/// @param s Vetor de saída com os k valores singulares.
+/// @param v Matriz de saída com os vetores singulares à direita (colunas x k).
+
+void matriz_svd_contexto(svd_contexto* ctx, const matriz* a, matriz* u, float* s, matriz* v) {
+    int l = a->linhas, c = a->colunas, k = ctx->k;
+    int i, j;
+
+    for (i = 0; i < l; i++) {
+        for (j = 0; j < c; j++) {
+            ctx->entrada[2 * (i * c + j)] = MATRIZ_ELEM(a, i, j).real;
+            ctx->entrada[2 * (i * c + j) + 1] = MATRIZ_ELEM(a, i, j).imag;
+        }
+    }
+    svd_contexto_calcula(ctx, ctx->entrada, c);
+    for (i = 0; i < l; i++) {
+        for (j = 0; j < k; j++) {
+            MATRIZ_ELEM(u, i, j).real = ctx->u[2 * (i * k + j)];
+            MATRIZ_ELEM(u, i, j).imag = ctx->u[2 * (i * k + j) + 1];
+        }
+    }
+    for (i = 0; i < c; i++) {
+        for (j = 0; j < k; j++) {
+            MATRIZ_ELEM(v, i, j).real = ctx->v[2 * (i * k + j)];
+            MATRIZ_ELEM(v, i, j).imag = ctx->v[2 * (i * k + j) + 1];
+        }
+    }
+    for (j = 0; j < k; j++) {
+        s[j] = ctx->s[j];
+    }
+}
+
+///SVD reduzida de uma matriz complexa, com um contexto temporário (para decomposições repetidas use matriz_svd_contexto).
+
+/// @param a Matriz de entrada.
+/// @param u Matriz de saída com os vetores singulares à esquerda (linhas x k).
+/// @param s Vetor de saída com os k valores singulares.
+/// @param v Matriz de saída com os vetores singulares à direita (colunas x k).
+
+void matriz_svd(const matriz* a, matriz* u, float* s, matriz* v) {
+    svd_contexto ctx = svd_contexto_aloca(a->linhas, a->colunas);
+
+    matriz_svd_contexto(&ctx, a, u, s, v);
+    svd_contexto_libera(&ctx);
+}
+
+///Calcula e imprime a SVD de uma matriz complexa, no formato usado pelos testes.
+
+/// @param titulo Título impresso antes da matriz.
+/// @param a Matriz a ser decomposta.
+
+static void imprime_svd(const char* titulo, const matriz* a) {
+    int l = a->linhas, c = a->colunas, k = l < c ? l : c;
+    int i, j;
+    matriz u = matriz_aloca(l, k);
+    matriz v = matriz_aloca(c, k);
+    float* s = (float*) malloc(sizeof(float) * k);
+
+    printf("%s\n", titulo);
+    for (i = 0; i < l; i++) {
+        for (j = 0; j < c; j++) {
+            printf("(%.2f  %.2fi)", MATRIZ_ELEM(a, i, j).real, MATRIZ_ELEM(a, i, j).imag);
+        }
+        printf("\n");
+    }
+
+    matriz_svd(a, &u, s, &v);
+
+    printf("\n\nMatriz V\n");
+    for (i = 0; i < c; i++) {
+        for (j = 0; j < k; j++) {
+            printf("(%.2f  %.2fi)", MATRIZ_ELEM(&v, i, j).real, MATRIZ_ELEM(&v, i, j).imag);
+        }
+        printf("\n");
+    }
+
+    printf("\n\nMatriz U\n");
+    for (i = 0; i < l; i++) {
+        for (j = 0; j < k; j++) {
+            printf("(%.2f  %.2fi)", MATRIZ_ELEM(&u, i, j).real, MATRIZ_ELEM(&u, i, j).imag);
+        }
+        printf("\n");
+    }
+
+    printf("\n\nVetor S\n");
+    for (i = 0; i < k; i++)
+        printf("%.2f ", s[i]);
+    printf("\n");
+
+    matriz_libera(&u);
+    matriz_libera(&v);
+    free(s);
+}
+
+///Copia o canto superior esquerdo (l x c) de a_data para uma nova matriz complexa de parte imaginária nula.
+
+static matriz matriz_de_a_data(int l, int c) {
+    matriz r = matriz_aloca(l, c);
+    int i, j;
+
+    for (i = 0; i < l; i++) {
+        for (j = 0; j < c; j++) {
+            MATRIZ_ELEM(&r, i, j).real = a_data[i][j];
+            MATRIZ_ELEM(&r, i, j).imag = 0;
+        }
+    }
+    return r;
+}
+
+///Transposta no formato complex** (camada de compatibilidade sobre matriz_transposta).
+
 /// @param a Matriz de entrada.
 /// @param result Matriz resultante (deve ser alocada antes da chamada).
 /// @param l Número de linhas da matriz.
 /// @param c Número de colunas da matriz.
 
 void transposta(complex** a, complex** result, int l, int c) {
-    int i, j;
+    matriz ma = matriz_de_linhas(a, l, c, 1);
+    matriz mr = matriz_de_linhas(result, c, l, 0);
 
-    for (i = 0; i < c; i++) {
-        for (j = 0; j < l; j++) {
-            result[i][j].real = a[j][i].real;
-            result[i][j].imag = a[j][i].imag;
-        }
+    if (ma.dados != NULL && mr.dados != NULL) {
+        matriz_transposta(&ma, &mr);
+        matriz_para_linhas(&mr, result);
     }
+    matriz_libera(&ma);
+    matriz_libera(&mr);
 }
-///A conjugada de uma matriz é obtida trocando o sinal da parte imaginária de cada elemento complexo da matriz.
+
+///Conjugada no formato complex** (camada de compatibilidade sobre matriz_conjugada).
 
 /// @param a Matriz de entrada.
 /// @param result Matriz resultante (deve ser alocada antes da chamada).
@@ -51,16 +453,18 @@ void transposta(complex** a, complex** result, int l, int c) {
 /// @param c Número de colunas da matriz.
 
 void conjugada(complex** a, complex** result, int l, int c) {
-    int i, j;
+    matriz ma = matriz_de_linhas(a, l, c, 1);
+    matriz mr = matriz_de_linhas(result, l, c, 0);
 
-    for (i = 0; i < c; i++) {
-        for (j = 0; j < l; j++) {
-            result[i][j].real = a[i][j].real;
-            result[i][j].imag = -a[i][j].imag;
-        }
+    if (ma.dados != NULL && mr.dados != NULL) {
+        matriz_conjugada(&ma, &mr);
+        matriz_para_linhas(&mr, result);
     }
+    matriz_libera(&ma);
+    matriz_libera(&mr);
 }
-///Uma matriz hermitiana é uma matriz complexa que é igual à sua matriz conjugada transposta. Isso significa que os elementos (i, j) da matriz original são iguais aos elementos (j, i) da matriz conjugada transposta.
+
+///Hermitiana no formato complex** (camada de compatibilidade sobre matriz_hermitiana).
 
 /// @param a Matriz de entrada.
 /// @param result Matriz resultante (deve ser alocada antes da chamada).
@@ -68,16 +472,18 @@ void conjugada(complex** a, complex** result, int l, int c) {
 /// @param c Número de colunas da matriz.
 
 void hermitiana(complex** a, complex** result, int l, int c) {
-    int i, j;
+    matriz ma = matriz_de_linhas(a, l, c, 1);
+    matriz mr = matriz_de_linhas(result, c, l, 0);
 
-    for (i = 0; i < l; i++) {
-        for (j = 0; j < c; j++) {
-            result[i][j].real = a[j][i].real;
-            result[i][j].imag = -a[j][i].imag;
-        }
+    if (ma.dados != NULL && mr.dados != NULL) {
+        matriz_hermitiana(&ma, &mr);
+        matriz_para_linhas(&mr, result);
     }
+    matriz_libera(&ma);
+    matriz_libera(&mr);
 }
-///Para somar duas matrizes complexas, você deve somar separadamente a parte real e a parte imaginária de cada elemento correspondente das matrizes. O resultado será uma nova matriz complexa com a soma das partes reais e a soma das partes imaginárias.
+
+///Soma no formato complex** (camada de compatibilidade sobre matriz_soma).
 
 /// @param a Primeira matriz de entrada.
 /// @param b Segunda matriz de entrada.
@@ -86,16 +492,20 @@ void hermitiana(complex** a, complex** result, int l, int c) {
 /// @param c Número de colunas das matrizes.
 
 void soma(complex** a, complex** b, complex** result, int l, int c) {
-    int i, j;
+    matriz ma = matriz_de_linhas(a, l, c, 1);
+    matriz mb = matriz_de_linhas(b, l, c, 1);
+    matriz mr = matriz_de_linhas(result, l, c, 0);
 
-    for (i = 0; i < l; i++) {
-        for (j = 0; j < c; j++) {
-            result[i][j].real = a[i][j].real + b[i][j].real;
-            result[i][j].imag = a[i][j].imag + b[i][j].imag;
-        }
+    if (ma.dados != NULL && mb.dados != NULL && mr.dados != NULL) {
+        matriz_soma(&ma, &mb, &mr);
+        matriz_para_linhas(&mr, result);
     }
+    matriz_libera(&ma);
+    matriz_libera(&mb);
+    matriz_libera(&mr);
 }
-///Para subtrair duas matrizes complexas, você deve subtrair separadamente a parte real e a parte imaginária de cada elemento correspondente das matrizes. O resultado será uma nova matriz complexa com a diferença das partes reais e a diferença das partes imaginárias.
+
+///Subtração no formato complex** (camada de compatibilidade sobre matriz_subtracao).
 
 /// @param a Primeira matriz de entrada.
 /// @param b Segunda matriz de entrada.
@@ -104,16 +514,19 @@ void soma(complex** a, complex** b, complex** result, int l, int c) {
 /// @param c Número de colunas das matrizes.
 
 void subtracao(complex** a, complex** b, complex** result, int l, int c) {
-    int i, j;
+    matriz ma = matriz_de_linhas(a, l, c, 1);
+    matriz mb = matriz_de_linhas(b, l, c, 1);
+    matriz mr = matriz_de_linhas(result, l, c, 0);
 
-    for (i = 0; i < l; i++) {
-        for (j = 0; j < c; j++) {
-            result[i][j].real = a[i][j].real - b[i][j].real;
-            result[i][j].imag = a[i][j].imag - b[i][j].imag;
-        }
+    if (ma.dados != NULL && mb.dados != NULL && mr.dados != NULL) {
+        matriz_subtracao(&ma, &mb, &mr);
+        matriz_para_linhas(&mr, result);
     }
+    matriz_libera(&ma);
+    matriz_libera(&mb);
+    matriz_libera(&mr);
 }
-///a operação de produto escalar entre dois vetores complexos consiste em multiplicar a parte real de A pelo correspondente da parte real de B, multiplicar a parte imaginária de A pelo correspondente da parte imaginária de B, subtrair a multiplicação das partes imaginárias de A e B da multiplicação das partes reais de A e B, e somar o resultado à variável temp.real. Além disso, deve-se multiplicar a parte real de A pelo correspondente da parte imaginária de B, multiplicar a parte imaginária de A pelo correspondente da parte real de B, e somar o resultado à variável temp.imag.
+///a operação de produto escalar entre dois vetores complexos consiste em multiplicar a parte real de A pelo correspondente da parte real de B, multiplicar a parte imaginária de A pelo correspondente da parte imaginária de B, subtrair a multiplicação das partes imaginárias de A e B da multiplicação das partes reais de A e B, e somar o resultado à variável temp.real. Além disso, deve-se multiplicar a parte real de A pelo correspondente da parte imaginária de B, multiplicar a parte imaginária de A pelo correspondente da parte real de B, e somar o resultado à variável temp.imag. O somatório é feito pelo kernel vetorial cvet_mac.
 
 /// @param a Primeiro vetor complexo de entrada.
 /// @param b Segundo vetor complexo de entrada.
@@ -121,17 +534,13 @@ void subtracao(complex** a, complex** b, complex** result, int l, int c) {
 /// @param tam Tamanho dos vetores.
 
 void produto_escalar(complex* a, complex* b, complex* result, int tam) {
-    int i;
     complex temp = {0.0, 0.0};
 
-    for (i = 0; i < tam; i++) {
-        temp.real += a[i].real * b[i].real - a[i].imag * b[i].imag;
-        temp.imag += a[i].real * b[i].imag + a[i].imag * b[i].real;
-    }
+    cvet_mac((const float*) a, (const float*) b, (float*) &temp, tam);
     result->real = temp.real;
     result->imag = temp.imag;
 }
-///Para multiplicar duas matrizes complexas, você deve aplicar a regra geral de multiplicação de matrizes, considerando que os números complexos têm uma parte real e uma parte imaginária. Isso envolve multiplicar os elementos correspondentes, somar os produtos cruzados das partes reais e imaginárias e combiná-los para obter a parte real e a parte imaginária do resultado.
+///Produto matricial no formato complex** (camada de compatibilidade sobre matriz_produto).
 
 /// @param a Primeira matriz de entrada.
 /// @param b Segunda matriz de entrada.
@@ -141,38 +550,47 @@ void produto_escalar(complex* a, complex* b, complex* result, int tam) {
 /// @param m Número de colunas da segunda matriz.
 
 void produto_matricial(complex** a, complex** b, complex** result, int l, int c, int m) {
-    int i, j, k;
-    complex temp;
+    matriz ma = matriz_de_linhas(a, l, c, 1);
+    matriz mb = matriz_de_linhas(b, c, m, 1);
+    matriz mr = matriz_de_linhas(result, l, m, 0);
 
-    for (i = 0; i < l; i++) {
-        for (j = 0; j < m; j++) {
-            temp.real = 0;
-            temp.imag = 0;
-            for (k = 0; k < c; k++) {
-                temp.real += a[i][k].real * b[k][j].real - a[i][k].imag * b[k][j].imag;
-                temp.imag += a[i][k].real * b[k][j].imag + a[i][k].imag * b[k][j].real;
-            }
-            result[i][j] = temp;
-        }
+    if (ma.dados != NULL && mb.dados != NULL && mr.dados != NULL) {
+        matriz_produto(&ma, &mb, &mr);
+        matriz_para_linhas(&mr, result);
     }
+    matriz_libera(&ma);
+    matriz_libera(&mb);
+    matriz_libera(&mr);
 }
 
-///A função gsl_linalg_SV_decomp realiza a decomposição em valores singulares (Singular Value Decomposition - SVD) da matriz A. Essa função é chamada com os argumentos A, V, S e work para realizar a decomposição, calcula em três partes principais: matriz U, matriz V e vetor de valores singulares S. Os resultados são armazenados nas matrizes e vetores passados como argumentos. Em seguida, as matrizes V, U e o vetor S são exibidos no console. A SVD permite decompor uma matriz complexa em componentes mais simples, fornecendo informações sobre sua estrutura e propriedades.
+///Produto matricial de um lote de matrizes guardadas uma após a outra (camada sobre cgemm_lote).
+
+/// @param a Lote de primeiras matrizes de entrada.
+/// @param b Lote de segundas matrizes de entrada.
+/// @param result Lote de matrizes resultantes (deve ser alocado antes da chamada).
+/// @param l Número de linhas das primeiras matrizes.
+/// @param c Número de colunas das primeiras matrizes e número de linhas das segundas matrizes.
+/// @param m Número de colunas das segundas matrizes.
+/// @param lote Número de produtos.
+
+void produto_matricial_lote(const complex* a, const complex* b, complex* result, int l, int c, int m, int lote) {
+    cgemm_lote(l, c, m, (const float*) a, c, (long) l * c, (const float*) b, m, (long) c * m,
+               (float*) result, m, (long) l * m, lote);
+}
+
+///Calcula a decomposição em valores singulares (Singular Value Decomposition - SVD) da matriz a_data (M x n) com matriz_svd, que trabalha diretamente sobre números complexos por rotações de Jacobi, e exibe no console as matrizes V, U e o vetor de valores singulares S. A SVD permite decompor uma matriz complexa em componentes mais simples, fornecendo informações sobre sua estrutura e propriedades.
 
 void calc_svd(void) {
-    gsl_matrix *A = gsl_matrix_alloc(M, n);
-    gsl_matrix *V = gsl_matrix_alloc(n, n);
-    gsl_vector *S = gsl_vector_alloc(n);
-    gsl_vector *work = gsl_vector_alloc(n);
+    matriz matriz_a = matriz_de_a_data(M, n);
+
+    imprime_svd("Matriz A", &matriz_a);
+    matriz_libera(&matriz_a);
 }
 
 /// Essa função demonstra dois exemplos para cada operação com matrizes de 3 linhas por 3 colunas e um vetor de 3 posições (pro caso do produto escalar) e também o cálculo da svd.
 
 void dois_exemplos(void){
-    gsl_matrix *A = gsl_matrix_alloc(M, n);
-    gsl_matrix *V = gsl_matrix_alloc(n, n);
-    gsl_vector *S = gsl_vector_alloc(n);
-    gsl_vector *work = gsl_vector_alloc(n);
+    matriz matriz_a;
 
     int l, c, m, i, j;
     l=3;
@@ -574,142 +992,34 @@ void dois_exemplos(void){
 
     printf("\n");
 
-    printf("\nAviso: A matriz é complexa. Logo, será calculada a SVD somente da parte real da matriz:\n");
+    printf("\nA SVD é calculada diretamente sobre a matriz complexa:\n");
 
     printf("\n\n");
 
-    printf("Matriz A(SVD 3x2)\n");
-    for (i = 0; i < 3; i++) {
-        for (j = 0; j < 2; j++) {
-            printf("%.2f ", a[i][j].real);
-            gsl_matrix_set(A, i, j, a[i][j].real);
-        }
-        printf("\n");
-    }
-
-    gsl_linalg_SV_decomp(A, V, S, work);
-
-    printf("\n\nMatriz V\n");
-    for (i = 0; i < 2; i++) {
-        for (j = 0; j < 2; j++) {
-            printf("%.2f ", gsl_matrix_get(V, i, j));
-        }
-        printf("\n");
-    }
-
-    printf("\n\nMatriz U\n");
-    for (i = 0; i < 3; i++) {
-        for (j = 0; j < 2; j++) {
-            printf("%.2f ", gsl_matrix_get(A, i, j));
-        }
-        printf("\n");
+    matriz_a = matriz_de_linhas(a, 3, 2, 1);
+    if (matriz_a.dados != NULL) {
+        imprime_svd("Matriz A(SVD 3x2)", &matriz_a);
     }
-
-    printf("\n\nVetor S\n");
-    for (i = 0; i < 2; i++)
-        printf("%.2f ", gsl_vector_get(S, i));
-    printf("\n");
+    matriz_libera(&matriz_a);
 
     printf("\n\n");
 
-    printf("Matriz A(SVD 4x4)\n");
-    for (i = 0; i < 4; i++) {
-        for (j = 0; j < 4; j++) {
-            printf("%.2f ", a_data[i][j]);
-            gsl_matrix_set(A, i, j, a_data[i][j]);
-        }
-        printf("\n");
-    }
-
-    gsl_linalg_SV_decomp(A, V, S, work);
-
-    printf("\n\nMatriz V\n");
-    for (i = 0; i < 4; i++) {
-        for (j = 0; j < 4; j++) {
-            printf("%.2f ", gsl_matrix_get(V, i, j));
-        }
-        printf("\n");
-    }
-
-    printf("\n\nMatriz U\n");
-    for (i = 0; i < 4; i++) {
-        for (j = 0; j < 4; j++) {
-            printf("%.2f ", gsl_matrix_get(A, i, j));
-        }
-        printf("\n");
-    }
-
-    printf("\n\nVetor S\n");
-    for (i = 0; i < 4; i++)
-        printf("%.2f ", gsl_vector_get(S, i));
-    printf("\n");
+    matriz_a = matriz_de_a_data(4, 4);
+    imprime_svd("Matriz A(SVD 4x4)", &matriz_a);
+    matriz_libera(&matriz_a);
 
     printf("\n\n");
 
-    printf("Matriz A(SVD 6x5)\n");
-    for (i = 0; i < 6; i++) {
-        for (j = 0; j < 5; j++) {
-            printf("%.2f ", a_data[i][j]);
-            gsl_matrix_set(A, i, j, a_data[i][j]);
-        }
-        printf("\n");
-    }
-
-    gsl_linalg_SV_decomp(A, V, S, work);
-
-    printf("\n\nMatriz V\n");
-    for (i = 0; i < 5; i++) {
-        for (j = 0; j < 5; j++) {
-            printf("%.2f ", gsl_matrix_get(V, i, j));
-        }
-        printf("\n");
-    }
-
-    printf("\n\nMatriz U\n");
-    for (i = 0; i < 6; i++) {
-        for (j = 0; j < 5; j++) {
-            printf("%.2f ", gsl_matrix_get(A, i, j));
-        }
-        printf("\n");
-    }
-
-    printf("\n\nVetor S\n");
-    for (i = 0; i < 5; i++)
-        printf("%.2f ", gsl_vector_get(S, i));
-    printf("\n");
+    matriz_a = matriz_de_a_data(6, 5);
+    imprime_svd("Matriz A(SVD 6x5)", &matriz_a);
+    matriz_libera(&matriz_a);
 
     printf("\n\n");
 
-    printf("Matriz A(SVD 5x6)\n");
-    for (i = 0; i < 5; i++) {
-        for (j = 0; j < 6; j++) {
-            printf("%.2f ", a_data[i][j]);
-            gsl_matrix_set(A, i, j, a_data[i][j]);
-        }
-        printf("\n");
-    }
-
-    gsl_linalg_SV_decomp(A, V, S, work);
-
-    printf("\n\nMatriz V\n");
-    for (i = 0; i < 6; i++) {
-        for (j = 0; j < 6; j++) {
-            printf("%.2f ", gsl_matrix_get(V, i, j));
-        }
-        printf("\n");
-    }
-
-    printf("\n\nMatriz U\n");
-    for (i = 0; i < 5; i++) {
-        for (j = 0; j < 6; j++) {
-            printf("%.2f ", gsl_matrix_get(A, i, j));
-        }
-        printf("\n");
-    }
+    matriz_a = matriz_de_a_data(5, 6);
+    imprime_svd("Matriz A(SVD 5x6)", &matriz_a);
+    matriz_libera(&matriz_a);
 
-    printf("\n\nVetor S\n");
-    for (i = 0; i < 6; i++)
-        printf("%.2f ", gsl_vector_get(S, i));
     printf("\n\n");
 
     for (i = 0; i < l; i++) {
@@ -735,18 +1045,11 @@ void dois_exemplos(void){
     free(transposta_a);
     free(hermitiana_a);
     free(produto_matricial_a_b);
-    gsl_matrix_free(A);
-    gsl_matrix_free(V);
-    gsl_vector_free(S);
-    gsl_vector_free(work);
 }
 
-///Essa função executa todas as operações matriciais e vetoriais citadas ateriormente, mas com apenas um único resultado. também, faz a svd, com dimenções de 3x2, 4x4, 6x5 e 5x6, sendo que a primeira matriz(de dimenções 3x2) tem como entrada de elementos os números complexos, mas usa-se somente sua parte real.
+///Essa função executa todas as operações matriciais e vetoriais citadas ateriormente, mas com apenas um único resultado. também, faz a svd, com dimenções de 3x2, 4x4, 6x5 e 5x6, sendo que a primeira matriz(de dimenções 3x2) tem como entrada de elementos os números complexos, decompostos diretamente sem descartar a parte imaginária.
 void teste_todos(void) {
-    gsl_matrix *A = gsl_matrix_alloc(M, n);
-    gsl_matrix *V = gsl_matrix_alloc(n, n);
-    gsl_vector *S = gsl_vector_alloc(n);
-    gsl_vector *work = gsl_vector_alloc(n);
+    matriz matriz_a;
 
     int l, c, m, i, j;
     l=3;
@@ -1003,142 +1306,34 @@ void teste_todos(void) {
 
     printf("\n");
 
-    printf("\nAviso: A matriz é complexa. Logo, será calculada a SVD somente da parte real da matriz:\n");
+    printf("\nA SVD é calculada diretamente sobre a matriz complexa:\n");
 
     printf("\n\n");
 
-    printf("Matriz A(SVD 3x2)\n");
-    for (i = 0; i < 3; i++) {
-        for (j = 0; j < 2; j++) {
-            printf("%.2f ", a[i][j].real);
-            gsl_matrix_set(A, i, j, a[i][j].real);
-        }
-        printf("\n");
+    matriz_a = matriz_de_linhas(a, 3, 2, 1);
+    if (matriz_a.dados != NULL) {
+        imprime_svd("Matriz A(SVD 3x2)", &matriz_a);
     }
-
-    gsl_linalg_SV_decomp(A, V, S, work);
-
-    printf("\n\nMatriz V\n");
-    for (i = 0; i < 2; i++) {
-        for (j = 0; j < 2; j++) {
-            printf("%.2f ", gsl_matrix_get(V, i, j));
-        }
-        printf("\n");
-    }
-
-    printf("\n\nMatriz U\n");
-    for (i = 0; i < 3; i++) {
-        for (j = 0; j < 2; j++) {
-            printf("%.2f ", gsl_matrix_get(A, i, j));
-        }
-        printf("\n");
-    }
-
-    printf("\n\nVetor S\n");
-    for (i = 0; i < 2; i++)
-        printf("%.2f ", gsl_vector_get(S, i));
-    printf("\n");
+    matriz_libera(&matriz_a);
 
     printf("\n\n");
 
-    printf("Matriz A(SVD 4x4)\n");
-    for (i = 0; i < 4; i++) {
-        for (j = 0; j < 4; j++) {
-            printf("%.2f ", a_data[i][j]);
-            gsl_matrix_set(A, i, j, a_data[i][j]);
-        }
-        printf("\n");
-    }
-
-    gsl_linalg_SV_decomp(A, V, S, work);
-
-    printf("\n\nMatriz V\n");
-    for (i = 0; i < 4; i++) {
-        for (j = 0; j < 4; j++) {
-            printf("%.2f ", gsl_matrix_get(V, i, j));
-        }
-        printf("\n");
-    }
-
-    printf("\n\nMatriz U\n");
-    for (i = 0; i < 4; i++) {
-        for (j = 0; j < 4; j++) {
-            printf("%.2f ", gsl_matrix_get(A, i, j));
-        }
-        printf("\n");
-    }
-
-    printf("\n\nVetor S\n");
-    for (i = 0; i < 4; i++)
-        printf("%.2f ", gsl_vector_get(S, i));
-    printf("\n");
+    matriz_a = matriz_de_a_data(4, 4);
+    imprime_svd("Matriz A(SVD 4x4)", &matriz_a);
+    matriz_libera(&matriz_a);
 
     printf("\n\n");
 
-    printf("Matriz A(SVD 6x5)\n");
-    for (i = 0; i < 6; i++) {
-        for (j = 0; j < 5; j++) {
-            printf("%.2f ", a_data[i][j]);
-            gsl_matrix_set(A, i, j, a_data[i][j]);
-        }
-        printf("\n");
-    }
-
-    gsl_linalg_SV_decomp(A, V, S, work);
-
-    printf("\n\nMatriz V\n");
-    for (i = 0; i < 5; i++) {
-        for (j = 0; j < 5; j++) {
-            printf("%.2f ", gsl_matrix_get(V, i, j));
-        }
-        printf("\n");
-    }
-
-    printf("\n\nMatriz U\n");
-    for (i = 0; i < 6; i++) {
-        for (j = 0; j < 5; j++) {
-            printf("%.2f ", gsl_matrix_get(A, i, j));
-        }
-        printf("\n");
-    }
-
-    printf("\n\nVetor S\n");
-    for (i = 0; i < 5; i++)
-        printf("%.2f ", gsl_vector_get(S, i));
-    printf("\n");
+    matriz_a = matriz_de_a_data(6, 5);
+    imprime_svd("Matriz A(SVD 6x5)", &matriz_a);
+    matriz_libera(&matriz_a);
 
     printf("\n\n");
 
-    printf("Matriz A(SVD 5x6)\n");
-    for (i = 0; i < 5; i++) {
-        for (j = 0; j < 6; j++) {
-            printf("%.2f ", a_data[i][j]);
-            gsl_matrix_set(A, i, j, a_data[i][j]);
-        }
-        printf("\n");
-    }
+    matriz_a = matriz_de_a_data(5, 6);
+    imprime_svd("Matriz A(SVD 5x6)", &matriz_a);
+    matriz_libera(&matriz_a);
 
-    gsl_linalg_SV_decomp(A, V, S, work);
-
-    printf("\n\nMatriz V\n");
-    for (i = 0; i < 6; i++) {
-        for (j = 0; j < 6; j++) {
-            printf("%.2f ", gsl_matrix_get(V, i, j));
-        }
-        printf("\n");
-    }
-
-    printf("\n\nMatriz U\n");
-    for (i = 0; i < 5; i++) {
-        for (j = 0; j < 6; j++) {
-            printf("%.2f ", gsl_matrix_get(A, i, j));
-        }
-        printf("\n");
-    }
-
-    printf("\n\nVetor S\n");
-    for (i = 0; i < 6; i++)
-        printf("%.2f ", gsl_vector_get(S, i));
     printf("\n\n");
 
 
@@ -1165,8 +1360,4 @@ void teste_todos(void) {
     free(transposta_a);
     free(hermitiana_a);
     free(produto_matricial_a_b);
-    gsl_matrix_free(A);
-    gsl_matrix_free(V);
-    gsl_vector_free(S);
-    gsl_vector_free(work);
 }
\ No newline at end of file
@@ -4,6 +4,9 @@
 #ifndef MATRIZES_H
 #define MATRIZES_H
 
+#include <stddef.h>
+#include "svd_complexa.h"
+
 /// @brief Estrutura que representa um número complexo.
 
 typedef struct {
@@ -11,6 +14,165 @@ typedef struct {
     float imag; /**< Parte imaginária do número complexo. */
 } complex;
 
+/// @brief Alinhamento, em bytes, do buffer de dados de uma matriz (uma linha de cache).
+
+#define MATRIZ_ALINHAMENTO 64
+
+/// @brief Matriz complexa armazenada em um único buffer contíguo e alinhado.
+
+/// Os elementos são guardados por linhas: o elemento (i, j) fica em dados[i * ld + j].
+/// A dimensão principal (ld) pode ser maior que o número de colunas, o que permite
+/// representar sub-matrizes (visões) sem copiar os dados.
+
+typedef struct {
+    complex *dados;   /**< Ponteiro para o elemento (0, 0). */
+    int linhas;       /**< Número de linhas. */
+    int colunas;      /**< Número de colunas. */
+    int ld;           /**< Distância, em elementos, entre o início de duas linhas consecutivas. */
+    int proprietaria; /**< 1 se a matriz é dona do buffer, 0 se é apenas uma visão. */
+} matriz;
+
+/// @brief Acessa o elemento (i, j) de uma matriz.
+
+#define MATRIZ_ELEM(m, i, j) ((m)->dados[(size_t)(i) * (m)->ld + (j)])
+
+/// @brief Aloca uma matriz l x c zerada, com cada linha alinhada em MATRIZ_ALINHAMENTO bytes.
+
+/// @param l Número de linhas.
+/// @param c Número de colunas.
+/// @return A matriz alocada (dados == NULL em caso de falha).
+
+matriz matriz_aloca(int l, int c);
+
+/// @brief Libera o buffer de uma matriz. Visões não são liberadas.
+
+/// @param m Matriz a ser liberada.
+
+void matriz_libera(matriz* m);
+
+/// @brief Cria uma visão (sem cópia) de uma sub-matriz.
+
+/// @param m Matriz de origem.
+/// @param i0 Linha inicial.
+/// @param j0 Coluna inicial.
+/// @param l Número de linhas da visão.
+/// @param c Número de colunas da visão.
+/// @return A visão, que compartilha o buffer de m.
+
+matriz matriz_visao(const matriz* m, int i0, int j0, int l, int c);
+
+/// @brief Cria uma visão que toma uma linha a cada passo linhas da matriz de origem.
+
+/// @param m Matriz de origem.
+/// @param i0 Linha inicial.
+/// @param j0 Coluna inicial.
+/// @param l Número de linhas da visão.
+/// @param c Número de colunas da visão.
+/// @param passo Distância, em linhas de m, entre duas linhas consecutivas da visão.
+/// @return A visão, que compartilha o buffer de m.
+
+matriz matriz_visao_passo(const matriz* m, int i0, int j0, int l, int c, int passo);
+
+/// @brief Monta uma tabela de ponteiros de linha apontando para o buffer da matriz.
+
+/// Permite passar uma matriz contígua para código que ainda usa complex**.
+/// Somente a tabela deve ser liberada (com free), nunca as linhas.
+
+/// @param m Matriz de origem.
+/// @return Tabela com m->linhas ponteiros.
+
+complex** matriz_linhas(const matriz* m);
+
+/// @brief Calcula a matriz transposta (result deve ter c x l).
+
+void matriz_transposta(const matriz* a, matriz* result);
+
+/// @brief Calcula a matriz conjugada (result deve ter l x c).
+
+void matriz_conjugada(const matriz* a, matriz* result);
+
+/// @brief Calcula a matriz hermitiana (result deve ter c x l).
+
+void matriz_hermitiana(const matriz* a, matriz* result);
+
+/// @brief Calcula a soma de duas matrizes de mesma dimensão.
+
+void matriz_soma(const matriz* a, const matriz* b, matriz* result);
+
+/// @brief Calcula a subtração de duas matrizes de mesma dimensão.
+
+void matriz_subtracao(const matriz* a, const matriz* b, matriz* result);
+
+/// @brief Calcula o produto matricial result = a * b (result deve ter a->linhas x b->colunas).
+
+void matriz_produto(const matriz* a, const matriz* b, matriz* result);
+
+/// @brief Matriz complexa no formato planar: partes real e imaginária em buffers separados.
+
+/// Cada buffer segue o mesmo arranjo por linhas de matriz (elemento (i, j) em i * ld + j).
+/// Nesse formato uma multiplicação complexa vira multiplicações e somas sobre vetores
+/// reais, sem embaralhar pares (real, imag). É um formato opcional, para dados que já
+/// chegam separados: matriz_produto e produto_matricial continuam no formato intercalado,
+/// porque cgemm separa as partes ao empacotar os painéis e é tão rápido quanto
+/// cgemm_planar, que ainda pagaria as conversões.
+
+typedef struct {
+    float *real;      /**< Partes reais. */
+    float *imag;      /**< Partes imaginárias. */
+    int linhas;       /**< Número de linhas. */
+    int colunas;      /**< Número de colunas. */
+    int ld;           /**< Distância, em elementos, entre o início de duas linhas consecutivas. */
+    int proprietaria; /**< 1 se a matriz é dona dos buffers, 0 se é apenas uma visão. */
+} matriz_planar;
+
+/// @brief Aloca uma matriz planar l x c zerada, com linhas alinhadas em MATRIZ_ALINHAMENTO bytes.
+
+matriz_planar matriz_planar_aloca(int l, int c);
+
+/// @brief Libera os buffers de uma matriz planar. Visões não são liberadas.
+
+void matriz_planar_libera(matriz_planar* m);
+
+/// @brief Converte uma matriz intercalada para o formato planar (result deve ter as mesmas dimensões).
+
+void matriz_para_planar(const matriz* a, matriz_planar* result);
+
+/// @brief Converte uma matriz planar para o formato intercalado (result deve ter as mesmas dimensões).
+
+void matriz_de_planar(const matriz_planar* a, matriz* result);
+
+/// @brief Calcula a SVD reduzida a = u * diag(s) * v^H de uma matriz complexa.
+
+/// A decomposição é feita diretamente sobre os números complexos (Jacobi unilateral,
+/// ver svd_complexa.h), em precisão dupla. Com k = min(linhas, colunas), u deve ser
+/// linhas x k, s deve ter k posições e v deve ser colunas x k.
+
+/// @param a Matriz de entrada.
+/// @param u Matriz de saída com os vetores singulares à esquerda.
+/// @param s Vetor de saída com os valores singulares, em ordem decrescente.
+/// @param v Matriz de saída com os vetores singulares à direita.
+
+void matriz_svd(const matriz* a, matriz* u, float* s, matriz* v);
+
+/// @brief Versão de matriz_svd que usa um contexto criado antes (svd_contexto_aloca) e não aloca memória.
+
+/// O contexto deve ter sido criado com as dimensões de a e pode ser reutilizado por
+/// todas as decomposições dessas dimensões.
+
+/// @param ctx Contexto de SVD com as dimensões de a.
+/// @param a Matriz de entrada.
+/// @param u Matriz de saída com os vetores singulares à esquerda.
+/// @param s Vetor de saída com os valores singulares, em ordem decrescente.
+/// @param v Matriz de saída com os vetores singulares à direita.
+
+void matriz_svd_contexto(svd_contexto* ctx, const matriz* a, matriz* u, float* s, matriz* v);
+
+/// As funções a seguir recebem matrizes no formato antigo (complex**, uma alocação por linha).
+/// Elas são camadas de compatibilidade sobre as funções matriz_*: os operandos são sempre
+/// copiados para matrizes contíguas e o resultado é copiado de volta, mesmo quando as linhas
+/// vêm de matriz_linhas. Quem se importa com essas cópias deve usar diretamente a API matriz
+/// e as suas visões. Se faltar memória para as cópias, result não é alterado.
+
 /// @brief Calcula a matriz transposta.
  
 /// @param a Matriz de entrada.
@@ -78,6 +240,23 @@ void produto_escalar(complex* a, complex* b, complex* result, int tam);
 
 void produto_matricial(complex** a, complex** b, complex** result, int l, int c, int m);
 
+/// @brief Calcula o produto matricial de cada par de um lote de matrizes pequenas.
+
+/// As matrizes de cada lote ficam guardadas uma após a outra, por linhas: a matriz t
+/// de a começa em a + t * l * c, a de b em b + t * c * m e a de result em
+/// result + t * l * m. Equivale a chamar produto_matricial para cada t, mas os
+/// produtos são feitos juntos pelas posições dos vetores SIMD (ver cgemm_lote).
+
+/// @param a Lote de primeiras matrizes de entrada.
+/// @param b Lote de segundas matrizes de entrada.
+/// @param result Lote de matrizes resultantes (deve ser alocado antes da chamada).
+/// @param l Número de linhas das primeiras matrizes.
+/// @param c Número de colunas das primeiras matrizes e número de linhas das segundas matrizes.
+/// @param m Número de colunas das segundas matrizes.
+/// @param lote Número de produtos.
+
+void produto_matricial_lote(const complex* a, const complex* b, complex* result, int l, int c, int m, int lote);
+
 void calc_svd(void);
 
 /// @brief Executa dois exemplos de uso das funções.
@@ -0,0 +1,730 @@
+/// @file simd_complexo.c
+/// @brief Implementação dos kernels vetoriais para vetores complexos e do despacho por CPUID.
+
+/// Cada operação tem uma versão escalar (referência, usada também para as sobras no fim
+/// dos vetores) e versões SSE2, AVX2 e AVX-512 compiladas com o atributo target, de modo
+/// que um único binário roda em qualquer x86-64 e usa as instruções mais largas disponíveis.
+/// O produto complexo intercalado é feito com duplicação das partes de b e troca das
+/// partes de a: (ar, ai) * (br, bi) = (ar, ai) * br -/+ (ai, ar) * bi.
+
+#include <stdlib.h>
+#include <string.h>
+#include "simd_complexo.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SIMD_X86 1
+#include <immintrin.h>
+#else
+#define SIMD_X86 0
+#endif
+
+///Tabela de funções do nível em uso.
+typedef struct {
+    void (*c_soma)(const float*, const float*, float*, size_t);
+    void (*c_subtracao)(const float*, const float*, float*, size_t);
+    void (*c_conjugada)(const float*, float*, size_t);
+    void (*c_mac)(const float*, const float*, float*, size_t);
+    void (*c_axpy)(const float*, const float*, float*, size_t);
+    void (*c_separa)(const float*, float*, float*, size_t);
+    void (*c_intercala)(const float*, const float*, float*, size_t);
+    void (*z_conjugada)(const double*, double*, size_t);
+    void (*z_mac)(const double*, const double*, double*, size_t);
+    void (*z_axpy)(const double*, const double*, double*, size_t);
+} simd_tabela;
+
+/* ---------------------------------------------------------------------------------- */
+/* Versões escalares                                                                   */
+/* ---------------------------------------------------------------------------------- */
+
+static void c_soma_escalar(const float* a, const float* b, float* r, size_t tam) {
+    size_t i;
+
+    for (i = 0; i < 2 * tam; i++) {
+        r[i] = a[i] + b[i];
+    }
+}
+
+static void c_subtracao_escalar(const float* a, const float* b, float* r, size_t tam) {
+    size_t i;
+
+    for (i = 0; i < 2 * tam; i++) {
+        r[i] = a[i] - b[i];
+    }
+}
+
+static void c_conjugada_escalar(const float* a, float* r, size_t tam) {
+    size_t i;
+
+    for (i = 0; i < tam; i++) {
+        r[2 * i] = a[2 * i];
+        r[2 * i + 1] = -a[2 * i + 1];
+    }
+}
+
+static void c_mac_escalar(const float* a, const float* b, float* acc, size_t tam) {
+    float re = 0, im = 0;
+    size_t i;
+
+    for (i = 0; i < tam; i++) {
+        re += a[2 * i] * b[2 * i] - a[2 * i + 1] * b[2 * i + 1];
+        im += a[2 * i] * b[2 * i + 1] + a[2 * i + 1] * b[2 * i];
+    }
+    acc[0] += re;
+    acc[1] += im;
+}
+
+static void c_axpy_escalar(const float* alfa, const float* x, float* y, size_t tam) {
+    float ar = alfa[0], ai = alfa[1];
+    size_t i;
+
+    for (i = 0; i < tam; i++) {
+        float xr = x[2 * i], xi = x[2 * i + 1];
+
+        y[2 * i] += ar * xr - ai * xi;
+        y[2 * i + 1] += ar * xi + ai * xr;
+    }
+}
+
+static void c_separa_escalar(const float* x, float* re, float* im, size_t tam) {
+    size_t i;
+
+    for (i = 0; i < tam; i++) {
+        re[i] = x[2 * i];
+        im[i] = x[2 * i + 1];
+    }
+}
+
+static void c_intercala_escalar(const float* re, const float* im, float* x, size_t tam) {
+    size_t i;
+
+    for (i = 0; i < tam; i++) {
+        x[2 * i] = re[i];
+        x[2 * i + 1] = im[i];
+    }
+}
+
+static void z_conjugada_escalar(const double* a, double* r, size_t tam) {
+    size_t i;
+
+    for (i = 0; i < tam; i++) {
+        r[2 * i] = a[2 * i];
+        r[2 * i + 1] = -a[2 * i + 1];
+    }
+}
+
+static void z_mac_escalar(const double* a, const double* b, double* acc, size_t tam) {
+    double re = 0, im = 0;
+    size_t i;
+
+    for (i = 0; i < tam; i++) {
+        re += a[2 * i] * b[2 * i] - a[2 * i + 1] * b[2 * i + 1];
+        im += a[2 * i] * b[2 * i + 1] + a[2 * i + 1] * b[2 * i];
+    }
+    acc[0] += re;
+    acc[1] += im;
+}
+
+static void z_axpy_escalar(const double* alfa, const double* x, double* y, size_t tam) {
+    double ar = alfa[0], ai = alfa[1];
+    size_t i;
+
+    for (i = 0; i < tam; i++) {
+        double xr = x[2 * i], xi = x[2 * i + 1];
+
+        y[2 * i] += ar * xr - ai * xi;
+        y[2 * i + 1] += ar * xi + ai * xr;
+    }
+}
+
+static const simd_tabela tabela_escalar = {
+    c_soma_escalar, c_subtracao_escalar, c_conjugada_escalar, c_mac_escalar, c_axpy_escalar, c_separa_escalar, c_intercala_escalar,
+    z_conjugada_escalar, z_mac_escalar, z_axpy_escalar
+};
+
+#if SIMD_X86
+
+/* ---------------------------------------------------------------------------------- */
+/* SSE2: 2 complexos float ou 1 complexo double por registrador                        */
+/* ---------------------------------------------------------------------------------- */
+
+__attribute__((target("sse2")))
+static void c_soma_sse2(const float* a, const float* b, float* r, size_t tam) {
+    size_t i = 0;
+
+    for (; i + 2 <= tam; i += 2) {
+        _mm_storeu_ps(r + 2 * i, _mm_add_ps(_mm_loadu_ps(a + 2 * i), _mm_loadu_ps(b + 2 * i)));
+    }
+    c_soma_escalar(a + 2 * i, b + 2 * i, r + 2 * i, tam - i);
+}
+
+__attribute__((target("sse2")))
+static void c_subtracao_sse2(const float* a, const float* b, float* r, size_t tam) {
+    size_t i = 0;
+
+    for (; i + 2 <= tam; i += 2) {
+        _mm_storeu_ps(r + 2 * i, _mm_sub_ps(_mm_loadu_ps(a + 2 * i), _mm_loadu_ps(b + 2 * i)));
+    }
+    c_subtracao_escalar(a + 2 * i, b + 2 * i, r + 2 * i, tam - i);
+}
+
+__attribute__((target("sse2")))
+static void c_conjugada_sse2(const float* a, float* r, size_t tam) {
+    const __m128 sinal = _mm_set_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+    size_t i = 0;
+
+    for (; i + 2 <= tam; i += 2) {
+        _mm_storeu_ps(r + 2 * i, _mm_xor_ps(_mm_loadu_ps(a + 2 * i), sinal));
+    }
+    c_conjugada_escalar(a + 2 * i, r + 2 * i, tam - i);
+}
+
+__attribute__((target("sse2")))
+static void c_mac_sse2(const float* a, const float* b, float* acc, size_t tam) {
+    const __m128 sinal = _mm_set_ps(0.0f, -0.0f, 0.0f, -0.0f);
+    __m128 s1 = _mm_setzero_ps(), s2 = _mm_setzero_ps();
+    float t[4];
+    size_t i = 0;
+
+    for (; i + 2 <= tam; i += 2) {
+        __m128 va = _mm_loadu_ps(a + 2 * i);
+        __m128 vb = _mm_loadu_ps(b + 2 * i);
+        __m128 b_re = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 b_im = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(3, 3, 1, 1));
+        __m128 a_tr = _mm_shuffle_ps(va, va, _MM_SHUFFLE(2, 3, 0, 1));
+
+        s1 = _mm_add_ps(s1, _mm_mul_ps(va, b_re));
+        s2 = _mm_add_ps(s2, _mm_mul_ps(a_tr, b_im));
+    }
+    _mm_storeu_ps(t, _mm_add_ps(s1, _mm_xor_ps(s2, sinal)));
+    acc[0] += t[0] + t[2];
+    acc[1] += t[1] + t[3];
+    c_mac_escalar(a + 2 * i, b + 2 * i, acc, tam - i);
+}
+
+__attribute__((target("sse2")))
+static void c_axpy_sse2(const float* alfa, const float* x, float* y, size_t tam) {
+    const __m128 ar = _mm_set1_ps(alfa[0]);
+    const __m128 ai = _mm_set_ps(alfa[1], -alfa[1], alfa[1], -alfa[1]);
+    size_t i = 0;
+
+    for (; i + 2 <= tam; i += 2) {
+        __m128 vx = _mm_loadu_ps(x + 2 * i);
+        __m128 x_tr = _mm_shuffle_ps(vx, vx, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128 p = _mm_add_ps(_mm_mul_ps(vx, ar), _mm_mul_ps(x_tr, ai));
+
+        _mm_storeu_ps(y + 2 * i, _mm_add_ps(_mm_loadu_ps(y + 2 * i), p));
+    }
+    c_axpy_escalar(alfa, x + 2 * i, y + 2 * i, tam - i);
+}
+
+__attribute__((target("sse2")))
+static void c_separa_sse2(const float* x, float* re, float* im, size_t tam) {
+    size_t i = 0;
+
+    for (; i + 4 <= tam; i += 4) {
+        __m128 x0 = _mm_loadu_ps(x + 2 * i);
+        __m128 x1 = _mm_loadu_ps(x + 2 * i + 4);
+
+        _mm_storeu_ps(re + i, _mm_shuffle_ps(x0, x1, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(im + i, _mm_shuffle_ps(x0, x1, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+    c_separa_escalar(x + 2 * i, re + i, im + i, tam - i);
+}
+
+__attribute__((target("sse2")))
+static void c_intercala_sse2(const float* re, const float* im, float* x, size_t tam) {
+    size_t i = 0;
+
+    for (; i + 4 <= tam; i += 4) {
+        __m128 vr = _mm_loadu_ps(re + i);
+        __m128 vi = _mm_loadu_ps(im + i);
+
+        _mm_storeu_ps(x + 2 * i, _mm_unpacklo_ps(vr, vi));
+        _mm_storeu_ps(x + 2 * i + 4, _mm_unpackhi_ps(vr, vi));
+    }
+    c_intercala_escalar(re + i, im + i, x + 2 * i, tam - i);
+}
+
+__attribute__((target("sse2")))
+static void z_conjugada_sse2(const double* a, double* r, size_t tam) {
+    const __m128d sinal = _mm_set_pd(-0.0, 0.0);
+    size_t i;
+
+    for (i = 0; i < tam; i++) {
+        _mm_storeu_pd(r + 2 * i, _mm_xor_pd(_mm_loadu_pd(a + 2 * i), sinal));
+    }
+}
+
+__attribute__((target("sse2")))
+static void z_mac_sse2(const double* a, const double* b, double* acc, size_t tam) {
+    const __m128d sinal = _mm_set_pd(0.0, -0.0);
+    __m128d s1 = _mm_setzero_pd(), s2 = _mm_setzero_pd();
+    size_t i;
+
+    for (i = 0; i < tam; i++) {
+        __m128d va = _mm_loadu_pd(a + 2 * i);
+        __m128d vb = _mm_loadu_pd(b + 2 * i);
+
+        s1 = _mm_add_pd(s1, _mm_mul_pd(va, _mm_unpacklo_pd(vb, vb)));
+        s2 = _mm_add_pd(s2, _mm_mul_pd(_mm_shuffle_pd(va, va, 1), _mm_unpackhi_pd(vb, vb)));
+    }
+    _mm_storeu_pd(acc, _mm_add_pd(_mm_loadu_pd(acc), _mm_add_pd(s1, _mm_xor_pd(s2, sinal))));
+}
+
+__attribute__((target("sse2")))
+static void z_axpy_sse2(const double* alfa, const double* x, double* y, size_t tam) {
+    const __m128d ar = _mm_set1_pd(alfa[0]);
+    const __m128d ai = _mm_set_pd(alfa[1], -alfa[1]);
+    size_t i;
+
+    for (i = 0; i < tam; i++) {
+        __m128d vx = _mm_loadu_pd(x + 2 * i);
+        __m128d p = _mm_add_pd(_mm_mul_pd(vx, ar), _mm_mul_pd(_mm_shuffle_pd(vx, vx, 1), ai));
+
+        _mm_storeu_pd(y + 2 * i, _mm_add_pd(_mm_loadu_pd(y + 2 * i), p));
+    }
+}
+
+static const simd_tabela tabela_sse2 = {
+    c_soma_sse2, c_subtracao_sse2, c_conjugada_sse2, c_mac_sse2, c_axpy_sse2, c_separa_sse2, c_intercala_sse2,
+    z_conjugada_sse2, z_mac_sse2, z_axpy_sse2
+};
+
+/* ---------------------------------------------------------------------------------- */
+/* AVX2 + FMA: 4 complexos float ou 2 complexos double por registrador                 */
+/* ---------------------------------------------------------------------------------- */
+
+__attribute__((target("avx2,fma")))
+static void c_soma_avx2(const float* a, const float* b, float* r, size_t tam) {
+    size_t i = 0;
+
+    for (; i + 4 <= tam; i += 4) {
+        _mm256_storeu_ps(r + 2 * i, _mm256_add_ps(_mm256_loadu_ps(a + 2 * i), _mm256_loadu_ps(b + 2 * i)));
+    }
+    c_soma_escalar(a + 2 * i, b + 2 * i, r + 2 * i, tam - i);
+}
+
+__attribute__((target("avx2,fma")))
+static void c_subtracao_avx2(const float* a, const float* b, float* r, size_t tam) {
+    size_t i = 0;
+
+    for (; i + 4 <= tam; i += 4) {
+        _mm256_storeu_ps(r + 2 * i, _mm256_sub_ps(_mm256_loadu_ps(a + 2 * i), _mm256_loadu_ps(b + 2 * i)));
+    }
+    c_subtracao_escalar(a + 2 * i, b + 2 * i, r + 2 * i, tam - i);
+}
+
+__attribute__((target("avx2,fma")))
+static void c_conjugada_avx2(const float* a, float* r, size_t tam) {
+    const __m256 sinal = _mm256_set_ps(-0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f);
+    size_t i = 0;
+
+    for (; i + 4 <= tam; i += 4) {
+        _mm256_storeu_ps(r + 2 * i, _mm256_xor_ps(_mm256_loadu_ps(a + 2 * i), sinal));
+    }
+    c_conjugada_escalar(a + 2 * i, r + 2 * i, tam - i);
+}
+
+__attribute__((target("avx2,fma")))
+static void c_mac_avx2(const float* a, const float* b, float* acc, size_t tam) {
+    __m256 s1 = _mm256_setzero_ps(), s2 = _mm256_setzero_ps();
+    float t[8];
+    size_t i = 0;
+
+    for (; i + 4 <= tam; i += 4) {
+        __m256 va = _mm256_loadu_ps(a + 2 * i);
+        __m256 vb = _mm256_loadu_ps(b + 2 * i);
+
+        s1 = _mm256_fmadd_ps(va, _mm256_moveldup_ps(vb), s1);
+        s2 = _mm256_fmadd_ps(_mm256_permute_ps(va, 0xB1), _mm256_movehdup_ps(vb), s2);
+    }
+    _mm256_storeu_ps(t, _mm256_addsub_ps(s1, s2));
+    acc[0] += (t[0] + t[2]) + (t[4] + t[6]);
+    acc[1] += (t[1] + t[3]) + (t[5] + t[7]);
+    c_mac_escalar(a + 2 * i, b + 2 * i, acc, tam - i);
+}
+
+__attribute__((target("avx2,fma")))
+static void c_axpy_avx2(const float* alfa, const float* x, float* y, size_t tam) {
+    const __m256 ar = _mm256_set1_ps(alfa[0]);
+    const __m256 ai = _mm256_set1_ps(alfa[1]);
+    size_t i = 0;
+
+    for (; i + 4 <= tam; i += 4) {
+        __m256 vx = _mm256_loadu_ps(x + 2 * i);
+        __m256 p = _mm256_fmaddsub_ps(vx, ar, _mm256_mul_ps(_mm256_permute_ps(vx, 0xB1), ai));
+
+        _mm256_storeu_ps(y + 2 * i, _mm256_add_ps(_mm256_loadu_ps(y + 2 * i), p));
+    }
+    c_axpy_escalar(alfa, x + 2 * i, y + 2 * i, tam - i);
+}
+
+__attribute__((target("avx2,fma")))
+static void c_separa_avx2(const float* x, float* re, float* im, size_t tam) {
+    size_t i = 0;
+
+    for (; i + 8 <= tam; i += 8) {
+        __m256 x0 = _mm256_loadu_ps(x + 2 * i);
+        __m256 x1 = _mm256_loadu_ps(x + 2 * i + 8);
+        __m256 pr = _mm256_shuffle_ps(x0, x1, _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 pi = _mm256_shuffle_ps(x0, x1, _MM_SHUFFLE(3, 1, 3, 1));
+
+        _mm256_storeu_ps(re + i, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(pr), 0xD8)));
+        _mm256_storeu_ps(im + i, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(pi), 0xD8)));
+    }
+    c_separa_escalar(x + 2 * i, re + i, im + i, tam - i);
+}
+
+__attribute__((target("avx2,fma")))
+static void c_intercala_avx2(const float* re, const float* im, float* x, size_t tam) {
+    size_t i = 0;
+
+    for (; i + 8 <= tam; i += 8) {
+        __m256 vr = _mm256_loadu_ps(re + i);
+        __m256 vi = _mm256_loadu_ps(im + i);
+        __m256 lo = _mm256_unpacklo_ps(vr, vi);
+        __m256 hi = _mm256_unpackhi_ps(vr, vi);
+
+        _mm256_storeu_ps(x + 2 * i, _mm256_permute2f128_ps(lo, hi, 0x20));
+        _mm256_storeu_ps(x + 2 * i + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+    c_intercala_escalar(re + i, im + i, x + 2 * i, tam - i);
+}
+
+__attribute__((target("avx2,fma")))
+static void z_conjugada_avx2(const double* a, double* r, size_t tam) {
+    const __m256d sinal = _mm256_set_pd(-0.0, 0.0, -0.0, 0.0);
+    size_t i = 0;
+
+    for (; i + 2 <= tam; i += 2) {
+        _mm256_storeu_pd(r + 2 * i, _mm256_xor_pd(_mm256_loadu_pd(a + 2 * i), sinal));
+    }
+    z_conjugada_escalar(a + 2 * i, r + 2 * i, tam - i);
+}
+
+__attribute__((target("avx2,fma")))
+static void z_mac_avx2(const double* a, const double* b, double* acc, size_t tam) {
+    __m256d s1 = _mm256_setzero_pd(), s2 = _mm256_setzero_pd();
+    double t[4];
+    size_t i = 0;
+
+    for (; i + 2 <= tam; i += 2) {
+        __m256d va = _mm256_loadu_pd(a + 2 * i);
+        __m256d vb = _mm256_loadu_pd(b + 2 * i);
+
+        s1 = _mm256_fmadd_pd(va, _mm256_movedup_pd(vb), s1);
+        s2 = _mm256_fmadd_pd(_mm256_permute_pd(va, 0x5), _mm256_permute_pd(vb, 0xF), s2);
+    }
+    _mm256_storeu_pd(t, _mm256_addsub_pd(s1, s2));
+    acc[0] += t[0] + t[2];
+    acc[1] += t[1] + t[3];
+    z_mac_escalar(a + 2 * i, b + 2 * i, acc, tam - i);
+}
+
+__attribute__((target("avx2,fma")))
+static void z_axpy_avx2(const double* alfa, const double* x, double* y, size_t tam) {
+    const __m256d ar = _mm256_set1_pd(alfa[0]);
+    const __m256d ai = _mm256_set1_pd(alfa[1]);
+    size_t i = 0;
+
+    for (; i + 2 <= tam; i += 2) {
+        __m256d vx = _mm256_loadu_pd(x + 2 * i);
+        __m256d p = _mm256_fmaddsub_pd(vx, ar, _mm256_mul_pd(_mm256_permute_pd(vx, 0x5), ai));
+
+        _mm256_storeu_pd(y + 2 * i, _mm256_add_pd(_mm256_loadu_pd(y + 2 * i), p));
+    }
+    z_axpy_escalar(alfa, x + 2 * i, y + 2 * i, tam - i);
+}
+
+static const simd_tabela tabela_avx2 = {
+    c_soma_avx2, c_subtracao_avx2, c_conjugada_avx2, c_mac_avx2, c_axpy_avx2, c_separa_avx2, c_intercala_avx2,
+    z_conjugada_avx2, z_mac_avx2, z_axpy_avx2
+};
+
+/* ---------------------------------------------------------------------------------- */
+/* AVX-512F: 8 complexos float ou 4 complexos double por registrador                   */
+/* ---------------------------------------------------------------------------------- */
+
+__attribute__((target("avx512f")))
+static void c_soma_avx512(const float* a, const float* b, float* r, size_t tam) {
+    size_t i = 0;
+
+    for (; i + 8 <= tam; i += 8) {
+        _mm512_storeu_ps(r + 2 * i, _mm512_add_ps(_mm512_loadu_ps(a + 2 * i), _mm512_loadu_ps(b + 2 * i)));
+    }
+    c_soma_escalar(a + 2 * i, b + 2 * i, r + 2 * i, tam - i);
+}
+
+__attribute__((target("avx512f")))
+static void c_subtracao_avx512(const float* a, const float* b, float* r, size_t tam) {
+    size_t i = 0;
+
+    for (; i + 8 <= tam; i += 8) {
+        _mm512_storeu_ps(r + 2 * i, _mm512_sub_ps(_mm512_loadu_ps(a + 2 * i), _mm512_loadu_ps(b + 2 * i)));
+    }
+    c_subtracao_escalar(a + 2 * i, b + 2 * i, r + 2 * i, tam - i);
+}
+
+__attribute__((target("avx512f")))
+static void c_conjugada_avx512(const float* a, float* r, size_t tam) {
+    const __m512 zero = _mm512_setzero_ps();
+    size_t i = 0;
+
+    for (; i + 8 <= tam; i += 8) {
+        __m512 va = _mm512_loadu_ps(a + 2 * i);
+
+        _mm512_storeu_ps(r + 2 * i, _mm512_mask_sub_ps(va, 0xAAAA, zero, va));
+    }
+    c_conjugada_escalar(a + 2 * i, r + 2 * i, tam - i);
+}
+
+__attribute__((target("avx512f")))
+static void c_mac_avx512(const float* a, const float* b, float* acc, size_t tam) {
+    __m512 s1 = _mm512_setzero_ps(), s2 = _mm512_setzero_ps();
+    __m512 t;
+    size_t i = 0;
+
+    for (; i + 8 <= tam; i += 8) {
+        __m512 va = _mm512_loadu_ps(a + 2 * i);
+        __m512 vb = _mm512_loadu_ps(b + 2 * i);
+
+        s1 = _mm512_fmadd_ps(va, _mm512_moveldup_ps(vb), s1);
+        s2 = _mm512_fmadd_ps(_mm512_permute_ps(va, 0xB1), _mm512_movehdup_ps(vb), s2);
+    }
+    t = _mm512_mask_add_ps(_mm512_sub_ps(s1, s2), 0xAAAA, s1, s2);
+    acc[0] += _mm512_mask_reduce_add_ps(0x5555, t);
+    acc[1] += _mm512_mask_reduce_add_ps(0xAAAA, t);
+    c_mac_escalar(a + 2 * i, b + 2 * i, acc, tam - i);
+}
+
+__attribute__((target("avx512f")))
+static void c_axpy_avx512(const float* alfa, const float* x, float* y, size_t tam) {
+    const __m512 ar = _mm512_set1_ps(alfa[0]);
+    const __m512 ai = _mm512_set1_ps(alfa[1]);
+    size_t i = 0;
+
+    for (; i + 8 <= tam; i += 8) {
+        __m512 vx = _mm512_loadu_ps(x + 2 * i);
+        __m512 p = _mm512_fmaddsub_ps(vx, ar, _mm512_mul_ps(_mm512_permute_ps(vx, 0xB1), ai));
+
+        _mm512_storeu_ps(y + 2 * i, _mm512_add_ps(_mm512_loadu_ps(y + 2 * i), p));
+    }
+    c_axpy_escalar(alfa, x + 2 * i, y + 2 * i, tam - i);
+}
+
+__attribute__((target("avx512f")))
+static void c_separa_avx512(const float* x, float* re, float* im, size_t tam) {
+    const __m512i pares = _mm512_set_epi32(30, 28, 26, 24, 22, 20, 18, 16, 14, 12, 10, 8, 6, 4, 2, 0);
+    const __m512i impares = _mm512_set_epi32(31, 29, 27, 25, 23, 21, 19, 17, 15, 13, 11, 9, 7, 5, 3, 1);
+    size_t i = 0;
+
+    for (; i + 16 <= tam; i += 16) {
+        __m512 x0 = _mm512_loadu_ps(x + 2 * i);
+        __m512 x1 = _mm512_loadu_ps(x + 2 * i + 16);
+
+        _mm512_storeu_ps(re + i, _mm512_permutex2var_ps(x0, pares, x1));
+        _mm512_storeu_ps(im + i, _mm512_permutex2var_ps(x0, impares, x1));
+    }
+    c_separa_escalar(x + 2 * i, re + i, im + i, tam - i);
+}
+
+__attribute__((target("avx512f")))
+static void c_intercala_avx512(const float* re, const float* im, float* x, size_t tam) {
+    const __m512i baixa = _mm512_set_epi32(23, 7, 22, 6, 21, 5, 20, 4, 19, 3, 18, 2, 17, 1, 16, 0);
+    const __m512i alta = _mm512_set_epi32(31, 15, 30, 14, 29, 13, 28, 12, 27, 11, 26, 10, 25, 9, 24, 8);
+    size_t i = 0;
+
+    for (; i + 16 <= tam; i += 16) {
+        __m512 vr = _mm512_loadu_ps(re + i);
+        __m512 vi = _mm512_loadu_ps(im + i);
+
+        _mm512_storeu_ps(x + 2 * i, _mm512_permutex2var_ps(vr, baixa, vi));
+        _mm512_storeu_ps(x + 2 * i + 16, _mm512_permutex2var_ps(vr, alta, vi));
+    }
+    c_intercala_escalar(re + i, im + i, x + 2 * i, tam - i);
+}
+
+__attribute__((target("avx512f")))
+static void z_conjugada_avx512(const double* a, double* r, size_t tam) {
+    const __m512d zero = _mm512_setzero_pd();
+    size_t i = 0;
+
+    for (; i + 4 <= tam; i += 4) {
+        __m512d va = _mm512_loadu_pd(a + 2 * i);
+
+        _mm512_storeu_pd(r + 2 * i, _mm512_mask_sub_pd(va, 0xAA, zero, va));
+    }
+    z_conjugada_escalar(a + 2 * i, r + 2 * i, tam - i);
+}
+
+__attribute__((target("avx512f")))
+static void z_mac_avx512(const double* a, const double* b, double* acc, size_t tam) {
+    __m512d s1 = _mm512_setzero_pd(), s2 = _mm512_setzero_pd();
+    __m512d t;
+    size_t i = 0;
+
+    for (; i + 4 <= tam; i += 4) {
+        __m512d va = _mm512_loadu_pd(a + 2 * i);
+        __m512d vb = _mm512_loadu_pd(b + 2 * i);
+
+        s1 = _mm512_fmadd_pd(va, _mm512_movedup_pd(vb), s1);
+        s2 = _mm512_fmadd_pd(_mm512_permute_pd(va, 0x55), _mm512_permute_pd(vb, 0xFF), s2);
+    }
+    t = _mm512_mask_add_pd(_mm512_sub_pd(s1, s2), 0xAA, s1, s2);
+    acc[0] += _mm512_mask_reduce_add_pd(0x55, t);
+    acc[1] += _mm512_mask_reduce_add_pd(0xAA, t);
+    z_mac_escalar(a + 2 * i, b + 2 * i, acc, tam - i);
+}
+
+__attribute__((target("avx512f")))
+static void z_axpy_avx512(const double* alfa, const double* x, double* y, size_t tam) {
+    const __m512d ar = _mm512_set1_pd(alfa[0]);
+    const __m512d ai = _mm512_set1_pd(alfa[1]);
+    size_t i = 0;
+
+    for (; i + 4 <= tam; i += 4) {
+        __m512d vx = _mm512_loadu_pd(x + 2 * i);
+        __m512d p = _mm512_fmaddsub_pd(vx, ar, _mm512_mul_pd(_mm512_permute_pd(vx, 0x55), ai));
+
+        _mm512_storeu_pd(y + 2 * i, _mm512_add_pd(_mm512_loadu_pd(y + 2 * i), p));
+    }
+    z_axpy_escalar(alfa, x + 2 * i, y + 2 * i, tam - i);
+}
+
+static const simd_tabela tabela_avx512 = {
+    c_soma_avx512, c_subtracao_avx512, c_conjugada_avx512, c_mac_avx512, c_axpy_avx512, c_separa_avx512, c_intercala_avx512,
+    z_conjugada_avx512, z_mac_avx512, z_axpy_avx512
+};
+
+#endif // SIMD_X86
+
+/* ---------------------------------------------------------------------------------- */
+/* Despacho                                                                            */
+/* ---------------------------------------------------------------------------------- */
+
+///Tabela em uso. Começa na versão escalar para que chamadas anteriores à inicialização funcionem.
+static const simd_tabela* tabela = &tabela_escalar;
+
+///Nível em uso.
+static int nivel_atual = SIMD_ESCALAR;
+
+///Maior nível suportado pela CPU, consultando CPUID.
+
+static int nivel_suportado(void) {
+#if SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return SIMD_AVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return SIMD_AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return SIMD_SSE2;
+    }
+#endif
+    return SIMD_ESCALAR;
+}
+
+///Define o nível em uso, limitado ao suportado pela CPU.
+
+/// @param nivel Um dos valores SIMD_*.
+/// @return O nível efetivamente adotado.
+
+int simd_define_nivel(int nivel) {
+    int maximo = nivel_suportado();
+
+    if (nivel > maximo) {
+        nivel = maximo;
+    }
+    if (nivel < SIMD_ESCALAR) {
+        nivel = SIMD_ESCALAR;
+    }
+    switch (nivel) {
+#if SIMD_X86
+    case SIMD_AVX512:
+        tabela = &tabela_avx512;
+        break;
+    case SIMD_AVX2:
+        tabela = &tabela_avx2;
+        break;
+    case SIMD_SSE2:
+        tabela = &tabela_sse2;
+        break;
+#endif
+    default:
+        tabela = &tabela_escalar;
+        break;
+    }
+    nivel_atual = nivel;
+    return nivel;
+}
+
+///Escolhe o nível na inicialização do programa: o maior suportado, ou o pedido em SIMD_NIVEL.
+
+__attribute__((constructor))
+static void simd_inicializa(void) {
+    const char* pedido = getenv("SIMD_NIVEL");
+    int nivel = SIMD_AVX512;
+
+    if (pedido != NULL) {
+        if (strcmp(pedido, "escalar") == 0) {
+            nivel = SIMD_ESCALAR;
+        } else if (strcmp(pedido, "sse2") == 0) {
+            nivel = SIMD_SSE2;
+        } else if (strcmp(pedido, "avx2") == 0) {
+            nivel = SIMD_AVX2;
+        }
+    }
+    simd_define_nivel(nivel);
+}
+
+int simd_nivel(void) {
+    return nivel_atual;
+}
+
+const char* simd_nome(void) {
+    static const char* nomes[] = { "escalar", "sse2", "avx2", "avx512" };
+
+    return nomes[nivel_atual];
+}
+
+void cvet_soma(const float* a, const float* b, float* r, size_t tam) {
+    tabela->c_soma(a, b, r, tam);
+}
+
+void cvet_subtracao(const float* a, const float* b, float* r, size_t tam) {
+    tabela->c_subtracao(a, b, r, tam);
+}
+
+void cvet_conjugada(const float* a, float* r, size_t tam) {
+    tabela->c_conjugada(a, r, tam);
+}
+
+void cvet_mac(const float* a, const float* b, float* acc, size_t tam) {
+    tabela->c_mac(a, b, acc, tam);
+}
+
+void cvet_axpy(const float* alfa, const float* x, float* y, size_t tam) {
+    tabela->c_axpy(alfa, x, y, tam);
+}
+
+void cvet_separa(const float* x, float* re, float* im, size_t tam) {
+    tabela->c_separa(x, re, im, tam);
+}
+
+void cvet_intercala(const float* re, const float* im, float* x, size_t tam) {
+    tabela->c_intercala(re, im, x, tam);
+}
+
+void zvet_conjugada(const double* a, double* r, size_t tam) {
+    tabela->z_conjugada(a, r, tam);
+}
+
+void zvet_mac(const double* a, const double* b, double* acc, size_t tam) {
+    tabela->z_mac(a, b, acc, tam);
+}
+
+void zvet_axpy(const double* alfa, const double* x, double* y, size_t tam) {
+    tabela->z_axpy(alfa, x, y, tam);
+}
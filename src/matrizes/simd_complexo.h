@@ -0,0 +1,94 @@
+/// @file simd_complexo.h
+/// @brief Kernels vetoriais (SSE2/AVX2/AVX-512) para vetores complexos, escolhidos em tempo de execução.
+
+/// Os vetores são guardados com parte real e imaginária intercaladas, que é o formato
+/// tanto de um vetor de complex (matrizes.h) quanto de um vetor de double complex
+/// (complex.h). Por isso as funções recebem ponteiros para float/double e o tamanho
+/// é dado em números complexos. As funções cvet_* operam em precisão simples e as
+/// zvet_* em precisão dupla.
+
+#ifndef SIMD_COMPLEXO_H
+#define SIMD_COMPLEXO_H
+
+#include <stddef.h>
+
+/// @brief Conjuntos de instruções suportados, do mais simples ao mais largo.
+
+enum {
+    SIMD_ESCALAR = 0, /**< Código C sem intrínsecos. */
+    SIMD_SSE2 = 1,    /**< 128 bits. */
+    SIMD_AVX2 = 2,    /**< 256 bits com FMA. */
+    SIMD_AVX512 = 3   /**< 512 bits (AVX-512F). */
+};
+
+/// @brief Retorna o conjunto de instruções em uso.
+
+/// Na inicialização do programa o maior nível suportado pela CPU (CPUID) é escolhido.
+/// A variável de ambiente SIMD_NIVEL (escalar, sse2, avx2 ou avx512) pode reduzi-lo.
+
+/// @return Um dos valores SIMD_*.
+
+int simd_nivel(void);
+
+/// @brief Retorna o nome do conjunto de instruções em uso.
+
+const char* simd_nome(void);
+
+/// @brief Define o conjunto de instruções em uso (limitado ao que a CPU suporta).
+
+/// @param nivel Um dos valores SIMD_*.
+/// @return O nível efetivamente adotado.
+
+int simd_define_nivel(int nivel);
+
+/// @brief r = a + b (precisão simples).
+
+void cvet_soma(const float* a, const float* b, float* r, size_t tam);
+
+/// @brief r = a - b (precisão simples).
+
+void cvet_subtracao(const float* a, const float* b, float* r, size_t tam);
+
+/// @brief r = conj(a) (precisão simples).
+
+void cvet_conjugada(const float* a, float* r, size_t tam);
+
+/// @brief acc += soma de a[i] * b[i] (precisão simples; acc aponta para um número complexo).
+
+void cvet_mac(const float* a, const float* b, float* acc, size_t tam);
+
+/// @brief y += alfa * x (precisão simples; alfa aponta para um número complexo).
+
+void cvet_axpy(const float* alfa, const float* x, float* y, size_t tam);
+
+/// @brief Separa um vetor intercalado em partes real e imaginária (precisão simples).
+
+/// @param x Vetor intercalado (real, imag, real, imag, ...).
+/// @param re Vetor de saída com as partes reais.
+/// @param im Vetor de saída com as partes imaginárias.
+/// @param tam Número de complexos.
+
+void cvet_separa(const float* x, float* re, float* im, size_t tam);
+
+/// @brief Junta partes real e imaginária em um vetor intercalado (precisão simples).
+
+/// @param re Partes reais.
+/// @param im Partes imaginárias.
+/// @param x Vetor intercalado de saída.
+/// @param tam Número de complexos.
+
+void cvet_intercala(const float* re, const float* im, float* x, size_t tam);
+
+/// @brief r = conj(a) (precisão dupla).
+
+void zvet_conjugada(const double* a, double* r, size_t tam);
+
+/// @brief acc += soma de a[i] * b[i] (precisão dupla; acc aponta para um número complexo).
+
+void zvet_mac(const double* a, const double* b, double* acc, size_t tam);
+
+/// @brief y += alfa * x (precisão dupla; alfa aponta para um número complexo).
+
+void zvet_axpy(const double* alfa, const double* x, double* y, size_t tam);
+
+#endif // SIMD_COMPLEXO_H
@@ -0,0 +1,574 @@
+/// @file svd_complexa.c
+/// @brief SVD complexa por Jacobi unilateral (Hestenes).
+
+/// Para cada par de colunas (p, q) calcula-se alfa = |a_p|^2, beta = |a_q|^2 e
+/// gama = a_p^H a_q = |gama| e^(i phi). Multiplicar a_q por e^(-i phi) torna gama real,
+/// e uma rotação real de ângulo theta, com cot(2 theta) = (beta - alfa) / (2 |gama|),
+/// torna as duas colunas ortogonais. As varreduras terminam quando nenhum par precisa
+/// de rotação.
+
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "svd_complexa.h"
+#include "simd_complexo.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SVD_X86 1
+#else
+#define SVD_X86 0
+#endif
+
+///Tolerância relativa para considerar duas colunas ortogonais.
+#define SVD_TOLERANCIA (4 * DBL_EPSILON)
+
+///Aplica a rotação às colunas p e q de x (linhas x ld): x_p = cs x_p - sn e x_q, x_q = sn x_p + cs e x_q.
+
+static void rotaciona(double *x, int ld, int linhas, int p, int q, double cs, double sn, double er, double ei) {
+    for (int i = 0; i < linhas; i++) {
+        double *xp = x + 2 * ((long) i * ld + p);
+        double *xq = x + 2 * ((long) i * ld + q);
+        double yr = er * xq[0] - ei * xq[1];
+        double yi = er * xq[1] + ei * xq[0];
+        double pr = xp[0], pi = xp[1];
+
+        xp[0] = cs * pr - sn * yr;
+        xp[1] = cs * pi - sn * yi;
+        xq[0] = sn * pr + cs * yr;
+        xq[1] = sn * pi + cs * yi;
+    }
+}
+
+///Troca as colunas p e q de x.
+
+static void troca_colunas(double *x, int ld, int linhas, int p, int q) {
+    for (int i = 0; i < linhas; i++) {
+        double *xp = x + 2 * ((long) i * ld + p);
+        double *xq = x + 2 * ((long) i * ld + q);
+        double tr = xp[0], ti = xp[1];
+
+        xp[0] = xq[0];
+        xp[1] = xq[1];
+        xq[0] = tr;
+        xq[1] = ti;
+    }
+}
+
+///Decompõe a (l x c, l >= c) no lugar: a recebe U, s os valores singulares e v a matriz V.
+
+/// @param l Número de linhas de a.
+/// @param c Número de colunas de a.
+/// @param a Matriz de entrada; recebe U.
+/// @param lda Dimensão principal de a.
+/// @param s Vetor de saída com os c valores singulares.
+/// @param v Matriz de saída V (c x c).
+/// @param ldv Dimensão principal de v.
+/// @return O número de varreduras feitas, ou -1 se l < c.
+
+int zsvd_jacobi(int l, int c, double *a, int lda, double *s, double *v, int ldv) {
+    int varredura, p, q, i;
+
+    if (l < c) {
+        return -1;
+    }
+    for (p = 0; p < c; p++) {
+        for (q = 0; q < c; q++) {
+            v[2 * ((long) p * ldv + q)] = p == q;
+            v[2 * ((long) p * ldv + q) + 1] = 0;
+        }
+    }
+
+    for (varredura = 0; varredura < SVD_MAX_VARREDURAS; varredura++) {
+        int rotacoes = 0;
+
+        for (p = 0; p < c - 1; p++) {
+            for (q = p + 1; q < c; q++) {
+                double alfa = 0, beta = 0, gr = 0, gi = 0, g, zeta, t, cs, sn;
+
+                for (i = 0; i < l; i++) {
+                    const double *xp = a + 2 * ((long) i * lda + p);
+                    const double *xq = a + 2 * ((long) i * lda + q);
+
+                    alfa += xp[0] * xp[0] + xp[1] * xp[1];
+                    beta += xq[0] * xq[0] + xq[1] * xq[1];
+                    gr += xp[0] * xq[0] + xp[1] * xq[1];
+                    gi += xp[0] * xq[1] - xp[1] * xq[0];
+                }
+                g = hypot(gr, gi);
+                if (g == 0 || g <= SVD_TOLERANCIA * sqrt(alfa * beta)) {
+                    continue;
+                }
+                rotacoes++;
+                zeta = (beta - alfa) / (2 * g);
+                t = (zeta >= 0 ? 1.0 : -1.0) / (fabs(zeta) + hypot(1.0, zeta));
+                cs = 1 / sqrt(1 + t * t);
+                sn = cs * t;
+                rotaciona(a, lda, l, p, q, cs, sn, gr / g, -gi / g);
+                rotaciona(v, ldv, c, p, q, cs, sn, gr / g, -gi / g);
+            }
+        }
+        if (rotacoes == 0) {
+            break;
+        }
+    }
+
+    for (p = 0; p < c; p++) {
+        double norma = 0;
+
+        for (i = 0; i < l; i++) {
+            const double *x = a + 2 * ((long) i * lda + p);
+            norma += x[0] * x[0] + x[1] * x[1];
+        }
+        s[p] = sqrt(norma);
+        if (s[p] > 0) {
+            for (i = 0; i < l; i++) {
+                double *x = a + 2 * ((long) i * lda + p);
+                x[0] /= s[p];
+                x[1] /= s[p];
+            }
+        }
+    }
+
+    for (p = 0; p < c - 1; p++) {
+        int maior = p;
+
+        for (q = p + 1; q < c; q++) {
+            if (s[q] > s[maior]) {
+                maior = q;
+            }
+        }
+        if (maior != p) {
+            double t = s[p];
+            s[p] = s[maior];
+            s[maior] = t;
+            troca_colunas(a, lda, l, p, maior);
+            troca_colunas(v, ldv, c, p, maior);
+        }
+    }
+    return varredura;
+}
+
+// O núcleo 2x2 só usa sqrt de valores não negativos e divisões cujo resultado é
+// descartado quando o divisor é zero; sem armadilhas de ponto flutuante (e sem errno,
+// por isso o makefile compila este arquivo com -fno-math-errno) o laço do lote é
+// vetorizado com seleções no lugar dos desvios.
+#pragma GCC push_options
+#pragma GCC optimize ("tree-vectorize", "no-trapping-math")
+
+///SVD 2x2 em forma fechada: uma única rotação de Jacobi ortogonaliza as duas colunas.
+
+/// Todas as decisões (matriz já diagonal, ordenação, valor singular nulo) são feitas
+/// com seleções, sem desvios dependentes dos dados, para que o laço de
+/// zsvd_2x2_lote possa ser vetorizado. As entradas e saídas são 2x2 intercaladas por
+/// linhas, com o componente k em x[k * p]: k = 0..1 é (0,0), 2..3 é (0,1), 4..5 é
+/// (1,0) e 6..7 é (1,1). Com p = 1 é uma matriz isolada; com p > 1 são lotes
+/// transpostos (uma matriz por posição).
+
+static inline __attribute__((always_inline))
+void svd2_nucleo(const double *a, double *u, double *s, double *v, long p) {
+    double a00r = a[0], a00i = a[p], a01r = a[2 * p], a01i = a[3 * p];
+    double a10r = a[4 * p], a10i = a[5 * p], a11r = a[6 * p], a11i = a[7 * p];
+    double alfa = a00r * a00r + a00i * a00i + a10r * a10r + a10i * a10i;
+    double beta = a01r * a01r + a01i * a01i + a11r * a11r + a11i * a11i;
+    double gr = a00r * a01r + a00i * a01i + a10r * a11r + a10i * a11i;
+    double gi = a00r * a01i - a00i * a01r + a10r * a11i - a10i * a11r;
+    double g = sqrt(gr * gr + gi * gi);
+    int gira = g > 0;
+    double ginv = gira ? 1 / g : 0;
+    double zeta = (beta - alfa) * 0.5 * ginv;
+    double t = gira ? copysign(1.0, zeta) / (fabs(zeta) + sqrt(1 + zeta * zeta)) : 0;
+    double cs = 1 / sqrt(1 + t * t);
+    double sn = cs * t;
+    double er = gira ? gr * ginv : 1;
+    double ei = gira ? -gi * ginv : 0;
+
+    // e * a_1 (segunda coluna com a fase de gama removida)
+    double y0r = er * a01r - ei * a01i, y0i = er * a01i + ei * a01r;
+    double y1r = er * a11r - ei * a11i, y1i = er * a11i + ei * a11r;
+
+    // colunas de a V: b_0 = cs a_0 - sn e a_1, b_1 = sn a_0 + cs e a_1
+    double b00r = cs * a00r - sn * y0r, b00i = cs * a00i - sn * y0i;
+    double b10r = cs * a10r - sn * y1r, b10i = cs * a10i - sn * y1i;
+    double b01r = sn * a00r + cs * y0r, b01i = sn * a00i + cs * y0i;
+    double b11r = sn * a10r + cs * y1r, b11i = sn * a10i + cs * y1i;
+
+    // colunas de V: v_0 = (cs, -sn e), v_1 = (sn, cs e)
+    double v00r = cs, v00i = 0, v10r = -sn * er, v10i = -sn * ei;
+    double v01r = sn, v01i = 0, v11r = cs * er, v11i = cs * ei;
+
+    double n0 = b00r * b00r + b00i * b00i + b10r * b10r + b10i * b10i;
+    double n1 = b01r * b01r + b01i * b01i + b11r * b11r + b11i * b11i;
+    int troca = n1 > n0;
+    double x;
+
+#define SVD2_TROCA(p, q) (x = troca ? (q) : (p), (q) = troca ? (p) : (q), (p) = x)
+    SVD2_TROCA(b00r, b01r); SVD2_TROCA(b00i, b01i); SVD2_TROCA(b10r, b11r); SVD2_TROCA(b10i, b11i);
+    SVD2_TROCA(v00r, v01r); SVD2_TROCA(v00i, v01i); SVD2_TROCA(v10r, v11r); SVD2_TROCA(v10i, v11i);
+    SVD2_TROCA(n0, n1);
+#undef SVD2_TROCA
+
+    double s0 = sqrt(n0), s1 = sqrt(n1);
+    int u0_valido = s0 > 0;
+    int u1_valido = s1 > DBL_EPSILON * s0;
+    double inv0 = u0_valido ? 1 / s0 : 0;
+    double inv1 = u1_valido ? 1 / s1 : 0;
+    double u00r = u0_valido ? b00r * inv0 : 1, u00i = b00i * inv0;
+    double u10r = b10r * inv0, u10i = b10i * inv0;
+
+    // Sem segundo valor singular, u_1 é o complemento ortogonal de u_0.
+    u[0] = u00r;
+    u[p] = u00i;
+    u[4 * p] = u10r;
+    u[5 * p] = u10i;
+    u[2 * p] = u1_valido ? b01r * inv1 : -u10r;
+    u[3 * p] = u1_valido ? b01i * inv1 : u10i;
+    u[6 * p] = u1_valido ? b11r * inv1 : u00r;
+    u[7 * p] = u1_valido ? b11i * inv1 : -u00i;
+    s[0] = s0;
+    s[p] = s1;
+    v[0] = v00r;
+    v[p] = v00i;
+    v[2 * p] = v01r;
+    v[3 * p] = v01i;
+    v[4 * p] = v10r;
+    v[5 * p] = v10i;
+    v[6 * p] = v11r;
+    v[7 * p] = v11i;
+}
+
+///SVD de uma matriz complexa 2x2 em forma fechada.
+
+/// @param a Matriz de entrada.
+/// @param lda Dimensão principal de a.
+/// @param u Matriz de saída U (2 x 2).
+/// @param ldu Dimensão principal de u.
+/// @param s Vetor de saída com os 2 valores singulares.
+/// @param v Matriz de saída V (2 x 2).
+/// @param ldv Dimensão principal de v.
+
+void zsvd_2x2(const double *a, int lda, double *u, int ldu, double *s, double *v, int ldv) {
+    double ac[8], uc[8], vc[8];
+
+    ac[0] = a[0];
+    ac[1] = a[1];
+    ac[2] = a[2];
+    ac[3] = a[3];
+    ac[4] = a[2 * lda];
+    ac[5] = a[2 * lda + 1];
+    ac[6] = a[2 * lda + 2];
+    ac[7] = a[2 * lda + 3];
+    svd2_nucleo(ac, uc, s, vc, 1);
+    memcpy(u, uc, 4 * sizeof(double));
+    memcpy(u + 2 * ldu, uc + 4, 4 * sizeof(double));
+    memcpy(v, vc, 4 * sizeof(double));
+    memcpy(v + 2 * ldv, vc + 4, 4 * sizeof(double));
+}
+
+///SVD de uma matriz real 2x2 em forma fechada.
+
+/// É o mesmo núcleo de zsvd_2x2 com as partes imaginárias nulas; o compilador elimina
+/// as contas com elas.
+
+/// @param a Matriz real de entrada (por linhas).
+/// @param lda Dimensão principal de a.
+/// @param u Matriz real de saída U (2 x 2).
+/// @param ldu Dimensão principal de u.
+/// @param s Vetor de saída com os 2 valores singulares.
+/// @param v Matriz real de saída V (2 x 2).
+/// @param ldv Dimensão principal de v.
+
+void dsvd_2x2(const double *a, int lda, double *u, int ldu, double *s, double *v, int ldv) {
+    double ac[8] = {a[0], 0, a[1], 0, a[lda], 0, a[lda + 1], 0};
+    double uc[8], vc[8];
+
+    svd2_nucleo(ac, uc, s, vc, 1);
+    u[0] = uc[0];
+    u[1] = uc[2];
+    u[ldu] = uc[4];
+    u[ldu + 1] = uc[6];
+    v[0] = vc[0];
+    v[1] = vc[2];
+    v[ldv] = vc[4];
+    v[ldv + 1] = vc[6];
+}
+
+///Matrizes por grupo transposto em zsvd_2x2_lote.
+#define SVD2_GRUPO 16
+
+///Percorre um lote de matrizes 2x2 guardadas uma após a outra.
+
+/// Cada grupo de SVD2_GRUPO matrizes é transposto para que o componente k das matrizes
+/// fique contíguo; o laço sobre as posições do grupo tem então só acessos de passo 1 e
+/// é vetorizado com uma matriz por posição do vetor.
+
+static inline __attribute__((always_inline))
+void svd2_percorre(const double *a, double *u, double *s, double *v, int lote) {
+    double ag[8 * SVD2_GRUPO], ug[8 * SVD2_GRUPO], sg[2 * SVD2_GRUPO], vg[8 * SVD2_GRUPO];
+    int inicio, w, k;
+
+    for (inicio = 0; inicio + SVD2_GRUPO <= lote; inicio += SVD2_GRUPO) {
+        const double *ai = a + 8 * (long) inicio;
+
+        for (w = 0; w < SVD2_GRUPO; w++) {
+            for (k = 0; k < 8; k++) {
+                ag[k * SVD2_GRUPO + w] = ai[8 * w + k];
+            }
+        }
+        for (w = 0; w < SVD2_GRUPO; w++) {
+            svd2_nucleo(ag + w, ug + w, sg + w, vg + w, SVD2_GRUPO);
+        }
+        for (w = 0; w < SVD2_GRUPO; w++) {
+            for (k = 0; k < 8; k++) {
+                u[8 * ((long) inicio + w) + k] = ug[k * SVD2_GRUPO + w];
+                v[8 * ((long) inicio + w) + k] = vg[k * SVD2_GRUPO + w];
+            }
+            s[2 * ((long) inicio + w)] = sg[w];
+            s[2 * ((long) inicio + w) + 1] = sg[SVD2_GRUPO + w];
+        }
+    }
+    for (; inicio < lote; inicio++) {
+        svd2_nucleo(a + 8 * (long) inicio, u + 8 * (long) inicio, s + 2 * (long) inicio, v + 8 * (long) inicio, 1);
+    }
+}
+
+///Lote sem instruções específicas.
+
+static void svd2_lote_generico(const double *a, double *u, double *s, double *v, int lote) {
+    svd2_percorre(a, u, s, v, lote);
+}
+
+#if SVD_X86
+
+///Lote com AVX2 (quatro matrizes por vetor).
+
+__attribute__((target("avx2,fma")))
+static void svd2_lote_avx2(const double *a, double *u, double *s, double *v, int lote) {
+    svd2_percorre(a, u, s, v, lote);
+}
+
+///Lote com AVX-512 (oito matrizes por vetor).
+
+__attribute__((target("avx512f")))
+static void svd2_lote_avx512(const double *a, double *u, double *s, double *v, int lote) {
+    svd2_percorre(a, u, s, v, lote);
+}
+
+#endif // SVD_X86
+
+///SVD em forma fechada de um lote de matrizes complexas 2x2 guardadas uma após a outra.
+
+/// @param a Lote de entrada (8 doubles por matriz).
+/// @param u Lote de saída com as matrizes U (8 doubles por matriz).
+/// @param s Lote de saída com os valores singulares (2 por matriz).
+/// @param v Lote de saída com as matrizes V (8 doubles por matriz).
+/// @param lote Número de matrizes.
+
+void zsvd_2x2_lote(const double *a, double *u, double *s, double *v, int lote) {
+#if SVD_X86
+    switch (simd_nivel()) {
+    case SIMD_AVX512:
+        svd2_lote_avx512(a, u, s, v, lote);
+        return;
+    case SIMD_AVX2:
+        svd2_lote_avx2(a, u, s, v, lote);
+        return;
+    default:
+        break;
+    }
+#endif
+    svd2_lote_generico(a, u, s, v, lote);
+}
+
+#pragma GCC pop_options
+
+///Número de doubles de trabalho exigidos por zsvd para uma matriz l x c.
+
+/// @param l Número de linhas.
+/// @param c Número de colunas.
+/// @return O tamanho do vetor de trabalho, em doubles.
+
+size_t zsvd_trabalho(int l, int c) {
+    return 2 * (size_t) l * c;
+}
+
+///SVD reduzida de uma matriz l x c qualquer, sem alterar a entrada.
+
+/// @param l Número de linhas de a.
+/// @param c Número de colunas de a.
+/// @param a Matriz de entrada.
+/// @param lda Dimensão principal de a.
+/// @param u Matriz de saída U (l x min(l, c)).
+/// @param ldu Dimensão principal de u.
+/// @param s Vetor de saída com os valores singulares.
+/// @param v Matriz de saída V (c x min(l, c)).
+/// @param ldv Dimensão principal de v.
+/// @param trabalho Vetor com zsvd_trabalho(l, c) doubles.
+/// @return O número de varreduras feitas.
+
+int zsvd(int l, int c, const double *a, int lda, double *u, int ldu, double *s, double *v, int ldv, double *trabalho) {
+    int i, j, varreduras;
+
+    if (l == 2 && c == 2) {
+        zsvd_2x2(a, lda, u, ldu, s, v, ldv);
+        return 1;
+    }
+    if (l >= c) {
+        for (i = 0; i < l; i++) {
+            memcpy(trabalho + 2 * (long) i * c, a + 2 * (long) i * lda, 2 * sizeof(double) * c);
+        }
+        varreduras = zsvd_jacobi(l, c, trabalho, c, s, v, ldv);
+        for (i = 0; i < l; i++) {
+            memcpy(u + 2 * (long) i * ldu, trabalho + 2 * (long) i * c, 2 * sizeof(double) * c);
+        }
+        return varreduras;
+    }
+
+    // a^H = U' diag(s) V'^H, logo a = V' diag(s) U'^H.
+    for (i = 0; i < l; i++) {
+        for (j = 0; j < c; j++) {
+            trabalho[2 * ((long) j * l + i)] = a[2 * ((long) i * lda + j)];
+            trabalho[2 * ((long) j * l + i) + 1] = -a[2 * ((long) i * lda + j) + 1];
+        }
+    }
+    varreduras = zsvd_jacobi(c, l, trabalho, l, s, u, ldu);
+    for (j = 0; j < c; j++) {
+        memcpy(v + 2 * (long) j * ldv, trabalho + 2 * (long) j * l, 2 * sizeof(double) * l);
+    }
+    return varreduras;
+}
+
+///Cria o contexto para matrizes linhas x colunas, com todas as áreas em um só bloco.
+
+/// @param linhas Número de linhas das matrizes a decompor.
+/// @param colunas Número de colunas das matrizes a decompor.
+/// @return O contexto (os ponteiros ficam nulos se a alocação falhar).
+
+svd_contexto svd_contexto_aloca(int linhas, int colunas) {
+    svd_contexto ctx;
+    int k = linhas < colunas ? linhas : colunas;
+    size_t tam_entrada = 2 * (size_t) linhas * colunas;
+    size_t tam_u = 2 * (size_t) linhas * k;
+    size_t tam_v = 2 * (size_t) colunas * k;
+    size_t tam_trabalho = zsvd_trabalho(linhas, colunas);
+    double *bloco = (double*) malloc(sizeof(double) * (tam_entrada + tam_u + tam_v + k + tam_trabalho + 4 * (size_t) k * k));
+
+    ctx.linhas = linhas;
+    ctx.colunas = colunas;
+    ctx.k = k;
+    ctx.entrada = bloco;
+    ctx.u = bloco ? bloco + tam_entrada : NULL;
+    ctx.v = bloco ? ctx.u + tam_u : NULL;
+    ctx.s = bloco ? ctx.v + tam_v : NULL;
+    ctx.trabalho = bloco ? ctx.s + k : NULL;
+    ctx.giro = bloco ? ctx.trabalho + tam_trabalho : NULL;
+    ctx.valido = 0;
+    return ctx;
+}
+
+///Libera a memória do contexto.
+
+/// @param ctx O contexto.
+
+void svd_contexto_libera(svd_contexto *ctx) {
+    free(ctx->entrada);
+    ctx->entrada = ctx->u = ctx->v = ctx->s = ctx->trabalho = ctx->giro = NULL;
+    ctx->valido = 0;
+}
+
+///Decompõe a usando as áreas do contexto; não aloca memória.
+
+/// @param ctx O contexto.
+/// @param a Matriz de entrada (pode ser ctx->entrada).
+/// @param lda Dimensão principal de a.
+/// @return O número de varreduras feitas.
+
+int svd_contexto_calcula(svd_contexto *ctx, const double *a, int lda) {
+    ctx->valido = 1;
+    return zsvd(ctx->linhas, ctx->colunas, a, lda, ctx->u, ctx->k, ctx->s, ctx->v, ctx->k, ctx->trabalho);
+}
+
+///Calcula r = x w, com x (linhas x k) e w (k x k), todas com dimensão principal da largura.
+
+static void gira(int linhas, int k, const double *x, int ldx, const double *w, double *r) {
+    for (int i = 0; i < linhas; i++) {
+        for (int j = 0; j < k; j++) {
+            double re = 0, im = 0;
+
+            for (int t = 0; t < k; t++) {
+                const double *xt = x + 2 * ((long) i * ldx + t);
+                const double *wt = w + 2 * ((long) t * k + j);
+
+                re += xt[0] * wt[0] - xt[1] * wt[1];
+                im += xt[0] * wt[1] + xt[1] * wt[0];
+            }
+            r[2 * ((long) i * k + j)] = re;
+            r[2 * ((long) i * k + j) + 1] = im;
+        }
+    }
+}
+
+///Decompõe a partindo de ctx->v (ou de ctx->u, se linhas < colunas); não aloca memória.
+
+/// Com l >= c: b = a V_anterior = U S W^H, logo a = U S (V_anterior W)^H. Com l < c o
+/// mesmo é feito sobre a^H, partindo de U_anterior.
+
+/// @param ctx O contexto.
+/// @param a Matriz de entrada (pode ser ctx->entrada).
+/// @param lda Dimensão principal de a.
+/// @return O número de varreduras feitas.
+
+int svd_contexto_acompanha(svd_contexto *ctx, const double *a, int lda) {
+    int l = ctx->linhas, c = ctx->colunas, k = ctx->k, i, j, t, varreduras;
+    double *w = ctx->giro, *produto = ctx->giro + 2 * (long) k * k;
+
+    if (!ctx->valido || (l == 2 && c == 2)) {
+        return svd_contexto_calcula(ctx, a, lda);
+    }
+
+    if (l >= c) {
+        // b = a V_anterior, no vetor de trabalho.
+        for (i = 0; i < l; i++) {
+            for (j = 0; j < k; j++) {
+                double re = 0, im = 0;
+
+                for (t = 0; t < c; t++) {
+                    const double *at = a + 2 * ((long) i * lda + t);
+                    const double *vt = ctx->v + 2 * ((long) t * k + j);
+
+                    re += at[0] * vt[0] - at[1] * vt[1];
+                    im += at[0] * vt[1] + at[1] * vt[0];
+                }
+                ctx->trabalho[2 * ((long) i * k + j)] = re;
+                ctx->trabalho[2 * ((long) i * k + j) + 1] = im;
+            }
+        }
+        varreduras = zsvd_jacobi(l, k, ctx->trabalho, k, ctx->s, w, k);
+        memcpy(ctx->u, ctx->trabalho, 2 * sizeof(double) * l * k);
+        gira(c, k, ctx->v, k, w, produto);
+        memcpy(ctx->v, produto, 2 * sizeof(double) * c * k);
+        return varreduras;
+    }
+
+    // b = a^H U_anterior, no vetor de trabalho.
+    for (j = 0; j < c; j++) {
+        for (i = 0; i < k; i++) {
+            double re = 0, im = 0;
+
+            for (t = 0; t < l; t++) {
+                const double *at = a + 2 * ((long) t * lda + j);
+                const double *ut = ctx->u + 2 * ((long) t * k + i);
+
+                re += at[0] * ut[0] + at[1] * ut[1];
+                im += at[0] * ut[1] - at[1] * ut[0];
+            }
+            ctx->trabalho[2 * ((long) j * k + i)] = re;
+            ctx->trabalho[2 * ((long) j * k + i) + 1] = im;
+        }
+    }
+    varreduras = zsvd_jacobi(c, k, ctx->trabalho, k, ctx->s, w, k);
+    memcpy(ctx->v, ctx->trabalho, 2 * sizeof(double) * c * k);
+    gira(l, k, ctx->u, k, w, produto);
+    memcpy(ctx->u, produto, 2 * sizeof(double) * l * k);
+    return varreduras;
+}
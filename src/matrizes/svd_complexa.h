@@ -0,0 +1,147 @@
+/// @file svd_complexa.h
+/// @brief Decomposição em valores singulares de matrizes complexas (Jacobi unilateral).
+
+/// As matrizes são guardadas por linhas, em precisão dupla, com parte real e imaginária
+/// intercaladas (o formato de um vetor de double complex). As dimensões principais são
+/// dadas em números complexos. A decomposição opera diretamente sobre os números
+/// complexos, sem montar a matriz real equivalente de dimensão 2l x 2c.
+
+#ifndef SVD_COMPLEXA_H
+#define SVD_COMPLEXA_H
+
+#include <stddef.h>
+
+/// @brief Número máximo de varreduras de Jacobi antes de desistir da convergência.
+
+#define SVD_MAX_VARREDURAS 60
+
+/// @brief Decompõe a (l x c, com l >= c) no lugar: ao final a contém U (l x c).
+
+/// Cada rotação de Jacobi ortogonaliza um par de colunas de a e é acumulada em v. Ao
+/// final as colunas são normalizadas (as normas são os valores singulares) e ordenadas
+/// de forma decrescente, de modo que a = U diag(s) V^H. Não aloca memória.
+
+/// @param l Número de linhas de a.
+/// @param c Número de colunas de a.
+/// @param a Matriz de entrada; recebe U.
+/// @param lda Dimensão principal de a.
+/// @param s Vetor de saída com os c valores singulares.
+/// @param v Matriz de saída V (c x c).
+/// @param ldv Dimensão principal de v.
+/// @return O número de varreduras feitas, ou -1 se l < c.
+
+int zsvd_jacobi(int l, int c, double *a, int lda, double *s, double *v, int ldv);
+
+/// @brief Número de doubles de trabalho exigidos por zsvd para uma matriz l x c.
+
+size_t zsvd_trabalho(int l, int c);
+
+/// @brief SVD reduzida a = U diag(s) V^H de uma matriz l x c qualquer, preservando a.
+
+/// Com k = min(l, c), U é l x k, s tem k posições e V é c x k. Quando l < c a
+/// decomposição é feita sobre a^H e os papéis de U e V são trocados. Matrizes 2x2 vão
+/// para a forma fechada de zsvd_2x2.
+
+/// @param l Número de linhas de a.
+/// @param c Número de colunas de a.
+/// @param a Matriz de entrada.
+/// @param lda Dimensão principal de a.
+/// @param u Matriz de saída U (l x k).
+/// @param ldu Dimensão principal de u.
+/// @param s Vetor de saída com os k valores singulares, em ordem decrescente.
+/// @param v Matriz de saída V (c x k).
+/// @param ldv Dimensão principal de v.
+/// @param trabalho Vetor com zsvd_trabalho(l, c) doubles.
+/// @return O número de varreduras feitas.
+
+int zsvd(int l, int c, const double *a, int lda, double *u, int ldu, double *s, double *v, int ldv, double *trabalho);
+
+/// @brief SVD de uma matriz complexa 2x2 em forma fechada (uma rotação de Jacobi, sem iterações).
+
+/// zsvd usa esta função automaticamente quando l = c = 2.
+
+/// @param a Matriz de entrada.
+/// @param lda Dimensão principal de a.
+/// @param u Matriz de saída U (2 x 2).
+/// @param ldu Dimensão principal de u.
+/// @param s Vetor de saída com os 2 valores singulares, em ordem decrescente.
+/// @param v Matriz de saída V (2 x 2).
+/// @param ldv Dimensão principal de v.
+
+void zsvd_2x2(const double *a, int lda, double *u, int ldu, double *s, double *v, int ldv);
+
+/// @brief SVD de uma matriz real 2x2 em forma fechada.
+
+/// Mesmos parâmetros de zsvd_2x2, mas com matrizes reais (um double por elemento).
+
+void dsvd_2x2(const double *a, int lda, double *u, int ldu, double *s, double *v, int ldv);
+
+/// @brief SVD em forma fechada de um lote de matrizes complexas 2x2 guardadas uma após a outra.
+
+/// Cada matriz ocupa 8 doubles (2 x 2 complexos, por linhas), e cada par de valores
+/// singulares 2 doubles. Os grupos de matrizes são transpostos e processados uma por
+/// posição dos vetores SIMD (AVX2 ou AVX-512, conforme simd_nivel).
+
+/// @param a Lote de entrada.
+/// @param u Lote de saída com as matrizes U.
+/// @param s Lote de saída com os valores singulares.
+/// @param v Lote de saída com as matrizes V.
+/// @param lote Número de matrizes.
+
+void zsvd_2x2_lote(const double *a, double *u, double *s, double *v, int lote);
+
+/// @brief Memória de trabalho de uma SVD de dimensões fixas, reaproveitada entre chamadas.
+
+/// Criado uma vez com svd_contexto_aloca para um par (linhas, colunas), o contexto guarda
+/// a entrada, as saídas e o vetor de trabalho de zsvd em um único bloco; em regime as
+/// decomposições não fazem nenhuma alocação. Deve ser destruído com svd_contexto_libera.
+
+typedef struct {
+    int linhas;       /**< Número de linhas da matriz decomposta. */
+    int colunas;      /**< Número de colunas da matriz decomposta. */
+    int k;            /**< min(linhas, colunas). */
+    double *entrada;  /**< Área para a matriz de entrada (linhas x colunas), que o chamador pode preencher. */
+    double *u;        /**< U (linhas x k, dimensão principal k). */
+    double *v;        /**< V (colunas x k, dimensão principal k). */
+    double *s;        /**< Valores singulares (k posições, em ordem decrescente). */
+    double *trabalho; /**< Vetor de trabalho de zsvd. */
+    double *giro;     /**< Área de svd_contexto_acompanha (2 matrizes k x k). */
+    int valido;       /**< Diferente de zero se u, s e v guardam uma decomposição. */
+} svd_contexto;
+
+/// @brief Cria o contexto para matrizes linhas x colunas.
+
+svd_contexto svd_contexto_aloca(int linhas, int colunas);
+
+/// @brief Libera a memória do contexto.
+
+void svd_contexto_libera(svd_contexto *ctx);
+
+/// @brief Decompõe a (linhas x colunas do contexto), deixando U, S e V em ctx->u, ctx->s e ctx->v.
+
+/// @param ctx O contexto.
+/// @param a Matriz de entrada (pode ser ctx->entrada).
+/// @param lda Dimensão principal de a.
+/// @return O número de varreduras feitas.
+
+int svd_contexto_calcula(svd_contexto *ctx, const double *a, int lda);
+
+/// @brief Decompõe a partindo da decomposição anterior guardada no contexto.
+
+/// Para um canal que varia pouco entre blocos, a V anterior quase diagonaliza a^H a: as
+/// colunas de a V_anterior já são quase ortogonais e Jacobi converge com menos
+/// varreduras (em 8x8 com fd Ts = 0,01, cerca de 4 contra 6 de uma decomposição do zero,
+/// contando a varredura final sem rotações). O critério de parada é
+/// o mesmo de zsvd, então o resultado tem a mesma precisão; como V = V_anterior W, com W
+/// próxima da identidade, os vetores singulares também mudam de forma contínua entre
+/// blocos (sem as trocas arbitrárias de fase de decomposições independentes). Sem
+/// decomposição anterior, ou com matrizes 2x2, equivale a svd_contexto_calcula.
+
+/// @param ctx O contexto.
+/// @param a Matriz de entrada (pode ser ctx->entrada).
+/// @param lda Dimensão principal de a.
+/// @return O número de varreduras feitas.
+
+int svd_contexto_acompanha(svd_contexto *ctx, const double *a, int lda);
+
+#endif // SVD_COMPLEXA_H
@@ -0,0 +1,716 @@
+/// @file testes_nucleos.c
+/// @brief Verificação dos núcleos vetorizados contra implementações ingênuas, em cada nível SIMD.
+
+/// Para cada nível aceito por simd_define_nivel (escalar, SSE2, AVX2 e AVX-512, até o que
+/// a CPU suporta) os núcleos são executados sobre dados pseudoaleatórios e comparados com
+/// laços diretos. O programa termina com código 1 se alguma verificação falhar.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../matrizes/gemm.h"
+#include "../matrizes/simd_complexo.h"
+#include "../matrizes/svd_complexa.h"
+#include "../MIMO/cache_svd.h"
+#include "../MIMO/indices_qam.h"
+#include "../MIMO/modulacao_qam.h"
+
+/// Número de verificações que falharam.
+
+static int falhas = 0;
+
+/// Estado do gerador dos dados de teste (xorshift64*).
+
+static uint64_t estado = 0x2545f4914f6cdd1du;
+
+/// Inteiro pseudoaleatório de 32 bits.
+
+static uint32_t sorteia(void) {
+    estado ^= estado >> 12;
+    estado ^= estado << 25;
+    estado ^= estado >> 27;
+    return (uint32_t) ((estado * 0x2545f4914f6cdd1du) >> 32);
+}
+
+/// Valor pseudoaleatório uniforme em [-1, 1).
+
+static double uniforme(void) {
+    return sorteia() / 2147483648.0 - 1;
+}
+
+/// Registra o resultado de uma verificação.
+
+static void confere(int ok, const char *nome, double erro) {
+    if (!ok) {
+        printf("  FALHOU: %s (erro %.3e)\n", nome, erro);
+        falhas++;
+    }
+}
+
+/* ---------------------------------------------------------------------------------- */
+/* Vetores                                                                             */
+/* ---------------------------------------------------------------------------------- */
+
+/// Maior diferença entre n valores e a referência, relativa a 1 + |referência|.
+
+static double diferenca(const float *xf, const double *xd, const double *ref, long n) {
+    double erro = 0;
+    for (long i = 0; i < n; i++) {
+        double d = fabs((xf != NULL ? xf[i] : xd[i]) - ref[i]) / (1 + fabs(ref[i]));
+        erro = d > erro ? d : erro;
+    }
+    return erro;
+}
+
+/// cvet_ (soma, subtração, conjugado, mac e axpy) e zvet_ (conjugado, mac e axpy) contra laços diretos.
+
+static void testa_vetores(void) {
+    static const int tamanhos[] = { 0, 1, 3, 8, 17, 64, 101 };
+    const double alfa[2] = { 0.75, -1.25 };
+    const float alfa_f[2] = { 0.75f, -1.25f };
+
+    for (unsigned t = 0; t < sizeof(tamanhos) / sizeof(tamanhos[0]); t++) {
+        int n = tamanhos[t];
+        size_t bytes = sizeof(double) * (2 * n + 1);
+        double *a = malloc(bytes), *b = malloc(bytes), *ref = malloc(bytes), *rd = malloc(bytes);
+        float *af = malloc(bytes), *bf = malloc(bytes), *rf = malloc(bytes);
+        double mac[2] = { 0.5, -0.5 }, acc[2];
+        float acc_f[2];
+
+        for (int i = 0; i < 2 * n; i++) {
+            af[i] = (float) (a[i] = uniforme());
+            bf[i] = (float) (b[i] = uniforme());
+        }
+        for (int i = 0; i < n; i++) {
+            mac[0] += a[2 * i] * b[2 * i] - a[2 * i + 1] * b[2 * i + 1];
+            mac[1] += a[2 * i] * b[2 * i + 1] + a[2 * i + 1] * b[2 * i];
+        }
+
+        for (int i = 0; i < 2 * n; i++) ref[i] = a[i] + b[i];
+        cvet_soma(af, bf, rf, n);
+        confere(diferenca(rf, NULL, ref, 2 * n) < 1e-6, "cvet_soma", diferenca(rf, NULL, ref, 2 * n));
+
+        for (int i = 0; i < 2 * n; i++) ref[i] = a[i] - b[i];
+        cvet_subtracao(af, bf, rf, n);
+        confere(diferenca(rf, NULL, ref, 2 * n) < 1e-6, "cvet_subtracao", diferenca(rf, NULL, ref, 2 * n));
+
+        for (int i = 0; i < 2 * n; i++) ref[i] = i % 2 ? -a[i] : a[i];
+        cvet_conjugada(af, rf, n);
+        confere(diferenca(rf, NULL, ref, 2 * n) < 1e-6, "cvet_conjugada", diferenca(rf, NULL, ref, 2 * n));
+        zvet_conjugada(a, rd, n);
+        confere(diferenca(NULL, rd, ref, 2 * n) == 0, "zvet_conjugada", diferenca(NULL, rd, ref, 2 * n));
+
+        acc_f[0] = acc[0] = 0.5;
+        acc_f[1] = acc[1] = -0.5;
+        cvet_mac(af, bf, acc_f, n);
+        confere(diferenca(acc_f, NULL, mac, 2) < 1e-5, "cvet_mac", diferenca(acc_f, NULL, mac, 2));
+        zvet_mac(a, b, acc, n);
+        confere(diferenca(NULL, acc, mac, 2) < 1e-13, "zvet_mac", diferenca(NULL, acc, mac, 2));
+
+        for (int i = 0; i < n; i++) {
+            ref[2 * i] = b[2 * i] + alfa[0] * a[2 * i] - alfa[1] * a[2 * i + 1];
+            ref[2 * i + 1] = b[2 * i + 1] + alfa[0] * a[2 * i + 1] + alfa[1] * a[2 * i];
+        }
+        memcpy(rf, bf, sizeof(float) * 2 * n);
+        cvet_axpy(alfa_f, af, rf, n);
+        confere(diferenca(rf, NULL, ref, 2 * n) < 1e-6, "cvet_axpy", diferenca(rf, NULL, ref, 2 * n));
+        memcpy(rd, b, sizeof(double) * 2 * n);
+        zvet_axpy(alfa, a, rd, n);
+        confere(diferenca(NULL, rd, ref, 2 * n) < 1e-15, "zvet_axpy", diferenca(NULL, rd, ref, 2 * n));
+
+        free(a);
+        free(b);
+        free(ref);
+        free(rd);
+        free(af);
+        free(bf);
+        free(rf);
+    }
+}
+
+/* ---------------------------------------------------------------------------------- */
+/* GEMM                                                                                */
+/* ---------------------------------------------------------------------------------- */
+
+/// r = a b (ou r += a b) em precisão dupla, para matrizes complexas intercaladas.
+
+static void gemm_ingenuo(int l, int c, int m, const float *a, int lda, const float *b, int ldb, double *r, int ldr) {
+    for (int i = 0; i < l; i++) {
+        for (int j = 0; j < m; j++) {
+            double re = r[2 * (i * ldr + j)], im = r[2 * (i * ldr + j) + 1];
+            for (int p = 0; p < c; p++) {
+                double ar = a[2 * (i * lda + p)], ai = a[2 * (i * lda + p) + 1];
+                double br = b[2 * (p * ldb + j)], bi = b[2 * (p * ldb + j) + 1];
+                re += ar * br - ai * bi;
+                im += ar * bi + ai * br;
+            }
+            r[2 * (i * ldr + j)] = re;
+            r[2 * (i * ldr + j) + 1] = im;
+        }
+    }
+}
+
+/// Maior diferença relativa entre um resultado em float e a referência, sobre n complexos.
+
+static double diferenca_float(const float *r, const double *ref, long n, int c) {
+    double erro = 0;
+    for (long i = 0; i < 2 * n; i++) {
+        double d = fabs(r[i] - ref[i]) / (c + fabs(ref[i]));
+        erro = d > erro ? d : erro;
+    }
+    return erro;
+}
+
+/// cgemm e cgemm_planar com dimensões pequenas, ímpares e maiores que os blocos de cache.
+
+static void testa_cgemm(void) {
+    static const int dims[][3] = { { 1, 1, 1 }, { 3, 5, 7 }, { 8, 8, 8 }, { 17, 33, 9 }, { 70, 130, 65 } };
+
+    for (unsigned d = 0; d < sizeof(dims) / sizeof(dims[0]); d++) {
+        int l = dims[d][0], c = dims[d][1], m = dims[d][2];
+        int lda = c + 1, ldb = m + 2, ldr = m + 3;
+        float *a = malloc(sizeof(float) * 2 * l * lda), *b = malloc(sizeof(float) * 2 * c * ldb);
+        float *r = malloc(sizeof(float) * 2 * l * ldr);
+        float *pr[6];
+        double *ref = malloc(sizeof(double) * 2 * l * ldr);
+
+        for (long i = 0; i < 2L * l * lda; i++) a[i] = uniforme();
+        for (long i = 0; i < 2L * c * ldb; i++) b[i] = uniforme();
+        for (long i = 0; i < 2L * l * ldr; i++) ref[i] = r[i] = uniforme();
+
+        for (int acumula = 1; acumula >= 0; acumula--) {
+            if (!acumula) {
+                memset(ref, 0, sizeof(double) * 2 * l * ldr);
+            }
+            gemm_ingenuo(l, c, m, a, lda, b, ldb, ref, ldr);
+            if (!acumula) {
+                // As colunas entre m e ldr não são escritas: a referência guarda o conteúdo anterior.
+                for (int i = 0; i < l; i++) {
+                    for (int j = 2 * m; j < 2 * ldr; j++) ref[2 * i * ldr + j] = r[2 * i * ldr + j];
+                }
+            }
+            cgemm(l, c, m, a, lda, b, ldb, r, ldr, acumula);
+            double erro = diferenca_float(r, ref, (long) l * ldr, c);
+            confere(erro < 1e-5, acumula ? "cgemm (acumula)" : "cgemm", erro);
+        }
+
+        // O mesmo produto no formato planar.
+        pr[0] = malloc(sizeof(float) * l * lda);
+        pr[1] = malloc(sizeof(float) * l * lda);
+        pr[2] = malloc(sizeof(float) * c * ldb);
+        pr[3] = malloc(sizeof(float) * c * ldb);
+        pr[4] = calloc((size_t) l * ldr, sizeof(float));
+        pr[5] = calloc((size_t) l * ldr, sizeof(float));
+        cvet_separa(a, pr[0], pr[1], (size_t) l * lda);
+        cvet_separa(b, pr[2], pr[3], (size_t) c * ldb);
+        cgemm_planar(l, c, m, pr[0], pr[1], lda, pr[2], pr[3], ldb, pr[4], pr[5], ldr, 0);
+        memset(r, 0, sizeof(float) * 2 * l * ldr);
+        cvet_intercala(pr[4], pr[5], r, (size_t) l * ldr);
+        for (int i = 0; i < l; i++) {
+            for (int j = 2 * m; j < 2 * ldr; j++) ref[2 * i * ldr + j] = 0;
+        }
+        double erro = diferenca_float(r, ref, (long) l * ldr, c);
+        confere(erro < 1e-5, "cgemm_planar", erro);
+
+        for (int i = 0; i < 6; i++) free(pr[i]);
+        free(a);
+        free(b);
+        free(r);
+        free(ref);
+    }
+}
+
+/// cgemm_lote nas dimensões transpostas (até 8) e nas que caem em cgemm, com lote ímpar.
+
+static void testa_cgemm_lote(void) {
+    static const int dims[][3] = { { 2, 2, 1 }, { 4, 4, 4 }, { 3, 8, 5 }, { 9, 4, 3 } };
+    const int lote = 37;
+
+    for (unsigned d = 0; d < sizeof(dims) / sizeof(dims[0]); d++) {
+        int l = dims[d][0], c = dims[d][1], m = dims[d][2];
+        long pa = l * c + 1, pb = c * m + 2, prr = l * m + 3;
+        float *a = malloc(sizeof(float) * 2 * pa * lote), *b = malloc(sizeof(float) * 2 * pb * lote);
+        float *r = calloc(2 * prr * lote, sizeof(float));
+        double *ref = calloc(2 * prr * lote, sizeof(double));
+
+        for (long i = 0; i < 2 * pa * lote; i++) a[i] = uniforme();
+        for (long i = 0; i < 2 * pb * lote; i++) b[i] = uniforme();
+        for (int t = 0; t < lote; t++) {
+            gemm_ingenuo(l, c, m, a + 2 * pa * t, c, b + 2 * pb * t, m, ref + 2 * prr * t, m);
+        }
+        cgemm_lote(l, c, m, a, c, pa, b, m, pb, r, m, prr, lote);
+        double erro = diferenca_float(r, ref, prr * lote, c);
+        confere(erro < 1e-5, "cgemm_lote", erro);
+
+        free(a);
+        free(b);
+        free(r);
+        free(ref);
+    }
+}
+
+/// Termo de zgemm_streams_soma usado no teste: uma função fixa da linha e do símbolo.
+
+static void parcela_teste(void *ctx, int linha, long inicio, long n, double *z) {
+    (void) ctx;
+    for (long i = 0; i < n; i++) {
+        z[2 * i] = 0.25 * linha + 1e-3 * (inicio + i);
+        z[2 * i + 1] = -0.5 * linha + 1e-4 * (inicio + i);
+    }
+}
+
+/// zgemm_streams e zgemm_streams_soma, com c = 2, 4 e 8 (faixas com c fixo), outros c e comprimentos que não são múltiplos dos blocos.
+
+static void testa_zgemm_streams(void) {
+    static const int dims[][2] = { { 1, 1 }, { 2, 2 }, { 4, 4 }, { 8, 8 }, { 6, 2 }, { 3, 4 },
+                                   { 4, 3 }, { 5, 8 }, { 16, 16 }, { 7, 20 }, { 21, 17 } };
+    static const long comprimentos[] = { 1, 37, 513 };
+
+    for (unsigned d = 0; d < sizeof(dims) / sizeof(dims[0]); d++) {
+        for (unsigned q = 0; q < sizeof(comprimentos) / sizeof(comprimentos[0]); q++) {
+            int l = dims[d][0], c = dims[d][1], ldw = c + 1;
+            long len = comprimentos[q];
+            double *w = malloc(sizeof(double) * 2 * l * ldw);
+            double **x = malloc(sizeof(double*) * c), **y = malloc(sizeof(double*) * l);
+            double *ref = malloc(sizeof(double) * 2 * len);
+            double erro = 0, erro_soma = 0, erro_acumula = 0;
+
+            for (long i = 0; i < 2L * l * ldw; i++) w[i] = uniforme();
+            for (int j = 0; j < c; j++) {
+                x[j] = malloc(sizeof(double) * 2 * len);
+                for (long i = 0; i < 2 * len; i++) x[j][i] = uniforme();
+            }
+            for (int i = 0; i < l; i++) y[i] = malloc(sizeof(double) * 2 * len);
+
+            zgemm_streams(l, c, w, ldw, (const double* const*) x, y, len, 0);
+            for (int i = 0; i < l; i++) {
+                for (long t = 0; t < len; t++) {
+                    double re = 0, im = 0;
+                    for (int j = 0; j < c; j++) {
+                        double wr = w[2 * (i * ldw + j)], wi = w[2 * (i * ldw + j) + 1];
+                        re += wr * x[j][2 * t] - wi * x[j][2 * t + 1];
+                        im += wr * x[j][2 * t + 1] + wi * x[j][2 * t];
+                    }
+                    ref[2 * t] = re;
+                    ref[2 * t + 1] = im;
+                    erro = fmax(erro, fmax(fabs(y[i][2 * t] - re), fabs(y[i][2 * t + 1] - im)));
+                }
+                // y += w x dobra o resultado.
+                zgemm_streams(l, c, w, ldw, (const double* const*) x, y, len, 1);
+                for (long t = 0; t < 2 * len; t++) {
+                    erro_acumula = fmax(erro_acumula, fabs(y[i][t] - 2 * ref[t]));
+                }
+                zgemm_streams(l, c, w, ldw, (const double* const*) x, y, len, 0);
+            }
+            zgemm_streams_soma(l, c, w, ldw, (const double* const*) x, y, len, parcela_teste, NULL);
+            for (int i = 0; i < l; i++) {
+                double z[2];
+                for (long t = 0; t < len; t++) {
+                    double re = 0, im = 0;
+                    for (int j = 0; j < c; j++) {
+                        double wr = w[2 * (i * ldw + j)], wi = w[2 * (i * ldw + j) + 1];
+                        re += wr * x[j][2 * t] - wi * x[j][2 * t + 1];
+                        im += wr * x[j][2 * t + 1] + wi * x[j][2 * t];
+                    }
+                    parcela_teste(NULL, i, t, 1, z);
+                    erro_soma = fmax(erro_soma, fmax(fabs(y[i][2 * t] - re - z[0]), fabs(y[i][2 * t + 1] - im - z[1])));
+                }
+            }
+            confere(erro < 1e-12 * c, "zgemm_streams", erro);
+            confere(erro_acumula < 1e-12 * c, "zgemm_streams (acumula)", erro_acumula);
+            confere(erro_soma < 1e-12 * c, "zgemm_streams_soma", erro_soma);
+
+            for (int j = 0; j < c; j++) free(x[j]);
+            for (int i = 0; i < l; i++) free(y[i]);
+            free(x);
+            free(y);
+            free(w);
+            free(ref);
+        }
+    }
+}
+
+/* ---------------------------------------------------------------------------------- */
+/* SVD                                                                                 */
+/* ---------------------------------------------------------------------------------- */
+
+/// Maior erro de a - U diag(s) V^H e de U^H U - I, V^H V - I, relativo à maior entrada de a.
+
+static double erro_svd(int l, int c, const double *a, int lda, const double *u, int ldu, const double *s, const double *v, int ldv) {
+    int k = l < c ? l : c;
+    double erro = 0, maximo = 1e-300;
+
+    for (long i = 0; i < 2L * l * lda; i++) maximo = fmax(maximo, fabs(a[i]));
+    for (int i = 0; i < l; i++) {
+        for (int j = 0; j < c; j++) {
+            double re = 0, im = 0;
+            for (int p = 0; p < k; p++) {
+                double ur = u[2 * (i * ldu + p)], ui = u[2 * (i * ldu + p) + 1];
+                double vr = v[2 * (j * ldv + p)], vi = -v[2 * (j * ldv + p) + 1];
+                re += s[p] * (ur * vr - ui * vi);
+                im += s[p] * (ur * vi + ui * vr);
+            }
+            erro = fmax(erro, fmax(fabs(a[2 * (i * lda + j)] - re), fabs(a[2 * (i * lda + j) + 1] - im)) / maximo);
+        }
+    }
+    for (int p = 0; p < k; p++) {
+        if (p > 0 && s[p] > s[p - 1]) {
+            erro = fmax(erro, s[p] - s[p - 1]);
+        }
+        for (int q = 0; q < k; q++) {
+            double gu_r = p == q ? -1 : 0, gu_i = 0, gv_r = p == q ? -1 : 0, gv_i = 0;
+            for (int i = 0; i < l; i++) {
+                gu_r += u[2 * (i * ldu + p)] * u[2 * (i * ldu + q)] + u[2 * (i * ldu + p) + 1] * u[2 * (i * ldu + q) + 1];
+                gu_i += u[2 * (i * ldu + p)] * u[2 * (i * ldu + q) + 1] - u[2 * (i * ldu + p) + 1] * u[2 * (i * ldu + q)];
+            }
+            for (int j = 0; j < c; j++) {
+                gv_r += v[2 * (j * ldv + p)] * v[2 * (j * ldv + q)] + v[2 * (j * ldv + p) + 1] * v[2 * (j * ldv + q) + 1];
+                gv_i += v[2 * (j * ldv + p)] * v[2 * (j * ldv + q) + 1] - v[2 * (j * ldv + p) + 1] * v[2 * (j * ldv + q)];
+            }
+            erro = fmax(erro, fmax(fmax(fabs(gu_r), fabs(gu_i)), fmax(fabs(gv_r), fabs(gv_i))));
+        }
+    }
+    return erro;
+}
+
+/// zsvd e svd_contexto_calcula/acompanha em formatos altos, largos e quadrados.
+
+static void testa_zsvd(void) {
+    static const int dims[][2] = { { 1, 4 }, { 2, 2 }, { 4, 4 }, { 5, 3 }, { 3, 5 }, { 8, 8 }, { 12, 7 } };
+
+    for (unsigned d = 0; d < sizeof(dims) / sizeof(dims[0]); d++) {
+        int l = dims[d][0], c = dims[d][1], k = l < c ? l : c, lda = c + 1;
+        double *a = malloc(sizeof(double) * 2 * l * lda);
+        double *u = malloc(sizeof(double) * 2 * l * k), *v = malloc(sizeof(double) * 2 * c * k), *s = malloc(sizeof(double) * k);
+        double *trabalho = malloc(sizeof(double) * zsvd_trabalho(l, c));
+        svd_contexto ctx = svd_contexto_aloca(l, c);
+
+        for (long i = 0; i < 2L * l * lda; i++) a[i] = uniforme();
+        zsvd(l, c, a, lda, u, k, s, v, k, trabalho);
+        double erro = erro_svd(l, c, a, lda, u, k, s, v, k);
+        confere(erro < 1e-12, "zsvd", erro);
+
+        svd_contexto_calcula(&ctx, a, lda);
+        erro = erro_svd(l, c, a, lda, ctx.u, k, ctx.s, ctx.v, k);
+        confere(erro < 1e-12, "svd_contexto_calcula", erro);
+
+        // Canal que muda pouco: a decomposição acompanhada deve ser tão precisa quanto a direta.
+        for (int passo = 0; passo < 3; passo++) {
+            for (long i = 0; i < 2L * l * lda; i++) a[i] += 0.01 * uniforme();
+            svd_contexto_acompanha(&ctx, a, lda);
+            erro = erro_svd(l, c, a, lda, ctx.u, k, ctx.s, ctx.v, k);
+            confere(erro < 1e-12, "svd_contexto_acompanha", erro);
+        }
+
+        svd_contexto_libera(&ctx);
+        free(a);
+        free(u);
+        free(v);
+        free(s);
+        free(trabalho);
+    }
+}
+
+/// zsvd_2x2_lote com um lote que não é múltiplo da largura dos vetores, incluindo uma matriz singular.
+
+static void testa_zsvd_2x2_lote(void) {
+    const int lote = 13;
+    double a[8 * 13], u[8 * 13], v[8 * 13], s[2 * 13], erro = 0;
+
+    for (int i = 0; i < 8 * lote; i++) a[i] = uniforme();
+    for (int i = 0; i < 4; i++) {
+        // Segunda linha da matriz 5 igual à primeira.
+        a[8 * 5 + 4 + i] = a[8 * 5 + i];
+    }
+    zsvd_2x2_lote(a, u, s, v, lote);
+    for (int t = 0; t < lote; t++) {
+        erro = fmax(erro, erro_svd(2, 2, a + 8 * t, 2, u + 8 * t, 2, s + 2 * t, v + 8 * t, 2));
+    }
+    confere(erro < 1e-12, "zsvd_2x2_lote", erro);
+}
+
+/// Canal 2x2 diagonal diag(d0, d1), cujos valores singulares são |d0| e |d1|.
+
+static void canal_diagonal(double d0, double d1, double *h) {
+    memset(h, 0, sizeof(double) * 8);
+    h[0] = d0;
+    h[6] = d1;
+}
+
+/// Confere se a entrada e guarda a decomposição de diag(d0, d1) (com d0 >= d1 >= 0).
+
+static int entrada_confere(const cache_svd_entrada *e, uint64_t id, double d0, double d1) {
+    return e != NULL && e->id == id && fabs(e->s[0] - d0) < 1e-12 && fabs(e->s[1] - d1) < 1e-12 &&
+           e->inv_s[0] == (d0 > 0 ? 1 / e->s[0] : 0) && e->inv_s[1] == (d1 > 0 ? 1 / e->s[1] : 0);
+}
+
+/// cache_svd com 3 entradas: acertos, faltas, descarte LRU de uma entrada no meio da lista e
+/// da cadeia de um balde, reaproveitamento da área descartada e 1/s nulo para s nulo.
+
+static void testa_cache_svd(void) {
+    // Cada entrada 2x2 com 1 double extra ocupa menos de 256 bytes; 3 cabem em 3 * 256.
+    cache_svd c = cache_svd_cria(2, 2, 1, 3 * 256);
+    uint64_t id[4];
+    cache_svd_entrada *e, *b;
+    double h[8];
+    int n = 0, ok = c.capacidade == 3;
+
+    // Três identificadores no mesmo balde (a cadeia fica id[2] -> id[1] -> id[0]) e um em outro.
+    for (uint64_t x = 1; n < 4; x++) {
+        int balde = (int) ((x * 0x9e3779b97f4a7c15u) >> 32) & c.mascara;
+        int balde0 = n > 0 ? (int) ((id[0] * 0x9e3779b97f4a7c15u) >> 32) & c.mascara : balde;
+        if ((n < 3) == (balde == balde0)) {
+            id[n++] = x;
+        }
+    }
+
+    for (int i = 0; i < 3; i++) {
+        canal_diagonal(3 - i, 1, h);
+        ok &= entrada_confere(cache_svd_calcula(&c, id[i], h, 2), id[i], 3 - i, 1);
+    }
+    ok &= c.faltas == 3 && c.acertos == 0 && c.descartes == 0;
+
+    // Uma consulta de id[0] deixa id[1] como a menos recente: ordem id[0], id[2], id[1].
+    ok &= entrada_confere(cache_svd_procura(&c, id[0]), id[0], 3, 1);
+    ok &= cache_svd_procura(&c, id[3]) == NULL;
+    b = cache_svd_procura(&c, id[1]);
+    ok &= entrada_confere(b, id[1], 2, 1);
+    ok &= entrada_confere(cache_svd_procura(&c, id[0]), id[0], 3, 1);
+    ok &= entrada_confere(cache_svd_procura(&c, id[2]), id[2], 1, 1);
+    ok &= c.acertos == 4;
+
+    // Ordem id[2], id[0], id[1]: id[1] (no meio da cadeia do balde) é descartada e a sua área
+    // guarda id[3], com uma matriz de posto 1 (1/s = 0 para o valor singular nulo).
+    canal_diagonal(0, 5, h);
+    e = cache_svd_calcula(&c, id[3], h, 2);
+    ok &= e == b && entrada_confere(e, id[3], 5, 0) && c.descartes == 1 && c.faltas == 4;
+    ok &= cache_svd_procura(&c, id[1]) == NULL;
+    ok &= entrada_confere(cache_svd_procura(&c, id[0]), id[0], 3, 1);
+    ok &= entrada_confere(cache_svd_procura(&c, id[2]), id[2], 1, 1);
+
+    // Ordem id[2], id[0], id[3]: o próximo descarte é id[3], mesmo em outro balde.
+    canal_diagonal(2, 1, h);
+    ok &= entrada_confere(cache_svd_calcula(&c, id[1], h, 2), id[1], 2, 1);
+    ok &= cache_svd_procura(&c, id[3]) == NULL && c.descartes == 2;
+    ok &= cache_svd_calcula(&c, id[1], h, 2) == cache_svd_procura(&c, id[1]) && c.faltas == 5;
+
+    confere(ok, "cache_svd", 0);
+    cache_svd_libera(&c);
+}
+
+/* ---------------------------------------------------------------------------------- */
+/* Índices e QAM                                                                       */
+/* ---------------------------------------------------------------------------------- */
+
+/// Lê o valor de bits bits a partir do bit p de um vetor empacotado, do mais significativo ao menos.
+
+static int le_bits(const uint8_t *v, long p, int bits) {
+    int r = 0;
+    for (int b = 0; b < bits; b++, p++) {
+        r = (r << 1) | ((v[p >> 3] >> (7 - (p & 7))) & 1);
+    }
+    return r;
+}
+
+/// indices_empacota, indices_desempacota, indices_obtem e indices_diferencas.
+
+static void testa_indices(void) {
+    static const long comprimentos[] = { 1, 3, 31, 64, 1001 };
+
+    for (int bits = 1; bits <= 8; bits++) {
+        for (unsigned q = 0; q < sizeof(comprimentos) / sizeof(comprimentos[0]); q++) {
+            long n = comprimentos[q], bytes = indices_bytes(n, bits);
+            uint8_t *idx = malloc(n), *volta = malloc(n), *emp = malloc(bytes), *outro = malloc(bytes);
+            int ok = bytes == (n * bits + 7) / 8;
+            int64_t diferentes = 0;
+
+            for (long i = 0; i < n; i++) idx[i] = sorteia() & ((1 << bits) - 1);
+            indices_empacota(idx, bits, n, emp);
+            indices_desempacota(emp, bits, n, volta);
+            for (long i = 0; i < n; i++) {
+                ok &= le_bits(emp, i * bits, bits) == idx[i] && volta[i] == idx[i] && indices_obtem(emp, bits, i) == idx[i];
+            }
+            // Os bits que sobram no último byte ficam zerados.
+            ok &= (n * bits) % 8 == 0 || (emp[bytes - 1] & ((1 << (8 - (n * bits) % 8)) - 1)) == 0;
+            confere(ok, "indices_empacota/desempacota", 0);
+
+            for (long i = 0; i < n; i++) {
+                if (sorteia() % 4 == 0) {
+                    volta[i] ^= 1 + sorteia() % ((1 << bits) - 1 > 0 ? (1 << bits) - 1 : 1);
+                    volta[i] &= (1 << bits) - 1;
+                }
+                diferentes += volta[i] != idx[i];
+            }
+            indices_empacota(volta, bits, n, outro);
+            int64_t contados = indices_diferencas(emp, outro, bits, n);
+            confere(contados == diferentes, "indices_diferencas", (double) (contados - diferentes));
+
+            free(idx);
+            free(volta);
+            free(emp);
+            free(outro);
+        }
+    }
+}
+
+/// Ponto da constelação de índice s (eixo real nos bits mais significativos).
+
+static void ponto(const modulacao_qam *mod, int s, double *p) {
+    p[0] = mod->niveis[2 * (s >> mod->bits_eixo)];
+    p[1] = mod->niveis[2 * (s & (mod->lado - 1)) + 1];
+}
+
+/// Índice do ponto da constelação mais próximo de x, por busca exaustiva.
+
+static int mais_proximo(const modulacao_qam *mod, const double *x) {
+    int melhor = 0;
+    double menor = INFINITY, p[2];
+
+    for (int s = 0; s < mod->M; s++) {
+        ponto(mod, s, p);
+        double d = (x[0] - p[0]) * (x[0] - p[0]) + (x[1] - p[1]) * (x[1] - p[1]);
+        if (d < menor) {
+            menor = d;
+            melhor = s;
+        }
+    }
+    return melhor;
+}
+
+/// qam_mapeia e qam_demapeia contra a tabela de níveis e a busca exaustiva.
+
+static void testa_qam(void) {
+    const long n = 1001;
+
+    for (int M = 4; M <= QAM_M_MAX; M *= 4) {
+        const modulacao_qam *mod = modulacao_qam_obtem(M);
+        long bytes = (n * mod->bits + 7) / 8;
+        uint8_t *bits = malloc(bytes), *decididos = malloc(bytes);
+        double *simbolos = malloc(sizeof(double) * 2 * n), p[2], energia = 0;
+        int ok_mapa = 1, ok_decisao = 1;
+
+        for (long i = 0; i < bytes; i++) bits[i] = sorteia();
+        qam_mapeia(mod, bits, n, simbolos);
+        for (long i = 0; i < n; i++) {
+            ponto(mod, le_bits(bits, i * mod->bits, mod->bits), p);
+            ok_mapa &= simbolos[2 * i] == p[0] && simbolos[2 * i + 1] == p[1];
+        }
+        for (int s = 0; s < M; s++) {
+            ponto(mod, s, p);
+            energia += (p[0] * p[0] + p[1] * p[1]) / M;
+        }
+        confere(ok_mapa, "qam_mapeia", 0);
+        confere(fabs(energia - 1) < 1e-12, "energia da constelação", energia - 1);
+
+        // Símbolos espalhados por toda a constelação e um pouco além das bordas.
+        for (long i = 0; i < 2 * n; i++) simbolos[i] = 1.6 * uniforme();
+        qam_demapeia(mod, simbolos, n, decididos);
+        for (long i = 0; i < n; i++) {
+            ok_decisao &= le_bits(decididos, i * mod->bits, mod->bits) == mais_proximo(mod, simbolos + 2 * i);
+        }
+        confere(ok_decisao, "qam_demapeia", 0);
+
+        free(bits);
+        free(decididos);
+        free(simbolos);
+    }
+}
+
+/// LLR max-log do bit b (na ordem empacotada) de x, por busca exaustiva.
+
+static double llr_ingenua(const modulacao_qam *mod, const double *x, int b, double variancia) {
+    double d[2] = { INFINITY, INFINITY }, p[2];
+
+    for (int s = 0; s < mod->M; s++) {
+        int bit = (s >> (mod->bits - 1 - b)) & 1;
+        ponto(mod, s, p);
+        d[bit] = fmin(d[bit], (x[0] - p[0]) * (x[0] - p[0]) + (x[1] - p[1]) * (x[1] - p[1]));
+    }
+    return (d[1] - d[0]) / variancia;
+}
+
+/// qam_llr e qam_llr_int8 contra a busca exaustiva, com passo maior que mod->bits.
+
+static void testa_llr(void) {
+    const long n = 301;
+    const double variancia = 0.1, escala = 4;
+
+    for (int M = 4; M <= QAM_M_MAX; M *= 4) {
+        const modulacao_qam *mod = modulacao_qam_obtem(M);
+        long passo = mod->bits + 3;
+        double *simbolos = malloc(sizeof(double) * 2 * n), erro = 0;
+        float *llr = malloc(sizeof(float) * passo * n);
+        int8_t *quantizadas = malloc(passo * n);
+        int erro_int8 = 0;
+
+        for (long i = 0; i < 2 * n; i++) simbolos[i] = 1.6 * uniforme();
+        qam_llr(mod, simbolos, n, variancia, llr, passo);
+        qam_llr_int8(mod, simbolos, n, variancia, escala, quantizadas, passo);
+        for (long i = 0; i < n; i++) {
+            for (int b = 0; b < mod->bits; b++) {
+                double ref = llr_ingenua(mod, simbolos + 2 * i, b, variancia);
+                double q = fmax(-127, fmin(127, ref * escala));
+                erro = fmax(erro, fabs(llr[i * passo + b] - ref) / (1 + fabs(ref)));
+                // Arredondamentos diferentes na metade podem mudar o valor quantizado em 1.
+                erro_int8 = abs(quantizadas[i * passo + b] - (int) lrint(q)) > erro_int8 ? abs(quantizadas[i * passo + b] - (int) lrint(q)) : erro_int8;
+            }
+        }
+        confere(erro < 1e-5, "qam_llr", erro);
+        confere(erro_int8 <= 1, "qam_llr_int8", erro_int8);
+
+        free(simbolos);
+        free(llr);
+        free(quantizadas);
+    }
+
+    // Regressão: com ruído quase nulo as LLRs passam de 2^31 e devem saturar em ±127 com o sinal certo.
+    const modulacao_qam *mod = modulacao_qam_obtem(16);
+    uint8_t bits[32];
+    double simbolos[2 * 64];
+    int8_t quantizadas[4 * 64];
+    int ok = 1;
+
+    for (int i = 0; i < 32; i++) bits[i] = sorteia();
+    qam_mapeia(mod, bits, 64, simbolos);
+    qam_llr_int8(mod, simbolos, 64, 1e-12, 1, quantizadas, 4);
+    for (int i = 0; i < 64; i++) {
+        for (int b = 0; b < 4; b++) {
+            ok &= quantizadas[4 * i + b] == (le_bits(bits, 4 * i + b, 1) ? -127 : 127);
+        }
+    }
+    confere(ok, "qam_llr_int8 (saturação)", 0);
+}
+
+/// @brief Função principal: executa todas as verificações em cada nível SIMD.
+
+/// @return 0 se todas passarem, 1 caso contrário.
+
+int main(void) {
+    int maximo = simd_nivel();
+
+    for (int nivel = SIMD_ESCALAR; nivel <= SIMD_AVX512; nivel++) {
+        if (simd_define_nivel(nivel) != nivel) {
+            printf("nivel %d: sem suporte na CPU\n", nivel);
+            continue;
+        }
+        int antes = falhas;
+        printf("nivel %s\n", simd_nome());
+        testa_vetores();
+        testa_cgemm();
+        testa_cgemm_lote();
+        testa_zgemm_streams();
+        testa_zsvd();
+        testa_zsvd_2x2_lote();
+        testa_cache_svd();
+        testa_indices();
+        testa_qam();
+        testa_llr();
+        printf("  %s\n", falhas == antes ? "ok" : "com falhas");
+    }
+    simd_define_nivel(maximo);
+
+    printf("%s\n", falhas ? "FALHOU" : "todos os testes passaram");
+    return falhas ? 1 : 0;
+}